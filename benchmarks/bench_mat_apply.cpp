@@ -0,0 +1,135 @@
+/**
+ * Benchmark of pfasst::encap::VectorEncapsulation::mat_apply().
+ *
+ * Compares the cache-blocked kernel against the straight forward triple loop it replaced for the
+ * matrix shapes used by the sweepers and transfer operators:
+ *
+ * - `Q` (\\( M \\times M \\)) and `S` (\\( (M-1) \\times M \\)) for integration,
+ * - `B` (\\( 1 \\times M \\)) for the end value,
+ * - FAS (\\( M \\times 2M \\)) for the computation of the tau correction.
+ *
+ * Usage: `bench_mat_apply [dofs=N] [nodes=M] [repetitions=R]`
+ *
+ * @file benchmarks/bench_mat_apply.cpp
+ * @since v0.6.0
+ */
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include <pfasst.hpp>
+#include <pfasst/config.hpp>
+#include <pfasst/encap/vector.hpp>
+
+
+namespace pfasst
+{
+  namespace benchmarks
+  {
+    template<typename scalar>
+    using VectorT = encap::VectorEncapsulation<scalar, double>;
+
+    template<typename scalar>
+    using VectorList = vector<shared_ptr<VectorT<scalar>>>;
+
+    /**
+     * The previous implementation of VectorEncapsulation::mat_apply().
+     */
+    template<typename scalar>
+    void triple_loop(VectorList<scalar>& dst, double a, const Matrix<double>& mat,
+                     const VectorList<scalar>& src, bool zero)
+    {
+      size_t ndst = dst.size();
+      size_t nsrc = src.size();
+
+      if (zero) { for (auto elem : dst) { elem->zero(); } }
+
+      size_t ndofs = dst[0]->size();
+      for (size_t i = 0; i < ndofs; i++) {
+        for (size_t n = 0; n < ndst; n++) {
+          for (size_t m = 0; m < nsrc; m++) {
+            dst[n]->data()[i] += a * mat(n, m) * src[m]->data()[i];
+          }
+        }
+      }
+    }
+
+    template<typename scalar>
+    VectorList<scalar> make_vectors(size_t num, size_t ndofs)
+    {
+      VectorList<scalar> vectors(num);
+      for (size_t m = 0; m < num; m++) {
+        vectors[m] = make_shared<VectorT<scalar>>(ndofs);
+        for (size_t i = 0; i < ndofs; i++) {
+          vectors[m]->data()[i] = scalar(0.5 + 0.01 * m - 0.001 * (i % 17));
+        }
+      }
+      return vectors;
+    }
+
+    template<typename Func>
+    double time_per_call(Func func, size_t repetitions)
+    {
+      func();  // warm up caches
+      auto start = chrono::steady_clock::now();
+      for (size_t r = 0; r < repetitions; r++) { func(); }
+      auto stop = chrono::steady_clock::now();
+      return chrono::duration<double, micro>(stop - start).count() / repetitions;
+    }
+
+    template<typename scalar>
+    void run_shape(const string& name, const string& type, size_t ndst, size_t nsrc,
+                   size_t ndofs, size_t repetitions)
+    {
+      Matrix<double> mat(ndst, nsrc);
+      for (size_t n = 0; n < ndst; n++) {
+        for (size_t m = 0; m < nsrc; m++) {
+          mat(n, m) = 1.0 / (1.0 + n + m);
+        }
+      }
+      auto src = make_vectors<scalar>(nsrc, ndofs);
+      auto dst = make_vectors<scalar>(ndst, ndofs);
+
+      double t_loop = time_per_call([&]() { triple_loop(dst, 0.1, mat, src, true); }, repetitions);
+      double t_blocked = time_per_call([&]() { dst[0]->mat_apply(dst, 0.1, mat, src, true); },
+                                       repetitions);
+
+      printf("%-4s %-16s %4zu x %-4zu %10zu %14.2f %14.2f %8.2fx\n",
+             name.c_str(), type.c_str(), ndst, nsrc, ndofs, t_loop, t_blocked, t_loop / t_blocked);
+    }
+
+    template<typename scalar>
+    void run_shapes(const string& type, size_t nnodes, size_t ndofs, size_t repetitions)
+    {
+      run_shape<scalar>("Q", type, nnodes, nnodes, ndofs, repetitions);
+      run_shape<scalar>("S", type, nnodes - 1, nnodes, ndofs, repetitions);
+      run_shape<scalar>("B", type, 1, nnodes, ndofs, repetitions);
+      run_shape<scalar>("FAS", type, nnodes, 2 * nnodes, ndofs, repetitions);
+    }
+
+    void run_mat_apply_benchmark(size_t nnodes, size_t ndofs, size_t repetitions)
+    {
+      printf("%-4s %-16s %11s %10s %14s %14s %9s\n",
+             "mat", "scalar", "shape", "dofs", "loop [us]", "blocked [us]", "speedup");
+      run_shapes<double>("double", nnodes, ndofs, repetitions);
+      run_shapes<complex<double>>("complex<double>", nnodes, ndofs, repetitions);
+    }
+  }  // ::pfasst::benchmarks
+}  // ::pfasst
+
+#ifndef PFASST_UNIT_TESTING
+int main(int argc, char** argv)
+{
+  pfasst::init(argc, argv);
+  const size_t ndofs = pfasst::config::get_value<size_t>("dofs", 1 << 16);
+  const size_t nnodes = pfasst::config::get_value<size_t>("nodes", 5);
+  const size_t repetitions = pfasst::config::get_value<size_t>("repetitions", 100);
+
+  pfasst::benchmarks::run_mat_apply_benchmark(nnodes, ndofs, repetitions);
+  return 0;
+}
+#endif
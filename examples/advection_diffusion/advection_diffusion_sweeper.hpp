@@ -20,6 +20,7 @@ using namespace std;
 #include <pfasst/globals.hpp>
 #include <pfasst/logging.hpp>
 #include <pfasst/encap/imex_sweeper.hpp>
+#include <pfasst/encap/solver_cache.hpp>
 
 using pfasst::encap::Encapsulation;
 using pfasst::encap::as_vector;
@@ -76,9 +77,15 @@ namespace pfasst
 
       /**
        * advection-diffusion sweeper with semi-implicit time-integration.
+       *
+       * The FFTs are always computed in double precision; @p scalar only selects the precision the
+       * solution and function values are stored in (e.g. `float` on coarse levels).
+       *
+       * @tparam time   time precision
+       * @tparam scalar precision of the values of the encapsulations
        * @ingroup AdvectionDiffusion
        */
-      template<typename time = pfasst::time_precision>
+      template<typename time = pfasst::time_precision, typename scalar = double>
       class AdvectionDiffusionSweeper
         : public encap::IMEXSweeper<time>
       {
@@ -88,12 +95,15 @@ namespace pfasst
             pfasst::log::add_custom_logger("Advec");
           }
 
-          using data_type = pfasst::encap::VectorEncapsulation<double>;
+          using data_type = pfasst::encap::VectorEncapsulation<scalar, time>;
 
         private:
           //! @{
-          FFTManager<FFTWWorkspaceDFT1D<data_type>> _fft;
+          FFTManager<FFTWWorkspaceDFT1D<pfasst::encap::VectorEncapsulation<double, time>>> _fft;
           vector<complex<double>> ddx, lap;
+
+          //! Normalized inverse symbols of the implicit systems, one per sub-step size.
+          encap::SolverCache<encap::SpectralSymbol<complex<double>>, time> impl_symbols;
           //! @}
 
           //! @{
@@ -119,6 +129,13 @@ namespace pfasst
               this->ddx[i] = complex<double>(0.0, 1.0) * kx;
               this->lap[i] = (kx * kx < 1e-13) ? 0.0 : -kx * kx;
             }
+
+            vector<complex<double>> eigenvalues(nvars);
+            for (size_t i = 0; i < nvars; i++) {
+              eigenvalues[i] = this->nu * this->lap[i];
+            }
+            this->impl_symbols = encap::make_symbol_cache<complex<double>, time>(
+                                   eigenvalues, complex<double>(1.0 / double(nvars)));
           }
 
           AdvectionDiffusionSweeper() = default;
@@ -132,7 +149,7 @@ namespace pfasst
           //! @{
           void exact(shared_ptr<Encapsulation<time>> q, time t)
           {
-            this->exact(as_vector<double, time>(q), t);
+            this->exact(as_vector<scalar, time>(q), t);
           }
 
           void exact(data_type& q, time t)
@@ -154,7 +171,7 @@ namespace pfasst
 
           void echo_error(time t)
           {
-            auto& qend = as_vector<double, time>(this->get_end_state());
+            auto& qend = as_vector<scalar, time>(this->get_end_state());
             data_type qex(qend.size());
 
             this->exact(qex, t);
@@ -175,17 +192,9 @@ namespace pfasst
 
           void echo_residual()
           {
-            vector<shared_ptr<Encapsulation<time>>> residuals;
-
-            for (size_t m = 0; m < this->get_nodes().size(); m++) {
-                residuals.push_back(this->get_factory()->create(pfasst::encap::solution));
-            }
-            this->residual(this->get_controller()->get_step_size(), residuals);
-
-            vector<time> rnorms;
-            for (auto r: residuals) {
-              rnorms.push_back(r->norm0());
-            }
+            auto const& residuals = this->get_current_residuals();
+            auto const type = pfasst::encap::NormType(this->residual_norm_order);
+            vector<time> rnorms = residuals[0]->norms(residuals, type);
             auto rmax = *std::max_element(rnorms.begin(), rnorms.end());
 
             auto n = this->get_controller()->get_step();
@@ -240,8 +249,8 @@ namespace pfasst
                            time t) override
           {
             UNUSED(t);
-            auto& u = as_vector<double, time>(u_encap);
-            auto& f_expl = as_vector<double, time>(f_expl_encap);
+            auto& u = as_vector<scalar, time>(u_encap);
+            auto& f_expl = as_vector<scalar, time>(f_expl_encap);
 
             double c = -v / double(u.size());
 
@@ -262,8 +271,8 @@ namespace pfasst
                            time t) override
           {
             UNUSED(t);
-            auto& u = as_vector<double, time>(u_encap);
-            auto& f_impl = as_vector<double, time>(f_impl_encap);
+            auto& u = as_vector<scalar, time>(u_encap);
+            auto& f_impl = as_vector<scalar, time>(f_impl_encap);
 
             double c = nu / double(u.size());
 
@@ -283,15 +292,16 @@ namespace pfasst
                           shared_ptr<Encapsulation<time>> rhs_encap) override
           {
             UNUSED(t);
-            auto& u = as_vector<double, time>(u_encap);
-            auto& f_impl = as_vector<double, time>(f_impl_encap);
-            auto& rhs = as_vector<double, time>(rhs_encap);
+            auto& u = as_vector<scalar, time>(u_encap);
+            auto& f_impl = as_vector<scalar, time>(f_impl_encap);
+            auto& rhs = as_vector<scalar, time>(rhs_encap);
 
-            double c = nu * double(dt);
+            // the symbols only depend on the sub-step size and are reused in every sweep and step
+            auto symbol = this->impl_symbols.get(this->get_controller()->get_step_size(), dt);
 
             auto* z = this->_fft.get_workspace(rhs.size())->forward(rhs);
             for (size_t i = 0; i < u.size(); i++) {
-              z[i] /= (1.0 - c * this->lap[i]) * double(u.size());
+              z[i] *= (*symbol)[i];
             }
             this->_fft.get_workspace(u.size())->backward(u);
 
@@ -85,18 +85,22 @@ namespace pfasst
           /**
            * Transforms problem data into Fourier space
            *
-           * @param[in] x encapsulation holding data in problem space
+           * @param[in] x encapsulation holding data in problem space; may be of another precision
+           *              than `DataT` (e.g. `VectorEncapsulation<float>` on a coarse level), its
+           *              values are converted while being copied into the workspace
            * @return pointer to values in Fourier space
            */
-          complex<typename DataT::value_type>* forward(const DataT& x);
+          template<class VectorT = DataT>
+          complex<typename DataT::value_type>* forward(const VectorT& x);
 
           /**
            * Back-transforms Fourier space data (z_ptr()) into problem space
            *
            * @param[in,out] x encapsulation to hold back-transformed data; existing data will get
-           *                  overwritten
+           *                  overwritten; may be of another precision than `DataT`
            */
-          void backward(DataT& x);
+          template<class VectorT = DataT>
+          void backward(VectorT& x);
           //! @}
       };
     }  // ::pfasst::examples::advection_diffusion
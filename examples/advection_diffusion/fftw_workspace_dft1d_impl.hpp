@@ -56,7 +56,8 @@ namespace pfasst
       }
 
       template<class DataT>
-      complex<typename DataT::value_type>* FFTWWorkspaceDFT1D<DataT>::forward(const DataT& x)
+      template<class VectorT>
+      complex<typename DataT::value_type>* FFTWWorkspaceDFT1D<DataT>::forward(const VectorT& x)
       {
         assert(this->size() == x.size());
 
@@ -70,14 +71,15 @@ namespace pfasst
       }
 
       template<class DataT>
-      void FFTWWorkspaceDFT1D<DataT>::backward(DataT& x)
+      template<class VectorT>
+      void FFTWWorkspaceDFT1D<DataT>::backward(VectorT& x)
       {
         assert(this->size() == x.size());
 
         fftw_execute_dft(this->_ifft, this->_wk_ptr, this->_wk_ptr);
 
         for (size_t i = 0; i < this->size(); ++i) {
-          x[i] = real(this->_z_ptr[i]);
+          x[i] = typename VectorT::value_type(real(this->_z_ptr[i]));
         }
       }
     }  // ::pfasst::examples::advection_diffusion
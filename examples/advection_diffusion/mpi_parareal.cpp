@@ -0,0 +1,137 @@
+/**
+ * Advection-Diffusion with MPI-enabled Parareal.
+ *
+ * @ingroup AdvectionDiffusionFiles
+ * @file examples/advection_diffusion/mpi_parareal.cpp
+ * @since v0.6.0
+ */
+
+#include <cassert>
+#include <memory>
+#include <vector>
+#include <utility>
+using namespace std;
+
+#include <mpi.h>
+
+#include <pfasst.hpp>
+#include <pfasst/logging.hpp>
+#include <pfasst/controller/parareal.hpp>
+#include <pfasst/mpi_communicator.hpp>
+#include <pfasst/encap/pooled_factory.hpp>
+#include <pfasst/encap/vector.hpp>
+
+#include "advection_diffusion_sweeper.hpp"
+#include "spectral_transfer_1d.hpp"
+
+using namespace pfasst::encap;
+using namespace pfasst::mpi;
+
+namespace pfasst
+{
+  namespace examples
+  {
+    namespace advection_diffusion
+    {
+      /**
+       * Advection/diffusion example using an encapsulated IMEX sweeper.
+       *
+       * This example uses MPI Parareal with the collocation solve on the fine level as the fine
+       * propagator and sweeps on the coarse level as the coarse propagator.
+       *
+       * @param[in] abs_res_tol absolute residual tolerance of the fine collocation solve
+       * @param[in] rel_res_tol relative residual tolerance of the fine collocation solve
+       * @param[in] tol tolerance of the change of the end values (see Parareal::set_tolerance())
+       * @param[in] crse_sweeps number of sweeps of the coarse propagator
+       * @ingroup AdvectionDiffusion
+       */
+      error_map run_mpi_parareal(const double abs_res_tol, const double rel_res_tol,
+                                 const double tol, const size_t niters, const size_t nsteps,
+                                 const double dt, const size_t ndofs_f, const size_t ndofs_c,
+                                 const size_t nnodes_f, const size_t nnodes_c,
+                                 const size_t crse_sweeps = 1, const bool pipelined = false)
+      {
+        ML_CLOG(INFO, "Advec", "abs_res_tol: " << abs_res_tol << ", "
+                               << "rel_res_tol: " << rel_res_tol << ", "
+                               << "tol: " << tol << ", "
+                               << "niter: " << niters << ", "
+                               << "nsteps: " << nsteps << ", "
+                               << "dt: " << dt << ", "
+                               << "ndofs (f-c): " << ndofs_f << "-" << ndofs_c << ", "
+                               << "nnodes (f-c): " << nnodes_f << "-" << nnodes_c << ", "
+                               << "coarse sweeps: " << crse_sweeps << ", "
+                               << "pipelined: " << boolalpha << pipelined);
+
+        MPICommunicator comm(MPI_COMM_WORLD);
+        Parareal<> pr;
+
+        auto quad_c     = quadrature::quadrature_factory(nnodes_c, quadrature::QuadratureType::GaussLobatto);
+        auto factory_c  = make_shared<PooledEncapFactory<>>(make_shared<VectorFactory<double>>(ndofs_c));
+        auto sweeper_c  = make_shared<AdvectionDiffusionSweeper<>>(ndofs_c);
+        auto transfer_c = make_shared<SpectralTransfer1D<>>();
+
+        sweeper_c->set_quadrature(quad_c);
+        sweeper_c->set_factory(factory_c);
+
+        auto quad_f     = quadrature::quadrature_factory(nnodes_f, quadrature::QuadratureType::GaussLobatto);
+        auto factory_f  = make_shared<PooledEncapFactory<>>(make_shared<VectorFactory<double>>(ndofs_f));
+        auto sweeper_f  = make_shared<AdvectionDiffusionSweeper<>>(ndofs_f);
+        auto transfer_f = make_shared<SpectralTransfer1D<>>();
+
+        sweeper_f->set_quadrature(quad_f);
+        sweeper_f->set_factory(factory_f);
+        sweeper_f->set_residual_tolerances(abs_res_tol, rel_res_tol);
+
+        pr.add_level(sweeper_f, transfer_f);
+        pr.add_level(sweeper_c, transfer_c);
+        pr.setup();
+
+        auto q0 = sweeper_f->get_start_state();
+        sweeper_f->exact(q0, 0.0);
+
+        pr.set_comm(&comm);
+        pr.set_pipelined(pipelined);
+        pr.set_duration(0.0, nsteps * dt, dt, niters);
+        pr.set_fine_propagator(PropagatorType::Collocation, 20);
+        pr.set_coarse_propagator(PropagatorType::Sweeps, crse_sweeps);
+        pr.set_tolerance(tol);
+        pr.run();
+
+        auto fine = pr.get_finest<AdvectionDiffusionSweeper<>>();
+        return fine->get_errors();
+      }
+    }  // ::pfasst::examples::advection_diffusion
+  }  // ::pfasst::examples
+}  // ::pfasst
+
+
+
+#ifndef PFASST_UNIT_TESTING
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  pfasst::init(argc, argv,
+               pfasst::examples::advection_diffusion::AdvectionDiffusionSweeper<>::init_logs);
+
+  const double tend        = pfasst::config::get_value<double>("tend", 0.04);
+  const double dt          = pfasst::config::get_value<double>("dt", 0.01);
+  const size_t nnodes_f    = pfasst::config::get_value<size_t>("num_nodes", 5);
+  const size_t ndofs_f     = pfasst::config::get_value<size_t>("spatial_dofs", 128);
+  const size_t niters      = pfasst::config::get_value<size_t>("num_iter", 4);
+  const double abs_res_tol = pfasst::config::get_value<double>("abs_res_tol", 1e-12);
+  const double rel_res_tol = pfasst::config::get_value<double>("rel_res_tol", 0.0);
+  const double tol         = pfasst::config::get_value<double>("tol", 0.0);
+  const size_t crse_sweeps = pfasst::config::get_value<size_t>("coarse_sweeps", 1);
+  const bool   pipelined   = pfasst::config::get_value<bool>("pipelined", false);
+
+  const size_t nsteps = tend / dt;
+  const size_t nnodes_c = (nnodes_f + 1) / 2;
+  const size_t ndofs_c = ndofs_f / 2;
+
+  pfasst::examples::advection_diffusion::run_mpi_parareal(abs_res_tol, rel_res_tol, tol,
+                                                          niters, nsteps, dt,
+                                                          ndofs_f, ndofs_c, nnodes_f, nnodes_c,
+                                                          crse_sweeps, pipelined);
+  MPI_Finalize();
+}
+#endif
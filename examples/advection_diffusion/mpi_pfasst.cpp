@@ -18,6 +18,7 @@ using namespace std;
 #include <pfasst/logging.hpp>
 #include <pfasst/controller/pfasst.hpp>
 #include <pfasst/mpi_communicator.hpp>
+#include <pfasst/encap/pooled_factory.hpp>
 #include <pfasst/encap/vector.hpp>
 
 #include "advection_diffusion_sweeper.hpp"
@@ -37,12 +38,18 @@ namespace pfasst
        *
        * This example uses MPI PFASST.
        *
+       * @tparam crse_scalar precision of the values on the coarse level; the fine level always uses
+       *   `double`
        * @ingroup AdvectionDiffusion
        */
+      template<typename crse_scalar = double>
       error_map run_mpi_pfasst(const double abs_res_tol, const double rel_res_tol,
                                const size_t niters, const size_t nsteps, const double dt,
                                const size_t ndofs_f, const size_t ndofs_c,
-                               const size_t nnodes_f, const size_t nnodes_c)
+                               const size_t nnodes_f, const size_t nnodes_c,
+                               const bool sliding = false,
+                               shared_ptr<CycleSchedule> schedule = nullptr,
+                               const size_t block_length = 0)
       {
         ML_CLOG(INFO, "Advec", "abs_res_tol: " << abs_res_tol << ", "
                                << "rel_res_tol: " << rel_res_tol << ", "
@@ -50,24 +57,26 @@ namespace pfasst
                                << "nsteps: " << nsteps << ", "
                                << "dt: " << dt << ", "
                                << "ndofs (f-c): " << ndofs_f << "-" << ndofs_c << ", "
-                               << "nnodes (f-c): " << nnodes_f << "-" << nnodes_c);
+                               << "nnodes (f-c): " << nnodes_f << "-" << nnodes_c << ", "
+                               << "coarse precision: " << sizeof(crse_scalar) * 8 << " bits, "
+                               << "sliding window: " << boolalpha << sliding);
 
         MPICommunicator comm(MPI_COMM_WORLD);
         PFASST<> pf;
 
         auto quad_c     = quadrature::quadrature_factory(nnodes_c, quadrature::QuadratureType::GaussLobatto);
-        auto factory_c  = make_shared<VectorFactory<double>>(ndofs_c);
-        auto sweeper_c  = make_shared<AdvectionDiffusionSweeper<>>(ndofs_c);
-        auto transfer_c = make_shared<SpectralTransfer1D<>>();
+        auto factory_c  = make_shared<PooledEncapFactory<>>(make_shared<VectorFactory<crse_scalar>>(ndofs_c));
+        auto sweeper_c  = make_shared<AdvectionDiffusionSweeper<double, crse_scalar>>(ndofs_c);
+        auto transfer_c = make_shared<SpectralTransfer1D<double, crse_scalar>>();
 
         sweeper_c->set_quadrature(quad_c);
         sweeper_c->set_factory(factory_c);
         sweeper_c->set_residual_tolerances(abs_res_tol, rel_res_tol);
 
         auto quad_f     = quadrature::quadrature_factory(nnodes_f, quadrature::QuadratureType::GaussLobatto);
-        auto factory_f  = make_shared<VectorFactory<double>>(ndofs_f);
+        auto factory_f  = make_shared<PooledEncapFactory<>>(make_shared<VectorFactory<double>>(ndofs_f));
         auto sweeper_f  = make_shared<AdvectionDiffusionSweeper<>>(ndofs_f);
-        auto transfer_f = make_shared<SpectralTransfer1D<>>();
+        auto transfer_f = make_shared<SpectralTransfer1D<double, double, crse_scalar>>();
 
         sweeper_f->set_quadrature(quad_f);
         sweeper_f->set_factory(factory_f);
@@ -84,6 +93,9 @@ namespace pfasst
         sweeper_f->exact(q0, 0.0);
 
         pf.set_comm(&comm);
+        pf.set_sliding_window(sliding);
+        pf.set_block_length(block_length);
+        pf.set_cycle_schedule(schedule);
         pf.set_duration(0.0, nsteps * dt, dt, niters);
         pf.set_nsweeps({2, 1});
         pf.get_finest<AdvectionDiffusionSweeper<>>()->set_residual_tolerances(abs_res_tol, rel_res_tol);
@@ -112,14 +124,25 @@ int main(int argc, char** argv)
   const size_t niters      = pfasst::config::get_value<size_t>("num_iter", 4);
   const double abs_res_tol = pfasst::config::get_value<double>("abs_res_tol", 0.0);
   const double rel_res_tol = pfasst::config::get_value<double>("rel_res_tol", 0.0);
+  const bool   crse_float  = pfasst::config::get_value<bool>("coarse_float", false);
+  const bool   sliding     = pfasst::config::get_value<bool>("sliding_window", false);
+  const size_t block_len   = pfasst::config::get_value<size_t>("block_length", 0);
 
   const size_t nsteps = tend / dt;
   const size_t nnodes_c = (nnodes_f + 1) / 2;
   const size_t ndofs_c = ndofs_f / 2;
 
-  pfasst::examples::advection_diffusion::run_mpi_pfasst(abs_res_tol, rel_res_tol,
-                                                        niters, nsteps, dt,
-                                                        ndofs_f, ndofs_c, nnodes_f, nnodes_c);
+  if (crse_float) {
+    pfasst::examples::advection_diffusion::run_mpi_pfasst<float>(abs_res_tol, rel_res_tol,
+                                                                 niters, nsteps, dt,
+                                                                 ndofs_f, ndofs_c, nnodes_f, nnodes_c,
+                                                                 sliding, nullptr, block_len);
+  } else {
+    pfasst::examples::advection_diffusion::run_mpi_pfasst(abs_res_tol, rel_res_tol,
+                                                          niters, nsteps, dt,
+                                                          ndofs_f, ndofs_c, nnodes_f, nnodes_c,
+                                                          sliding, nullptr, block_len);
+  }
   MPI_Finalize();
 }
 #endif
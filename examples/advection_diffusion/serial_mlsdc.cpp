@@ -10,6 +10,7 @@ using namespace std;
 
 #include <pfasst.hpp>
 #include <pfasst/controller/mlsdc.hpp>
+#include <pfasst/encap/pooled_factory.hpp>
 #include <pfasst/encap/vector.hpp>
 using namespace pfasst::encap;
 
@@ -28,6 +29,9 @@ namespace pfasst
        *
        * This example uses a (serial) multi-level SDC sweeper.
        *
+       * With a step size @p control, the step size is the initial one and the final time stays
+       * `nsteps*dt`.
+       *
        * @ingroup AdvectionDiffusion
        */
       tuple<error_map, residual_map> run_serial_mlsdc(size_t nlevs,
@@ -35,7 +39,10 @@ namespace pfasst
                                                       double step_size_in=0.01,
                                                       size_t num_iter_in=8,
                                                       size_t nnodes_in=5,
-                                                      size_t ndofs_in=128)
+                                                      size_t ndofs_in=128,
+                                                      bool interp_f_in=false,
+                                                      shared_ptr<CycleSchedule> schedule=nullptr,
+                                                      shared_ptr<StepSizeControl<>> control=nullptr)
       {
         MLSDC<> mlsdc;
 
@@ -47,6 +54,7 @@ namespace pfasst
 
         size_t nnodes = config::get_value<size_t>("num_nodes", nnodes_in);
         size_t ndofs  = config::get_value<size_t>("spatial_dofs", ndofs_in);
+        const bool interp_f = config::get_value<bool>("interp_function_values", interp_f_in);
 
         const double abs_res_tol = pfasst::config::get_value<double>("abs_res_tol", 0.0);
         const double rel_res_tol = pfasst::config::get_value<double>("rel_res_tol", 0.0);
@@ -59,7 +67,7 @@ namespace pfasst
          */
         for (size_t l = 0; l < nlevs; l++) {
           auto quad     = quadrature::quadrature_factory(nnodes, quadrature::QuadratureType::GaussLobatto);
-          auto factory  = make_shared<VectorFactory<double>>(ndofs);
+          auto factory  = make_shared<PooledEncapFactory<>>(make_shared<VectorFactory<double>>(ndofs));
           auto sweeper  = make_shared<AdvectionDiffusionSweeper<>>(ndofs);
           auto transfer = make_shared<SpectralTransfer1D<>>();
 
@@ -68,6 +76,7 @@ namespace pfasst
           sweeper->set_quadrature(quad);
           sweeper->set_factory(factory);
           sweeper->set_residual_tolerances(abs_res_tol, rel_res_tol);
+          transfer->set_interpolate_function_values(interp_f);
 
           mlsdc.add_level(sweeper, transfer);
 
@@ -94,6 +103,8 @@ namespace pfasst
          * run mlsdc!
          */
         mlsdc.set_duration(0.0, nsteps*dt, dt, niters);
+        mlsdc.set_cycle_schedule(schedule);
+        mlsdc.set_step_size_control(control);
         mlsdc.run();
 
         tuple<error_map, residual_map> rinfo;
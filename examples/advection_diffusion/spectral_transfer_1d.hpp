@@ -27,22 +27,29 @@ namespace pfasst
       /**
        * Spectral (FFT) transfer routines.
        *
+       * The fine and the coarse level may store their values in different precisions, e.g. with
+       * `float` on the coarse level; values are converted while being transferred.
+       *
+       * @tparam time        time precision
+       * @tparam fine_scalar precision of the values on the fine level
+       * @tparam crse_scalar precision of the values on the coarse level
        * @ingroup AdvectionDiffusion
        */
-      template<typename time = pfasst::time_precision>
+      template<typename time = pfasst::time_precision,
+               typename fine_scalar = double, typename crse_scalar = fine_scalar>
       class SpectralTransfer1D
         : public encap::PolyInterpMixin<time>
       {
-          using Encapsulation = encap::Encapsulation<double>;
+          using Encapsulation = encap::Encapsulation<time>;
 
-          FFTManager<FFTWWorkspaceDFT1D<encap::VectorEncapsulation<double>>> _fft;
+          FFTManager<FFTWWorkspaceDFT1D<encap::VectorEncapsulation<double, time>>> _fft;
 
         public:
           void interpolate(shared_ptr<Encapsulation> dst,
                            shared_ptr<const Encapsulation> src) override
           {
-            auto& fine = encap::as_vector<double, time>(dst);
-            auto& crse = encap::as_vector<double, time>(src);
+            auto& fine = encap::as_vector<fine_scalar, time>(dst);
+            auto& crse = encap::as_vector<crse_scalar, time>(src);
 
             auto* crse_z = this->_fft.get_workspace(crse.size())->forward(crse);
             auto* fine_z = this->_fft.get_workspace(fine.size())->z_ptr();
@@ -67,13 +74,13 @@ namespace pfasst
           void restrict(shared_ptr<Encapsulation> dst,
                         shared_ptr<const Encapsulation> src) override
           {
-            auto& fine = encap::as_vector<double, time>(src);
-            auto& crse = encap::as_vector<double, time>(dst);
+            auto& fine = encap::as_vector<fine_scalar, time>(src);
+            auto& crse = encap::as_vector<crse_scalar, time>(dst);
 
             size_t xrat = fine.size() / crse.size();
 
             for (size_t i = 0; i < crse.size(); i++) {
-              crse[i] = fine[xrat*i];
+              crse[i] = crse_scalar(fine[xrat*i]);
             }
           }
       };
@@ -10,6 +10,7 @@
 
 #include <pfasst.hpp>
 #include <pfasst/controller/sdc.hpp>
+#include <pfasst/encap/pooled_factory.hpp>
 #include <pfasst/encap/vector.hpp>
 
 #include "advection_diffusion_sweeper.hpp"
@@ -36,7 +37,8 @@ namespace pfasst
         auto const quad_type = quadrature::QuadratureType::GaussLegendre;
 
         auto quad    = quadrature::quadrature_factory(nnodes, quad_type);
-        auto factory = make_shared<encap::VectorFactory<double>>(ndofs);
+        auto factory = make_shared<encap::PooledEncapFactory<>>(
+                         make_shared<encap::VectorFactory<double>>(ndofs));
         auto sweeper = make_shared<AdvectionDiffusionSweeper<>>(ndofs);
 
         sweeper->set_quadrature(quad);
@@ -33,11 +33,15 @@ namespace pfasst
        * with complex lambda, treating the real part implicitly and the imaginary part
        * explicitly.
        *
+       * With a step size @p control, @p dt is the initial step size and the final time stays
+       * `dt*nsteps`.
+       *
        * @ingroup Scalar
        */
       double run_scalar_sdc(const size_t nsteps, const double dt, const size_t nnodes,
                             const size_t niters, const complex<double> lambda,
-                            const quadrature::QuadratureType nodetype)
+                            const quadrature::QuadratureType nodetype,
+                            shared_ptr<StepSizeControl<>> control = nullptr)
       {
         SDC<> sdc;
 
@@ -58,6 +62,7 @@ namespace pfasst
 
         // Final time Tend = dt*nsteps
         sdc.set_duration(0.0, dt*nsteps, dt, niters);
+        sdc.set_step_size_control(control);
         sdc.setup();
 
         auto q0 = sweeper->get_start_state();
@@ -189,6 +189,42 @@ namespace pfasst
             this->n_f_impl_eval++;
           }
 
+          /**
+           * evaluate the explicit part of the right hand side at several nodes in a single loop
+           */
+          void f_expl_eval_all(const vector<shared_ptr<encap_type>>& f_encaps,
+                               const vector<shared_ptr<encap_type>>& q_encaps,
+                               const vector<time>& ts) override
+          {
+            UNUSED(ts);
+            const complex<double> c = this->i_complex * imag(this->lambda);
+            for (size_t m = 0; m < q_encaps.size(); m++) {
+              auto& f = encap::as_vector<complex<double>, time>(f_encaps[m]);
+              auto& q = encap::as_vector<complex<double>, time>(q_encaps[m]);
+              f[0] = c * q[0];
+            }
+
+            this->n_f_expl_eval += q_encaps.size();
+          }
+
+          /**
+           * evaluate the implicit part of the right hand side at several nodes in a single loop
+           */
+          void f_impl_eval_all(const vector<shared_ptr<encap_type>>& f_encaps,
+                               const vector<shared_ptr<encap_type>>& q_encaps,
+                               const vector<time>& ts) override
+          {
+            UNUSED(ts);
+            const double c = real(this->lambda);
+            for (size_t m = 0; m < q_encaps.size(); m++) {
+              auto& f = encap::as_vector<complex<double>, time>(f_encaps[m]);
+              auto& q = encap::as_vector<complex<double>, time>(q_encaps[m]);
+              f[0] = c * q[0];
+            }
+
+            this->n_f_impl_eval += q_encaps.size();
+          }
+
           /**
            * for given \\( b \\), solve
            * \\( \\left( \\mathbb{I}_d - \\Delta t \\text{real}(\\lambda) \\right) u = b \\)
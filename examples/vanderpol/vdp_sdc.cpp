@@ -19,10 +19,18 @@ namespace pfasst
     {
       /**
        * @ingroup VanDerPol
+       * @tparam sweeper_type sweeper to solve with
+       * @param[in] policy optional policy for the tolerances of the Newton solves
+       * @param[out] stats optional place for the statistics of the Newton solves
+       * @param[in] guess initial guess of the Newton solves
        */
+      template<typename sweeper_type = VdpSweeper<>>
       double run_vdp_sdc(const size_t nsteps, const double dt, const size_t nnodes,
                          const size_t niters, const double nu, const double x0,
-                         const double y0, const quadrature::QuadratureType nodetype)
+                         const double y0, const quadrature::QuadratureType nodetype,
+                         shared_ptr<encap::InexactSolvePolicy<>> policy = nullptr,
+                         encap::SolverStatistics<>* stats = nullptr,
+                         const encap::InitialGuess guess = encap::InitialGuess::PreviousIterate)
       {
         SDC<> sdc;
 
@@ -31,10 +39,12 @@ namespace pfasst
         // van der Pol oscillator (as first order system) has two components
         auto factory = make_shared<encap::VectorFactory<double>>(2);
         // input is parameter nu and initial values for position and velocity
-        auto sweeper = make_shared<VdpSweeper<>>(nu, x0, y0);
+        auto sweeper = make_shared<sweeper_type>(nu, x0, y0);
 
         sweeper->set_quadrature(quad);
         sweeper->set_factory(factory);
+        sweeper->set_inexact_solve_policy(policy);
+        sweeper->set_initial_guess(guess);
 
         sdc.add_level(sweeper);
 
@@ -47,6 +57,9 @@ namespace pfasst
 
         sdc.run();
 
+        if (stats) {
+          *stats = sweeper->get_solver_statistics();
+        }
         return sweeper->get_errors();
       }
     }  // ::pfasst::examples::vdp
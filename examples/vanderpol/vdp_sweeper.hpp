@@ -8,6 +8,7 @@
 #ifndef _EXAMPLES__VANDERPOL__VDP_SWEEPER_HPP_
 #define _EXAMPLES__VANDERPOL__VDP_SWEEPER_HPP_
 
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -47,11 +48,15 @@ namespace pfasst
        * Note that an analytical solution is available only for \\( \\nu=0 \\), where the vdP simplifies
        * to the standard linear oscillator. Hence, actual errors are computed only for \\( \\nu=0 \\).
        *
+       * The problem may be solved with any fully implicit sweeper providing `f_impl_eval()` and
+       * `impl_solve()`, e.g. pfasst::encap::ParallelNodesSweeper, selected by @p base_sweeper.
+       *
        * @ingroup VanDerPol
        */
-      template<typename time = pfasst::time_precision>
+      template<typename time = pfasst::time_precision,
+               typename base_sweeper = encap::ImplicitSweeper<time>>
       class VdpSweeper
-        : public encap::ImplicitSweeper<time>
+        : public base_sweeper
       {
         private:
           typedef encap::Encapsulation<time> encap_type;
@@ -71,8 +76,13 @@ namespace pfasst
           //! Tolerance for the nonlinear Newton iteration
           double newton_tol;
 
-          //! Counters for how often `f_impl_eval` and `impl_solve` are called.
-          size_t n_f_impl_eval, n_impl_solve, n_newton_iter;
+          /**
+           * Counters for how often `f_impl_eval` and `impl_solve` are called.
+           *
+           * Atomic, as the nodes may be solved concurrently (see
+           * pfasst::encap::ParallelNodesSweeper).
+           */
+          atomic<size_t> n_f_impl_eval, n_impl_solve, n_newton_iter;
 
           //! Output file
           fstream output_file;
@@ -109,8 +119,9 @@ namespace pfasst
            */
           virtual ~VdpSweeper()
           {
-            ML_LOG(INFO, "Number of implicit evaluations:" << this->n_f_impl_eval);
-            ML_LOG(INFO, "Number of implicit solves:     " << this->n_impl_solve);
+            ML_LOG(INFO, "Number of implicit evaluations:" << this->n_f_impl_eval.load());
+            ML_LOG(INFO, "Number of implicit solves:     " << this->n_impl_solve.load());
+            ML_LOG(INFO, "Number of Newton iterations:   " << this->n_newton_iter.load());
             this->output_file.close();
           }
 
@@ -146,6 +157,19 @@ namespace pfasst
             return this->error;
           }
 
+          /**
+           * returns the number of implicit solves and of Newton iterations of this process so far.
+           */
+          size_t get_num_impl_solves() const
+          {
+            return this->n_impl_solve;
+          }
+
+          size_t get_num_newton_iterations() const
+          {
+            return this->n_newton_iter;
+          }
+
           /**
            * post prediction step, update error.
            */
@@ -230,6 +254,10 @@ namespace pfasst
           /**
            * for given \\\\( b \\\\), solve \\\\( \\left( u - \\Delta t f(u) \\right) u = b \\\\) for
            * \\\\( u \\\\) and set @p f_encap to \\\\( f(u) \\\\).
+           *
+           * The Newton iteration starts from the initial guess in @p q_encap and stops at the
+           * tolerance requested by the sweeper's pfasst::encap::InexactSolvePolicy, if any, and at
+           * `newton_tol` otherwise.
            */
           void impl_solve(shared_ptr<encap_type> f_encap,
                           shared_ptr<encap_type> q_encap, time t, time dt,
@@ -267,13 +295,16 @@ namespace pfasst
              * can be evaluated directly.
              */
 
+            // tolerance coupled to the SDC iteration, if requested
+            auto const& context = this->get_solver_context();
+            const double tol = (context.tolerance > 0.0) ? double(context.tolerance) : this->newton_tol;
+
             // initialize residual
-            double residual = this->newton_tol + 1.0;
+            double residual = tol + 1.0;
             size_t iter     = 0.0;
 
-            // Initial value for q is just rhs: For small dt, P is approximately the identity
-            q[0] = rhs[0];
-            q[1] = rhs[1];
+            // Newton starts from the initial guess provided by the sweeper in q (e.g. the value of
+            // the previous iteration)
 
             // NEWTON ITERATION: q_new = q + inv(J(q))*(-f(q))
             do {
@@ -322,11 +353,13 @@ namespace pfasst
               iter++;
               this->n_newton_iter++;
 
-            } while ( (iter<this->newton_maxit) && (residual>this->newton_tol) );
+            } while ( (iter<this->newton_maxit) && (residual>tol) );
+
+            this->record_solve(iter, residual, residual <= tol);
 
             // Say something, only if the residual tolerance has not been reach in the maximum
             // number of iterations
-            if (residual >=this->newton_tol)
+            if (residual > tol)
             {
               cout << "Newton failed to converge: res = " << scientific << residual << " -- n_iter = " << iter << " of maxit = " << this->newton_maxit << endl;
             }
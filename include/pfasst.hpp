@@ -6,6 +6,7 @@ using namespace std;
 
 #include "pfasst/config.hpp"
 #include "pfasst/logging.hpp"
+#include "pfasst/encap/parallel.hpp"
 
 
 namespace pfasst
@@ -14,6 +15,7 @@ namespace pfasst
   {
     config::read_commandline(argc, argv);
     log::start_log(argc, argv);
+    encap::parallel::init_from_config();
     if (logs) {
       logs();
     }
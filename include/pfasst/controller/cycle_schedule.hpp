@@ -0,0 +1,107 @@
+/**
+ * @file controller/cycle_schedule.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__CONTROLLER__CYCLE_SCHEDULE_HPP_
+#define _PFASST__CONTROLLER__CYCLE_SCHEDULE_HPP_
+
+#include <cstddef>
+#include <map>
+#include <vector>
+using namespace std;
+
+#include "pfasst/interfaces.hpp"
+
+
+namespace pfasst
+{
+  /**
+   * Shape of the multigrid cycle of one MLSDC or PFASST iteration.
+   *
+   * On each level above the coarsest, a cycle sweeps, restricts to the next coarser level, visits
+   * the coarser levels, interpolates the correction and sweeps again.
+   * The shapes differ in how the coarser levels are visited.
+   *
+   * @since v0.6.0
+   */
+  enum class CycleShape : int {
+      V = 0  //!< one V-cycle on the next coarser level
+    , W = 1  //!< two W-cycles on the next coarser level
+    , F = 2  //!< one F-cycle followed by one V-cycle on the next coarser level
+  };
+
+
+  /**
+   * Schedule of the multigrid cycles of MLSDC and PFASST.
+   *
+   * Defines the shape of the cycles (see CycleShape), whether the first iteration of each time step
+   * is preceded by a _full multigrid_ start-up, and the number of sweeps on each level, which may
+   * vary with the iteration.
+   *
+   * @code
+   * auto schedule = make_shared<CycleSchedule>(CycleShape::W);
+   * schedule->set_nsweeps({1, 3, 4});     // more coarse sweeps in the first two iterations
+   * schedule->set_nsweeps({1, 1, 2}, 2);  // ... and less from the third iteration on
+   * controller.set_cycle_schedule(schedule);
+   * @endcode
+   *
+   * With the full multigrid start-up, the initial value is restricted to all levels and the
+   * coarsest level is predicted first.
+   * The result is then interpolated level by level, with one V-cycle on each intermediate level,
+   * before the iterations start on the finest level.
+   *
+   * @since v0.6.0
+   * @ingroup Controllers
+   */
+  class CycleSchedule
+  {
+    protected:
+      //! @{
+      CycleShape shape;
+      bool full_multigrid;
+
+      //! Number of sweeps per level, keyed by the first iteration they apply to.
+      map<size_t, vector<size_t>> nsweeps;
+      //! @}
+
+    public:
+      //! @{
+      CycleSchedule(CycleShape shape = CycleShape::V, bool full_multigrid = false);
+      virtual ~CycleSchedule() = default;
+      //! @}
+
+      //! @{
+      virtual void set_shape(CycleShape shape);
+      virtual CycleShape get_shape() const;
+
+      virtual void set_full_multigrid(bool full_multigrid);
+      virtual bool get_full_multigrid() const;
+
+      /**
+       * Sets the number of sweeps on each level from iteration @p from_iteration on.
+       *
+       * The counts apply until the next iteration given to set_nsweeps(); before the first one,
+       * the counts set on the controller are used (see MLSDC::set_nsweeps()).
+       *
+       * @param[in] nsweeps number of sweeps for each level; same level indexing as with
+       *   Controller::levels
+       * @param[in] from_iteration first iteration (counting from zero) the counts apply to
+       */
+      virtual void set_nsweeps(const vector<size_t>& nsweeps, size_t from_iteration = 0);
+
+      /**
+       * Number of sweeps on @p level in iteration @p iteration.
+       *
+       * @param[in] iteration current iteration
+       * @param[in] level level index
+       * @param[in] fallback number of sweeps if no counts have been set for @p iteration
+       * @throws ValueError if the counts of @p iteration do not cover @p level
+       */
+      virtual size_t get_nsweeps(size_t iteration, size_t level, size_t fallback) const;
+      //! @}
+  };
+}  // ::pfasst
+
+#include "pfasst/controller/cycle_schedule_impl.hpp"
+
+#endif  // _PFASST__CONTROLLER__CYCLE_SCHEDULE_HPP_
@@ -0,0 +1,55 @@
+#include "pfasst/controller/cycle_schedule.hpp"
+
+#include <string>
+using namespace std;
+
+
+namespace pfasst
+{
+  CycleSchedule::CycleSchedule(CycleShape shape, bool full_multigrid)
+    :   shape(shape)
+      , full_multigrid(full_multigrid)
+  {}
+
+  void CycleSchedule::set_shape(CycleShape shape)
+  {
+    this->shape = shape;
+  }
+
+  CycleShape CycleSchedule::get_shape() const
+  {
+    return this->shape;
+  }
+
+  void CycleSchedule::set_full_multigrid(bool full_multigrid)
+  {
+    this->full_multigrid = full_multigrid;
+  }
+
+  bool CycleSchedule::get_full_multigrid() const
+  {
+    return this->full_multigrid;
+  }
+
+  void CycleSchedule::set_nsweeps(const vector<size_t>& nsweeps, size_t from_iteration)
+  {
+    if (nsweeps.empty()) {
+      throw ValueError("number of sweeps must be given for each level");
+    }
+    this->nsweeps[from_iteration] = nsweeps;
+  }
+
+  size_t CycleSchedule::get_nsweeps(size_t iteration, size_t level, size_t fallback) const
+  {
+    auto entry = this->nsweeps.upper_bound(iteration);
+    if (entry == this->nsweeps.begin()) {
+      return fallback;
+    }
+    --entry;
+    if (level >= entry->second.size()) {
+      throw ValueError("no number of sweeps for level " + to_string(level) + " in iteration "
+                       + to_string(iteration));
+    }
+    return entry->second[level];
+  }
+}  // ::pfasst
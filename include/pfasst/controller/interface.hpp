@@ -12,6 +12,7 @@
 using namespace std;
 
 #include "pfasst/interfaces.hpp"
+#include "pfasst/controller/step_size_control.hpp"
 
 
 namespace pfasst
@@ -81,6 +82,46 @@ namespace pfasst
       time tend;
       //! @}
 
+      //! @{
+      /**
+       * Step size control; `nullptr` for fixed step sizes.
+       *
+       * @see set_step_size_control()
+       */
+      shared_ptr<StepSizeControl<time>> step_control;
+
+      /**
+       * Latest local error estimate of the finest level on the current time step.
+       *
+       * Only updated with a step size control.
+       */
+      time error_estimate;
+
+      /**
+       * Width of the next time step as proposed by #step_control.
+       */
+      time next_dt;
+
+      /**
+       * Limits @p dt such that the current time step does not exceed \\( T_{end} \\).
+       *
+       * The last time step ends on (or just after) \\( T_{end} \\) without any remainder.
+       */
+      virtual time clip_step_size(time dt);
+
+      /**
+       * Decides on the current time step according to #error_estimate.
+       *
+       * If the time step is rejected, the step size is reduced right away and the step has to be
+       * repeated.
+       * Otherwise the proposed step size becomes active with the next advance_time().
+       *
+       * @returns whether the current time step is accepted
+       * @pre #step_control is set.
+       */
+      virtual bool adapt_step_size();
+      //! @}
+
     public:
       //! @{
       Controller();
@@ -221,6 +262,38 @@ namespace pfasst
        */
       time get_dt() { return this->get_step_size(); }
 
+      /**
+       * Change the width of the current time step.
+       *
+       * Triggers ISweeper::post_step_size_change() on all levels if the width changes.
+       *
+       * @param[in] dt new \\( \\Delta t \\) of the current time step
+       */
+      virtual void set_step_size(time dt);
+
+      /**
+       * Enables adaptive step sizes.
+       *
+       * After each time step, the local error estimate of the finest level (see
+       * ISweeper::estimate_error()) is handed to @p control to accept or reject the step and to
+       * propose the width of the next (or repeated) one.
+       * The step size given to set_duration() is the initial one.
+       *
+       * @param[in] control step size control; `nullptr` restores fixed step sizes
+       *
+       * @note Only the SDC and MLSDC controllers adapt their step sizes; PFASST (on more than one
+       *   process) and Parareal throw NotImplementedYet from `run()` if a control is set.
+       * @since v0.6.0
+       */
+      virtual void set_step_size_control(shared_ptr<StepSizeControl<time>> control);
+
+      /**
+       * Get the step size control.
+       *
+       * @returns step size control; `nullptr` for fixed step sizes
+       */
+      virtual shared_ptr<StepSizeControl<time>> get_step_size_control();
+
       /**
        * Get start time point of current time step.
        *
@@ -238,6 +311,8 @@ namespace pfasst
       /**
        * Advance to a following time step
        *
+       * With a step size control, the width proposed for the previous step becomes active.
+       *
        * @param[in] nsteps number of time steps to advance; `1` meaning the next step
        */
       virtual void advance_time(size_t nsteps = 1);
@@ -1,6 +1,11 @@
 #include "pfasst/controller/interface.hpp"
 
+#include <cmath>
+#include <limits>
+using namespace std;
+
 #include "pfasst/config.hpp"
+#include "pfasst/logging.hpp"
 
 
 namespace pfasst
@@ -13,6 +18,9 @@ namespace pfasst
       , t(0.0)
       , dt(0.0)
       , tend(0.0)
+      , step_control(nullptr)
+      , error_estimate(-1.0)
+      , next_dt(0.0)
   {}
 
   template<typename time>
@@ -78,6 +86,65 @@ namespace pfasst
     return dt;
   }
 
+  template<typename time>
+  void Controller<time>::set_step_size(time dt)
+  {
+    if (dt == this->dt) {
+      return;
+    }
+    this->dt = dt;
+    for (auto l = coarsest(); l <= finest(); ++l) {
+      l.current()->post_step_size_change();
+    }
+  }
+
+  template<typename time>
+  void Controller<time>::set_step_size_control(shared_ptr<StepSizeControl<time>> control)
+  {
+    this->step_control = control;
+  }
+
+  template<typename time>
+  shared_ptr<StepSizeControl<time>> Controller<time>::get_step_size_control()
+  {
+    return this->step_control;
+  }
+
+  template<typename time>
+  time Controller<time>::clip_step_size(time dt)
+  {
+    const time remaining = this->tend - this->t;
+    if (dt < remaining) {
+      return dt;
+    }
+    // make sure t + dt does not fall short of tend due to rounding
+    dt = remaining;
+    while (this->t + dt < this->tend) {
+      dt = nextafter(dt, numeric_limits<time>::max());
+    }
+    return dt;
+  }
+
+  template<typename time>
+  bool Controller<time>::adapt_step_size()
+  {
+    assert(this->step_control);
+    const bool accepted = this->step_control->accept(this->dt, this->error_estimate);
+    const time dt = this->step_control->propose(this->dt, this->error_estimate, accepted);
+
+    if (accepted) {
+      ML_CLOG(DEBUG, "Controller", "step " << this->step + 1 << " accepted (dt=" << this->dt
+                                  << ", error=" << this->error_estimate << "), next dt=" << dt);
+      this->next_dt = dt;
+    } else {
+      ML_CLOG(INFO, "Controller", "step " << this->step + 1 << " rejected (dt=" << this->dt
+                                 << ", error=" << this->error_estimate << "), retrying with dt="
+                                 << dt);
+      this->set_step_size(this->clip_step_size(dt));
+    }
+    return accepted;
+  }
+
   template<typename time>
   time Controller<time>::get_time()
   {
@@ -89,6 +156,9 @@ namespace pfasst
   {
     step += nsteps;
     t += nsteps * dt;
+    if (this->step_control && t < tend) {
+      this->set_step_size(this->clip_step_size(this->next_dt));
+    }
   }
 
   template<typename time>
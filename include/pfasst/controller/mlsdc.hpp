@@ -5,10 +5,12 @@
 #ifndef _PFASST__CONTROLLER__MLSDC_HPP_
 #define _PFASST__CONTROLLER__MLSDC_HPP_
 
+#include <memory>
 #include <vector>
 using namespace std;
 
 #include "pfasst/controller/interface.hpp"
+#include "pfasst/controller/cycle_schedule.hpp"
 
 
 namespace pfasst
@@ -27,6 +29,9 @@ namespace pfasst
     protected:
       vector<size_t> nsweeps;  //!< How many sweeps should be done on the different levels.
 
+      //! Shape of the cycles and sweeps per iteration; a plain V-cycle if not set.
+      shared_ptr<CycleSchedule> schedule;
+
       typedef typename pfasst::Controller<time>::LevelIter LevelIter;
 
       bool predict;   //!< Whether to use a _predict_ sweep.
@@ -41,6 +46,21 @@ namespace pfasst
        */
       void perform_sweeps(size_t level);
 
+      /**
+       * Number of sweeps on level @p level in the current iteration.
+       *
+       * @see set_nsweeps() and set_cycle_schedule()
+       * @since v0.6.0
+       */
+      size_t num_sweeps(size_t level);
+
+      /**
+       * Shape of the cycles of the current schedule.
+       *
+       * @since v0.6.0
+       */
+      CycleShape cycle_shape();
+
     public:
       //! @copydoc Controller::setup()
       virtual void setup() override;
@@ -54,6 +74,18 @@ namespace pfasst
        */
       virtual void set_nsweeps(vector<size_t> nsweeps);
 
+      /**
+       * Set the schedule of the multigrid cycles.
+       *
+       * Without a schedule, each iteration is one V-cycle with the number of sweeps given by
+       * set_nsweeps().
+       *
+       * @param[in] schedule cycle schedule; `nullptr` restores the plain V-cycle
+       * @since v0.6.0
+       */
+      virtual void set_cycle_schedule(shared_ptr<CycleSchedule> schedule);
+      virtual shared_ptr<CycleSchedule> get_cycle_schedule();
+
       /**
        * Solve ODE using MLSDC.
        *
@@ -98,6 +130,24 @@ namespace pfasst
        *   convergence or all sweeps on all coarser levels did not let to convergence
        */
       LevelIter cycle_v(LevelIter level_iter);
+
+      /**
+       * Perform an MLSDC cycle of the given @p shape.
+       *
+       * @param[in] level_iter level iterator pointing to a fine level
+       * @param[in] shape shape of the cycle
+       * @returns see cycle_v()
+       * @since v0.6.0
+       */
+      LevelIter cycle(LevelIter level_iter, CycleShape shape);
+
+      /**
+       * Full multigrid start-up: predict on the coarsest level and work up to the finest level
+       * with one V-cycle on each intermediate level.
+       *
+       * @since v0.6.0
+       */
+      void predict_full_multigrid();
   };
 }  // ::pfasst
 
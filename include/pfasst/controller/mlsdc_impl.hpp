@@ -13,7 +13,8 @@ namespace pfasst
   {
     auto sweeper = this->get_level(level);
     ML_CVLOG(1, "Controller", "on level " << level + 1 << "/" << this->nlevels());
-    for (size_t s = 0; s < this->nsweeps[level]; s++) {
+    const size_t nsweeps = this->num_sweeps(level);
+    for (size_t s = 0; s < nsweeps; s++) {
       if (predict) {
         sweeper->predict(initial & predict);
         sweeper->post_predict();
@@ -25,6 +26,21 @@ namespace pfasst
     }
   }
 
+  template<typename time>
+  size_t MLSDC<time>::num_sweeps(size_t level)
+  {
+    if (this->schedule) {
+      return this->schedule->get_nsweeps(this->get_iteration(), level, this->nsweeps[level]);
+    }
+    return this->nsweeps[level];
+  }
+
+  template<typename time>
+  CycleShape MLSDC<time>::cycle_shape()
+  {
+    return this->schedule ? this->schedule->get_shape() : CycleShape::V;
+  }
+
   template<typename time>
   void MLSDC<time>::setup()
   {
@@ -42,23 +58,61 @@ namespace pfasst
     this->nsweeps = nsweeps;
   }
 
+  template<typename time>
+  void MLSDC<time>::set_cycle_schedule(shared_ptr<CycleSchedule> schedule)
+  {
+    this->schedule = schedule;
+  }
+
+  template<typename time>
+  shared_ptr<CycleSchedule> MLSDC<time>::get_cycle_schedule()
+  {
+    return this->schedule;
+  }
+
+  /**
+   * With a step size control (see Controller::set_step_size_control()), the local error is
+   * estimated via ISweeper::estimate_error() on the finest level after its final sweep.
+   * A rejected time step is repeated with the reduced step size right away; ISweeper::post_step()
+   * and ISweeper::advance() are only called for accepted steps.
+   *
+   * The shape of the cycles, the number of sweeps per iteration and the full multigrid start-up
+   * are taken from the cycle schedule, if any (see MLSDC::set_cycle_schedule()).
+   */
   template<typename time>
   void MLSDC<time>::run()
   {
-    for (; this->get_time() < this->get_end_time(); this->advance_time()) {
+    const bool adaptive = bool(this->step_control);
+    if (adaptive) {
+      this->set_step_size(this->clip_step_size(this->get_step_size()));
+    }
+
+    while (this->get_time() < this->get_end_time()) {
       predict = true;
       initial = true;
       converged = false;
 
+      this->set_iteration(0);
+      if (this->schedule && this->schedule->get_full_multigrid() && this->nlevels() > 1) {
+        predict_full_multigrid();
+      }
+
       for (this->set_iteration(0);
            this->get_iteration() < this->get_max_iterations() && !converged;
            this->advance_iteration()) {
-        cycle_v(this->finest());
+        cycle(this->finest(), this->cycle_shape());
         initial = false;
       }
 
       perform_sweeps(this->finest().level);
 
+      if (adaptive) {
+        this->error_estimate = this->get_finest()->estimate_error();
+        if (!this->adapt_step_size()) {
+          continue;
+        }
+      }
+
       for (auto l = this->finest(); l >= this->coarsest(); --l) {
         l.current()->post_step();
       }
@@ -66,6 +120,7 @@ namespace pfasst
       if (this->get_time() + this->get_step_size() < this->get_end_time()) {
         this->get_finest()->advance();
       }
+      this->advance_time();
     }
   }
 
@@ -134,17 +189,69 @@ namespace pfasst
 
   template<typename time>
   typename MLSDC<time>::LevelIter MLSDC<time>::cycle_v(typename MLSDC<time>::LevelIter level_iter)
+  {
+    return cycle(level_iter, CycleShape::V);
+  }
+
+  /**
+   * A W-cycle visits the next coarser level with two W-cycles, an F-cycle with one F-cycle
+   * followed by one V-cycle; between these visits, the coarser level is swept again (see
+   * MLSDC::cycle_up() and MLSDC::cycle_down()).
+   */
+  template<typename time>
+  typename MLSDC<time>::LevelIter MLSDC<time>::cycle(typename MLSDC<time>::LevelIter level_iter,
+                                                     CycleShape shape)
   {
     if (level_iter.level == 0) {
       level_iter = cycle_bottom(level_iter);
     } else {
-      level_iter = cycle_down(level_iter);
+      auto crse_iter = cycle_down(level_iter);
       if (converged) {
-        return level_iter;
+        return crse_iter;
+      }
+      switch (shape) {
+        case CycleShape::W:
+          cycle(crse_iter, CycleShape::W);
+          cycle(crse_iter, CycleShape::W);
+          break;
+        case CycleShape::F:
+          cycle(crse_iter, CycleShape::F);
+          cycle(crse_iter, CycleShape::V);
+          break;
+        default:
+          cycle(crse_iter, CycleShape::V);
       }
-      level_iter = cycle_v(level_iter);
       level_iter = cycle_up(level_iter);
     }
     return level_iter;
   }
+
+  /**
+   * The initial value of the finest level is restricted to all coarser levels (see
+   * ITransfer::restrict_initial()), which are spread and saved.
+   * The coarsest level is predicted and its correction interpolated to the next finer level,
+   * where a V-cycle is done; this is repeated up to the finest level, which is only
+   * interpolated to.
+   */
+  template<typename time>
+  void MLSDC<time>::predict_full_multigrid()
+  {
+    this->get_finest()->spread();
+    for (auto l = this->finest() - 1; l >= this->coarsest(); --l) {
+      auto crse = l.current();
+      (l + 1).transfer()->restrict_initial(crse, l.fine());
+      crse->spread();
+      crse->save();
+    }
+
+    perform_sweeps(this->coarsest().level);
+    predict = false;
+
+    for (auto l = this->coarsest() + 1; l <= this->finest(); ++l) {
+      l.transfer()->interpolate(l.current(), l.coarse(), true);
+      if (l < this->finest()) {
+        cycle(l, CycleShape::V);
+      }
+    }
+  }
 }  // ::pfasst
@@ -0,0 +1,242 @@
+/**
+ * @file controller/parareal.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__CONTROLLER__PARAREAL_HPP_
+#define _PFASST__CONTROLLER__PARAREAL_HPP_
+
+#include <memory>
+using namespace std;
+
+#include "pfasst/controller/interface.hpp"
+#include "pfasst/encap/encap_sweeper.hpp"
+
+
+namespace pfasst
+{
+  /**
+   * How a level of the Parareal controller propagates a value over one time step.
+   *
+   * @since v0.6.0
+   */
+  enum class PropagatorType : int {
+      Sweeps      = 0  //!< a fixed number of sweeps, the first of which is the predictor
+    , Collocation = 1  //!< sweeps until the level has converged (see ISweeper::converged())
+  };
+
+
+  /**
+   * Implementation of the Parareal algorithm \cite lions_parareal_2001 on two levels.
+   *
+   * The finest level is the fine propagator \\( \\mathcal{F} \\), the coarsest level the coarse
+   * propagator \\( \\mathcal{G} \\), and the transfer operator of the finest level maps values
+   * between both.
+   * In iteration \\( k \\), the value at the end of time step \\( n \\) is updated by
+   * \\[
+   * U_{n+1}^{k+1} = \\mathcal{F}(U_n^k)
+   *   + I \\left( \\mathcal{G}(R U_n^{k+1}) - \\mathcal{G}(R U_n^k) \\right)
+   * \\]
+   * with restriction \\( R \\) and interpolation \\( I \\) of the initial values (see
+   * ITransfer::restrict_initial() and ITransfer::interpolate_initial()).
+   * The fine propagations of all time steps run in parallel, the coarse ones one after another.
+   *
+   * A time step is converged once the change of its end value is below the tolerance (see
+   * set_tolerance()), and in any case in the iteration after all previous steps have converged.
+   * The convergence status is exchanged as with PFASST, see IStatus.
+   *
+   * @tparam time time precision; defaults to pfasst::time_precision
+   * @since v0.6.0
+   * @ingroup Controllers
+   */
+  template<typename time = pfasst::time_precision>
+  class Parareal
+    : public Controller<time>
+  {
+    protected:
+      //! Type and maximum number of sweeps of a propagator.
+      struct Propagator
+      {
+        PropagatorType type;
+        size_t nsweeps;
+      };
+
+      ICommunicator* comm;  //!< communicator to use
+
+      //! @{
+      Propagator fine_propagator;
+      Propagator crse_propagator;
+
+      //! Tolerance of the change of the end value of a time step.
+      time tol;
+      //! @}
+
+      //! @{
+      bool pipelined;       //!< whether to use the pipelined schedule (see set_pipelined())
+      bool first;           //!< (pipelined) whether all previous time steps are finished
+      bool newest;          //!< (pipelined) whether this is the last time step of the window
+      bool finished;        //!< (pipelined) whether the current time step is finished
+      bool received;        //!< (pipelined) whether the start value of this iteration is in already
+      size_t window_start;  //!< (pipelined) first unfinished time step, as known to this process
+      size_t ncycles;       //!< (pipelined) number of iterations since the start; used for the tags
+      //! @}
+
+      //! @{
+      //! Start value \\( U_n \\) of the current time step.
+      shared_ptr<encap::Encapsulation<time>> u_start;
+      //! End value \\( U_{n+1} \\) of the current time step.
+      shared_ptr<encap::Encapsulation<time>> u_end;
+      //! Fine propagation of the start value, and the new end value after the correction.
+      shared_ptr<encap::Encapsulation<time>> u_next;
+      //! Coarse propagation of the start value of the previous iteration.
+      shared_ptr<encap::Encapsulation<time>> g_old;
+      //! Coarse correction to interpolate.
+      shared_ptr<encap::Encapsulation<time>> delta;
+      //! @}
+
+      /**
+       * Propagate the start value of @p sweeper over the current time step.
+       */
+      virtual void propagate(shared_ptr<ISweeper<time>> sweeper, const Propagator& propagator);
+
+      /**
+       * Coarse propagation of Parareal::u_start; the result is the end state of the coarsest level.
+       */
+      virtual void propagate_coarse();
+
+      /**
+       * Set @p dst to \\( base + I(\\delta) \\) with the coarse correction Parareal::delta.
+       *
+       * Goes through the start states of both levels, which are overwritten.
+       */
+      virtual void interpolate_correction(shared_ptr<encap::Encapsulation<time>> dst,
+                                          shared_ptr<const encap::Encapsulation<time>> base);
+
+      /**
+       * Hand the end value of the current time step to the finest level.
+       */
+      virtual void set_end_state();
+
+    public:
+      Parareal();
+
+      //! @copydoc Controller::setup()
+      virtual void setup() override;
+
+      /**
+       * Solve ODE using Parareal.
+       *
+       * @pre It is assumed that the user has set initial conditions on the finest level.
+       */
+      virtual void run();
+
+      //! @{
+      /**
+       * Set the fine propagator; defaults to the collocation solve with at most 20 sweeps.
+       *
+       * @param[in] type kind of the propagator
+       * @param[in] nsweeps number of sweeps (PropagatorType::Sweeps) or maximum number of sweeps
+       *   (PropagatorType::Collocation) per time step
+       * @throws ValueError if @p nsweeps is zero
+       */
+      virtual void set_fine_propagator(PropagatorType type, size_t nsweeps);
+
+      /**
+       * Set the coarse propagator; defaults to a single sweep, i.e. the predictor.
+       *
+       * @copydetails set_fine_propagator()
+       */
+      virtual void set_coarse_propagator(PropagatorType type, size_t nsweeps);
+
+      /**
+       * Set the tolerance of the change of the end value of a time step (see
+       * encap::Encapsulation::norm0()); defaults to `0`.
+       *
+       * Independent of the tolerance, a time step converges in the iteration after all previous
+       * steps have converged, as its fine propagation then starts from their final value.
+       */
+      virtual void set_tolerance(time tol);
+
+      /**
+       * Switch between _block mode_ and the _pipelined_ schedule.
+       *
+       * In block mode (the default), all processes iterate on a block of consecutive time steps
+       * until the last one has converged, before the end value is broadcast and the next block
+       * starts.
+       *
+       * With the pipelined schedule, the time steps are distributed round-robin as with
+       * PFASST::set_sliding_window(): a process whose step is finished starts its next step right
+       * away.
+       *
+       * @param[in] pipelined `true` for the pipelined schedule
+       */
+      virtual void set_pipelined(bool pipelined);
+
+      /**
+       * Set communicator.
+       *
+       * @param[in] comm ICommunicator to use
+       */
+      virtual void set_comm(ICommunicator* comm);
+      //! @}
+
+    protected:
+      //! @{
+      /**
+       * One Parareal iteration on the current time step.
+       */
+      virtual void iterate();
+
+      /**
+       * Predictor: coarse propagation from the initial value of the finest level.
+       *
+       * @param[in] ncoarse number of coarse time steps to propagate over, starting from
+       *   Parareal::u_start and ending with the current time step
+       */
+      virtual void predictor(size_t ncoarse);
+
+      /**
+       * Run all @p nsteps time steps with the fine propagator only.
+       */
+      virtual void run_serial(size_t nsteps);
+
+      /**
+       * Run one block of time steps, one per process of Parareal::comm.
+       *
+       * @param[in] block_start index of the first time step of the block
+       */
+      virtual void run_block(size_t block_start);
+
+      /**
+       * Run all @p nsteps time steps with the pipelined schedule.
+       *
+       * @see set_pipelined()
+       */
+      virtual void run_pipelined(size_t nsteps);
+      //! @}
+
+      /**
+       * @name Communication
+       * @{
+       */
+      /**
+       * Tag of the end values.
+       */
+      virtual int tag();
+
+      /**
+       * Tag of the status messages; positive and below the tags of tag().
+       */
+      virtual int stag();
+
+      /**
+       * Tag of the messages handing on the start of the pipelined window; `0`, which neither tag()
+       * nor stag() use.
+       */
+      virtual int wtag();
+      //! @}
+  };
+}  // ::pfasst
+
+#include "pfasst/controller/parareal_impl.hpp"
+
+#endif  // _PFASST__CONTROLLER__PARAREAL_HPP_
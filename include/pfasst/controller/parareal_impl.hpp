@@ -0,0 +1,444 @@
+#include "pfasst/controller/parareal.hpp"
+
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+#include "pfasst/logging.hpp"
+
+
+namespace pfasst
+{
+  template<typename time>
+  Parareal<time>::Parareal()
+    :   comm(nullptr)
+      , fine_propagator{PropagatorType::Collocation, 20}
+      , crse_propagator{PropagatorType::Sweeps, 1}
+      , tol(0.0)
+      , pipelined(false)
+      , first(false)
+      , newest(false)
+      , finished(false)
+      , received(false)
+      , window_start(0)
+      , ncycles(0)
+  {}
+
+  template<typename time>
+  void Parareal<time>::setup()
+  {
+    if (this->nlevels() != 2) {
+      throw ValueError("Parareal needs exactly two levels");
+    }
+    for (auto l = this->coarsest(); l <= this->finest(); ++l) {
+      l.current()->set_controller(this);
+      l.current()->setup(l != this->finest());
+    }
+
+    auto fine_factory = encap::as_encap_sweeper(this->get_finest()).get_factory();
+    auto crse_factory = encap::as_encap_sweeper(this->get_coarsest()).get_factory();
+    this->u_start = fine_factory->create(encap::solution);
+    this->u_end   = fine_factory->create(encap::solution);
+    this->u_next  = fine_factory->create(encap::solution);
+    this->g_old   = crse_factory->create(encap::solution);
+    this->delta   = crse_factory->create(encap::solution);
+  }
+
+  template<typename time>
+  void Parareal<time>::set_fine_propagator(PropagatorType type, size_t nsweeps)
+  {
+    if (nsweeps == 0) {
+      throw ValueError("a propagator needs at least one sweep");
+    }
+    this->fine_propagator = Propagator{type, nsweeps};
+  }
+
+  template<typename time>
+  void Parareal<time>::set_coarse_propagator(PropagatorType type, size_t nsweeps)
+  {
+    if (nsweeps == 0) {
+      throw ValueError("a propagator needs at least one sweep");
+    }
+    this->crse_propagator = Propagator{type, nsweeps};
+  }
+
+  template<typename time>
+  void Parareal<time>::set_tolerance(time tol)
+  {
+    this->tol = tol;
+  }
+
+  template<typename time>
+  void Parareal<time>::set_pipelined(bool pipelined)
+  {
+    this->pipelined = pipelined;
+  }
+
+  template<typename time>
+  void Parareal<time>::set_comm(ICommunicator* comm)
+  {
+    this->comm = comm;
+  }
+
+  template<typename time>
+  void Parareal<time>::propagate(shared_ptr<ISweeper<time>> sweeper, const Propagator& propagator)
+  {
+    sweeper->predict(true);
+    for (size_t s = 1; s < propagator.nsweeps; s++) {
+      if (propagator.type == PropagatorType::Collocation && sweeper->converged()) {
+        break;
+      }
+      sweeper->sweep();
+    }
+  }
+
+  template<typename time>
+  void Parareal<time>::propagate_coarse()
+  {
+    auto fine = this->get_finest();
+    auto crse = this->get_coarsest();
+    encap::as_encap_sweeper(fine).get_start_state()->copy(this->u_start);
+    this->finest().transfer()->restrict_initial(crse, fine);
+    this->propagate(crse, this->crse_propagator);
+  }
+
+  template<typename time>
+  void Parareal<time>::interpolate_correction(shared_ptr<encap::Encapsulation<time>> dst,
+                                              shared_ptr<const encap::Encapsulation<time>> base)
+  {
+    auto fine = this->get_finest();
+    auto crse = this->get_coarsest();
+    auto trns = this->finest().transfer();
+
+    // interpolate_initial() adds the interpolated difference between the coarse start state and
+    // the restricted fine one
+    encap::as_encap_sweeper(fine).get_start_state()->copy(base);
+    trns->restrict_initial(crse, fine);
+    encap::as_encap_sweeper(crse).get_start_state()->saxpy(1.0, this->delta);
+    trns->interpolate_initial(fine, crse);
+    dst->copy(encap::as_encap_sweeper(fine).get_start_state());
+  }
+
+  template<typename time>
+  void Parareal<time>::set_end_state()
+  {
+    encap::as_encap_sweeper(this->get_finest()).get_end_state()->copy(this->u_end);
+  }
+
+  /**
+   * @note Uses _block mode_ unless the pipelined schedule has been enabled (see
+   *   Parareal::set_pipelined()).
+   *
+   * As with PFASST::run(), the number of time steps does not need to be a multiple of the number
+   * of processes.
+   * On a single process, the fine propagator runs on its own.
+   *
+   * @throws NotImplementedYet if a step size control is set (see
+   *   Controller::set_step_size_control())
+   */
+  template<typename time>
+  void Parareal<time>::run()
+  {
+    if (this->get_step_size_control()) {
+      ML_CLOG(ERROR, "Controller", "adaptive step sizes are not supported by Parareal");
+      throw NotImplementedYet("adaptive step sizes with Parareal");
+    }
+
+    const time duration = this->get_end_time() - this->get_time();
+    const size_t nsteps = size_t(std::round(duration / this->get_step_size()));
+
+    if (nsteps == 0 || std::abs(time(nsteps) * this->get_step_size() - duration) > 1e-8 * duration) {
+      ML_CLOG(INFO, "Controller", "invalid duration: mismatch between step size and time interval");
+      throw ValueError("invalid duration: mismatch between step size and time interval");
+    }
+
+    if (this->comm->size() == 1) {
+      this->run_serial(nsteps);
+      return;
+    }
+
+    if (this->pipelined) {
+      this->run_pipelined(nsteps);
+      return;
+    }
+
+    ICommunicator* world = this->comm;
+    const size_t nprocs = world->size();
+
+    for (size_t block_start = 0; block_start < nsteps; block_start += nprocs) {
+      const size_t nactive = min(nprocs, nsteps - block_start);
+
+      if (nactive == nprocs) {
+        this->run_block(block_start);
+      } else {
+        ML_CLOG(INFO, "Controller", "last block of " << nactive << " steps runs on the first "
+                                    << nactive << " of " << nprocs << " processes");
+        auto block_comm = world->sub_communicator(nactive);
+        if (block_comm) {
+          this->comm = block_comm.get();
+          this->run_block(block_start);
+          this->comm = world;
+        } else {
+          this->set_step(nsteps - 1);
+        }
+      }
+
+      if (block_start + nprocs < nsteps) {
+        this->get_finest()->broadcast(this->comm);
+      } else if (nactive < nprocs) {
+        this->get_finest()->broadcast_end_state(world, nactive - 1);
+      }
+    }
+  }
+
+  template<typename time>
+  void Parareal<time>::run_serial(size_t nsteps)
+  {
+    auto fine = this->get_finest();
+    for (size_t n = 0; n < nsteps; n++) {
+      this->set_step(n);
+      this->set_iteration(0);
+      this->propagate(fine, this->fine_propagator);
+      fine->post_sweep();
+      for (auto l = this->finest(); l >= this->coarsest(); --l) {
+        l.current()->post_step();
+      }
+      if (n + 1 < nsteps) {
+        fine->advance();
+      }
+    }
+  }
+
+  template<typename time>
+  void Parareal<time>::run_block(size_t block_start)
+  {
+    this->set_step(block_start + this->comm->rank());
+    this->u_start->copy(encap::as_encap_sweeper(this->get_finest()).get_start_state());
+
+    this->set_iteration(0);
+    this->predictor(this->comm->rank() + 1);
+
+    ML_CLOG(DEBUG, "Controller", "iterating on step " << this->get_step()
+                                 << " (0/" << this->get_max_iterations() << ")");
+    for (this->set_iteration(0);
+         this->get_iteration() < this->get_max_iterations() && this->comm->status->keep_iterating();
+         this->advance_iteration()) {
+      this->iterate();
+    }
+    ML_CLOG(DEBUG, "Controller", "done iterating on step " << this->get_step()
+                                 << " (" << this->get_iteration() << "/"
+                                 << this->get_max_iterations() << ")");
+
+    for (auto l = this->finest(); l >= this->coarsest(); --l) {
+      l.current()->post_step();
+    }
+
+    this->comm->status->clear();
+  }
+
+  /**
+   * Follows the schedule of PFASST::run_sliding(): each iteration of a time step tells this
+   * process the first unfinished time step, and the newest step of the window hands the new start
+   * of the window on to the next process.
+   * A newly started step waits for the current value of the previous step and predicts from it;
+   * if all previous steps are finished already, it receives their final value along with the
+   * window.
+   */
+  template<typename time>
+  void Parareal<time>::run_pipelined(size_t nsteps)
+  {
+    const size_t nprocs = this->comm->size();
+    size_t step = this->comm->rank();
+
+    if (step < nsteps) {
+      this->comm->set_periodic(true);
+      this->ncycles = 0;
+      this->set_step(step);
+      this->first = (step == 0);
+      this->newest = (step + 1 == min(nprocs, nsteps));
+      this->received = false;
+      this->u_start->copy(encap::as_encap_sweeper(this->get_finest()).get_start_state());
+      this->set_iteration(0);
+      this->predictor(step + 1);
+
+      while (true) {
+        ML_CLOG(DEBUG, "Controller", "iterating on step " << step);
+        for (this->set_iteration(0); ; this->advance_iteration()) {
+          if (this->get_iteration() == 0 && step >= nprocs) {
+            if (!this->first) {
+              this->u_start->recv(this->comm, this->tag(), true);
+              this->window_start = size_t(this->comm->status->recv_value(this->stag()));
+              this->received = true;
+            }
+            this->predictor(1);
+          }
+          this->iterate();
+          this->ncycles++;
+
+          if (this->newest) {
+            const size_t last = min(this->window_start + nprocs, nsteps) - 1;
+            if (last > step) {
+              this->comm->status->send_value(this->wtag(), int(this->window_start));
+              if (this->finished) {
+                this->u_end->send(this->comm, this->wtag(), true);
+              }
+              this->newest = false;
+            }
+          }
+          if (this->finished) {
+            break;
+          }
+          this->first = (this->window_start == step);
+        }
+        ML_CLOG(DEBUG, "Controller", "done iterating on step " << step
+                                     << " (" << this->get_iteration() << "/"
+                                     << this->get_max_iterations() << ")");
+
+        for (auto l = this->finest(); l >= this->coarsest(); --l) {
+          l.current()->post_step();
+        }
+
+        step += nprocs;
+        if (step >= nsteps) {
+          break;
+        }
+        this->set_step(step);
+
+        this->window_start = size_t(this->comm->status->recv_value(this->wtag()));
+        this->newest = (step + 1 == min(this->window_start + nprocs, nsteps));
+        if (!this->newest) {
+          this->comm->status->send_value(this->wtag(), int(this->window_start));
+        }
+        this->first = (this->window_start == step);
+        if (this->first) {
+          this->u_start->recv(this->comm, this->wtag(), true);
+        }
+      }
+      this->comm->set_periodic(false);
+    }
+
+    this->set_step(nsteps - 1);
+    this->get_finest()->broadcast_end_state(this->comm, (nsteps - 1) % nprocs);
+  }
+
+  /**
+   * The fine propagation starts from a copy of the start value of the previous iteration while the
+   * new one is received into Parareal::u_start; the coarse propagation of the new start value then corrects the result.
+   * If the start value has not changed, the fine propagation is the new end value as it is.
+   */
+  template<typename time>
+  void Parareal<time>::iterate()
+  {
+    auto fine = this->get_finest();
+    const size_t step = this->get_step();
+
+    // the start value is final once all previous time steps have converged
+    const bool exact = this->pipelined
+                       ? this->first || (this->received && this->window_start == step)
+                       : !this->comm->status->previous_is_iterating();
+    const bool update = !exact && !this->received;
+
+    // the fine start value has to be taken before Parareal::u_start becomes a receive buffer
+    encap::as_encap_sweeper(fine).get_start_state()->copy(this->u_start);
+    if (update) {
+      this->comm->status->post(0);
+      this->u_start->post(this->comm, this->tag());
+    }
+
+    this->propagate(fine, this->fine_propagator);
+    this->u_next->copy(encap::as_encap_sweeper(fine).get_end_state());
+
+    size_t start = this->received ? this->window_start : step;
+    if (update) {
+      this->u_start->recv(this->comm, this->tag(), false);
+      if (this->pipelined) {
+        start = size_t(this->comm->status->recv_value(this->stag()));
+      }
+    }
+    if (!this->pipelined) {
+      this->comm->status->recv(this->stag());
+    }
+
+    if (update) {
+      this->propagate_coarse();
+      auto crse_end = encap::as_encap_sweeper(this->get_coarsest()).get_end_state();
+      this->delta->copy(crse_end);
+      this->delta->saxpy(-1.0, this->g_old);
+      this->g_old->copy(crse_end);
+      this->interpolate_correction(this->u_next, this->u_next);
+    }
+
+    this->u_end->saxpy(-1.0, this->u_next);
+    const time change = this->u_end->norm0();
+    this->u_end->copy(this->u_next);
+    this->set_end_state();
+    fine->post_sweep();
+
+    const bool converged = exact || change <= this->tol;
+    ML_CLOG(DEBUG, "Controller", "change of the end value of step " << step << ": " << change
+                                 << " --> converged: " << boolalpha << converged);
+
+    if (this->pipelined) {
+      this->finished = exact
+                       || (start == step
+                           && (converged || this->get_iteration() + 1 >= this->get_max_iterations()));
+      this->window_start = this->finished ? step + 1 : start;
+      if (!this->newest) {
+        this->u_end->send(this->comm, this->tag(), true);
+        this->comm->status->send_value(this->stag(), int(this->window_start));
+      }
+    } else {
+      this->comm->status->set_converged(converged);
+      this->comm->status->set_converged(!this->comm->status->keep_iterating());
+      this->u_end->send(this->comm, this->tag(), true);
+      this->comm->status->send(this->stag());
+    }
+    this->received = false;
+  }
+
+  /**
+   * The coarse propagations also provide \\( \\mathcal{G}(R U_n^k) \\) for the first iteration,
+   * and the predicted end value \\( U_n^k + I(\\mathcal{G}(R U_n^k) - R U_n^k) \\) of each step
+   * is the start value of the next one.
+   */
+  template<typename time>
+  void Parareal<time>::predictor(size_t ncoarse)
+  {
+    const size_t step = this->get_step();
+    auto& crse = encap::as_encap_sweeper(this->get_coarsest());
+
+    for (size_t n = step + 1 - ncoarse; n <= step; n++) {
+      this->set_step(n);
+      this->propagate_coarse();
+      this->g_old->copy(crse.get_end_state());
+      this->delta->copy(crse.get_end_state());
+      this->delta->saxpy(-1.0, crse.get_start_state());
+      this->interpolate_correction(this->u_end, this->u_start);
+      if (n < step) {
+        this->u_start->copy(this->u_end);
+      }
+    }
+
+    this->set_end_state();
+  }
+
+  template<typename time>
+  int Parareal<time>::tag()
+  {
+    const size_t index = this->pipelined ? this->ncycles % 1000 : this->get_iteration();
+    return 10000 + index;
+  }
+
+  template<typename time>
+  int Parareal<time>::stag()
+  {
+    return (this->pipelined ? this->ncycles % 1000 : this->get_iteration()) + 1;
+  }
+
+  template<typename time>
+  int Parareal<time>::wtag()
+  {
+    // stag() starts at 1 and tag() at 10000, thus 0 is left to the window messages
+    return 0;
+  }
+}  // ::pfasst
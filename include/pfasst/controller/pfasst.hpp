@@ -23,10 +23,29 @@ namespace pfasst
 
       ICommunicator* comm;  //!< communicator to use
       bool predict;         //!< whether to use a _predict_ sweep
+      size_t block_length;  //!< maximal number of time steps per block (see set_block_length())
+
+      //! @{
+      bool sliding;         //!< whether to use the sliding-window schedule (see set_sliding_window())
+      bool first;           //!< (sliding) whether all previous time steps are finished
+      bool newest;          //!< (sliding) whether this is the last time step of the window
+      bool fine_converged;  //!< (sliding) whether the finest level converged in this iteration
+      bool finished;        //!< (sliding) whether the current time step is finished
+      size_t window_start;  //!< (sliding) first unfinished time step, as known to this process
+      size_t ncycles;       //!< (sliding) number of cycles since the start; used for the tags
+      //! @}
+
+      //! @{
+      //! Levels that have already sent (received) in the current iteration.
+      vector<bool> sent;
+      vector<bool> received;
+      //! @}
 
       void perform_sweeps(size_t level);
 
     public:
+      PFASST();
+
       /**
        * Solve ODE using PFASST.
        *
@@ -34,6 +53,39 @@ namespace pfasst
        */
       virtual void run() override;
 
+      /**
+       * Switch between _block mode_ and the _sliding-window_ schedule.
+       *
+       * In block mode (the default), all processes iterate on a block of consecutive time steps
+       * until the last one has converged, before the end value is broadcast and the next block
+       * starts.
+       *
+       * With the sliding window, the time steps are distributed round-robin, i.e. step \\( n \\)
+       * belongs to process \\( n \\bmod P \\).
+       * A process whose step has converged (and all steps before it have) hands its end value on
+       * and starts its next step straight away, so that the window of \\( P \\) active steps moves
+       * forward without any collective communication.
+       *
+       * @param[in] sliding `true` for the sliding-window schedule
+       * @since v0.6.0
+       */
+      virtual void set_sliding_window(bool sliding);
+
+      /**
+       * Limit the number of time steps per block in block mode.
+       *
+       * Blocks shorter than the number of processes run on a sub-communicator of the first
+       * processes (see ICommunicator::sub_communicator()), while the remaining processes idle
+       * until the end value of the block is broadcast.
+       * Shorter blocks trade parallelism for less iterations, as each iteration only carries
+       * the start value one step further.
+       *
+       * @param[in] block_length maximal number of time steps per block; `0` (the default) or any
+       *   value larger than the number of processes uses the number of processes
+       * @since v0.6.0
+       */
+      virtual void set_block_length(size_t block_length);
+
     private:
       //! @{
       /**
@@ -56,10 +108,54 @@ namespace pfasst
        */
       LevelIter cycle_v(LevelIter level_iter);
 
+      /**
+       * @copydoc MLSDC::cycle()
+       */
+      LevelIter cycle(LevelIter level_iter, CycleShape shape);
+
+      /**
+       * One iteration: a cycle of the scheduled shape starting on the finest level.
+       *
+       * Levels visited more than once (see CycleShape) only send and receive on their first visit.
+       *
+       * @since v0.6.0
+       */
+      virtual void iterate();
+
       /**
        * Predictor: restrict initial down, preform coarse sweeps, return to finest.
+       *
+       * With the full multigrid start-up of the cycle schedule (see MLSDC::set_cycle_schedule()),
+       * each intermediate level does a V-cycle without communication on the way up.
+       *
+       * @note Since v0.6.0 the initial value is restricted with the transfer operator of the finer
+       *   of the two levels (`(l + 1).transfer()`), as in cycle_down() and in
+       *   MLSDC::predict_full_multigrid().
+       *   Before, the coarser level's operator was used, i.e. the one between the next two coarser
+       *   levels, and the finest level's operator was never used for the initial value.
+       *   This only makes a difference if the operators of the levels differ, e.g. if they convert
+       *   between the value types of mixed precision levels or are configured differently; the
+       *   transfer operator given with the coarsest level is not used by the predictor anymore.
+       *
+       * @param[in] ncoarse number of coarse time steps to sweep, starting from the initial value
+       *   of the finest level and ending with the current time step
+       */
+      virtual void predictor(size_t ncoarse);
+
+      /**
+       * Run one block of time steps, one per process of PFASST::comm.
+       *
+       * @param[in] block_start index of the first time step of the block
        */
-      virtual void predictor();
+      virtual void run_block(size_t block_start);
+
+      /**
+       * Run all @p nsteps time steps with the sliding-window schedule.
+       *
+       * @see set_sliding_window()
+       * @since v0.6.0
+       */
+      virtual void run_sliding(size_t nsteps);
       //! @}
 
       /**
@@ -80,8 +176,24 @@ namespace pfasst
        * @param[in] level_iter level iterator providing information to compute the communication tag
        */
       virtual int tag(LevelIter level_iter);
+
+      /**
+       * Generate a unique tag for the status messages of level iterator.
+       *
+       * Status tags are positive and below the tags of tag(), so they never match wtag().
+       *
+       * @param[in] level_iter level iterator providing information to compute the communication tag
+       */
       virtual int stag(LevelIter level_iter);
 
+      /**
+       * Tag of the messages handing on the start of the sliding window; `0`, which neither tag()
+       * nor stag() use.
+       *
+       * @since v0.6.0
+       */
+      virtual int wtag();
+
       /**
        * Post current status and values to next processor.
        */
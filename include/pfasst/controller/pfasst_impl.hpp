@@ -1,15 +1,34 @@
 #include "pfasst/controller/pfasst.hpp"
 
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
 #include "pfasst/logging.hpp"
 
 
 namespace pfasst
 {
+  template<typename time>
+  PFASST<time>::PFASST()
+    :   comm(nullptr)
+      , predict(false)
+      , block_length(0)
+      , sliding(false)
+      , first(false)
+      , newest(false)
+      , fine_converged(false)
+      , finished(false)
+      , window_start(0)
+      , ncycles(0)
+  {}
+
   template<typename time>
   void PFASST<time>::perform_sweeps(size_t level)
   {
     auto sweeper = this->get_level(level);
-    for (size_t s = 0; s < this->nsweeps[level]; s++) {
+    const size_t nsweeps = this->num_sweeps(level);
+    for (size_t s = 0; s < nsweeps; s++) {
       if (predict) {
         sweeper->predict(predict);
         sweeper->post_predict();
@@ -27,9 +46,30 @@ namespace pfasst
     this->comm = comm;
   }
 
+  template<typename time>
+  void PFASST<time>::set_sliding_window(bool sliding)
+  {
+    this->sliding = sliding;
+  }
+
+  template<typename time>
+  void PFASST<time>::set_block_length(size_t block_length)
+  {
+    this->block_length = block_length;
+  }
+
   /**
-   * @note Currently uses _block mode_ PFASST with the standard predictor
-   *   (see PFASST::predictor()).
+   * @note Uses _block mode_ PFASST with the standard predictor (see PFASST::predictor()) unless
+   *   the sliding window has been enabled (see PFASST::set_sliding_window()).
+   *
+   * The number of time steps does not need to be a multiple of the number of processes.
+   * A block with less steps than there are processes (the last one, or all of them if the block
+   * length is limited, see PFASST::set_block_length()) runs on a sub-communicator of the first
+   * processes (see ICommunicator::sub_communicator()) while the remaining processes idle and
+   * receive the end value of the block (see ISweeper::broadcast_end_state()).
+   *
+   * @throws NotImplementedYet on more than one process if a step size control is set (see
+   *   Controller::set_step_size_control())
    */
   template<typename time>
   void PFASST<time>::run()
@@ -39,48 +79,183 @@ namespace pfasst
       return;
     }
 
-    int nblocks = int(this->get_end_time() / this->get_step_size()) / comm->size();
+    if (this->get_step_size_control()) {
+      ML_CLOG(ERROR, "Controller", "adaptive step sizes are not supported by parallel PFASST");
+      throw NotImplementedYet("adaptive step sizes with PFASST");
+    }
+
+    const time duration = this->get_end_time() - this->get_time();
+    const size_t nsteps = size_t(std::round(duration / this->get_step_size()));
 
-    if (nblocks == 0) {
-      ML_CLOG(INFO, "Controller", "invalid duration: there are more time processors than time steps");
-      throw ValueError("invalid duration: there are more time processors than time steps");
+    if (nsteps == 0 || std::abs(time(nsteps) * this->get_step_size() - duration) > 1e-8 * duration) {
+      ML_CLOG(INFO, "Controller", "invalid duration: mismatch between step size and time interval");
+      throw ValueError("invalid duration: mismatch between step size and time interval");
     }
 
-    if (nblocks * comm->size() * this->get_step_size() < this->get_end_time()) {
-      ML_CLOG(INFO, "Controller", "invalid duration: mismatch between number of time processors and time steps");
-      throw ValueError("invalid duration: mismatch between number of time processors and time steps");
+    if (this->sliding) {
+      this->run_sliding(nsteps);
+      return;
     }
 
-    for (int nblock = 0; nblock < nblocks; nblock++) {
-      this->set_step(nblock * comm->size() + comm->rank());
+    ICommunicator* world = this->comm;
+    const size_t nprocs = world->size();
+    const size_t max_active = (this->block_length == 0) ? nprocs : min(nprocs, this->block_length);
 
-      predictor();
+    // the sub-communicator is kept as long as consecutive blocks have the same length
+    shared_ptr<ICommunicator> block_comm;
+    size_t block_comm_size = nprocs;
 
-      ML_CLOG(DEBUG, "Controller", "iterating on step " << this->get_step()
-                                   << " (0/" << this->get_max_iterations() << ")");
-      for (this->set_iteration(0);
-           this->get_iteration() < this->get_max_iterations() && this->comm->status->keep_iterating();
-           this->advance_iteration()) {
+    size_t nactive = 0;
+    for (size_t block_start = 0; block_start < nsteps; block_start += nactive) {
+      nactive = min(max_active, nsteps - block_start);
+      const bool last = (block_start + nactive == nsteps);
 
-        if (this->comm->status->previous_is_iterating()) {
-          post();
+      if (nactive == nprocs) {
+        this->run_block(block_start);
+      } else {
+        ML_CLOG(INFO, "Controller", "block of " << nactive << " steps runs on the first "
+                                    << nactive << " of " << nprocs << " processes");
+        if (block_comm_size != nactive) {
+          block_comm = world->sub_communicator(nactive);
+          block_comm_size = nactive;
+        }
+        if (block_comm) {
+          this->comm = block_comm.get();
+          this->run_block(block_start);
+          this->comm = world;
+        } else {
+          this->set_step(block_start + nactive - 1);
         }
-        cycle_v(this->finest());
-      }
-      ML_CLOG(DEBUG, "Controller", "done iterating on step " << this->get_step()
-                                   << " (" << this->get_iteration() << "/"
-                                   << this->get_max_iterations() << ")");
 
-      for (auto l = this->finest(); l >= this->coarsest(); --l) {
-        l.current()->post_step();
+        // hand the end value of the block to the idle processes
+        this->get_finest()->broadcast_end_state(world, nactive - 1);
       }
 
-      if (nblock < nblocks - 1) {
+      if (!last) {
+        // after a partial block, the last process holds the end value as well
         broadcast();
       }
+    }
+  }
+
+  template<typename time>
+  void PFASST<time>::run_block(size_t block_start)
+  {
+    this->set_step(block_start + comm->rank());
+
+    this->set_iteration(0);
+    predictor(comm->rank() + 1);
+
+    ML_CLOG(DEBUG, "Controller", "iterating on step " << this->get_step()
+                                 << " (0/" << this->get_max_iterations() << ")");
+    for (this->set_iteration(0);
+         this->get_iteration() < this->get_max_iterations() && this->comm->status->keep_iterating();
+         this->advance_iteration()) {
+
+      if (this->comm->status->previous_is_iterating()) {
+        post();
+      }
+      iterate();
+    }
+    ML_CLOG(DEBUG, "Controller", "done iterating on step " << this->get_step()
+                                 << " (" << this->get_iteration() << "/"
+                                 << this->get_max_iterations() << ")");
+
+    for (auto l = this->finest(); l >= this->coarsest(); --l) {
+      l.current()->post_step();
+    }
+
+    this->comm->status->clear();
+  }
+
+  /**
+   * The first window starts with the standard predictor.
+   * Afterwards, each iteration of a time step is one cycle, at the end of which the bottom of
+   * the cycle (see PFASST::cycle_bottom()) has told this process the first unfinished time step.
+   * A step is finished once all previous steps are finished and its finest level has converged
+   * (or the maximum number of iterations is reached).
+   * The newest step of the window passes the new start of the window on to the next process,
+   * which starts its next step if it has become part of the window.
+   * If the newest step has finished itself, the next step is the first unfinished one and also
+   * receives its initial value along with the window.
+   *
+   * The communicator is used as a ring (see ICommunicator::set_periodic()) for the duration of
+   * the run.
+   */
+  template<typename time>
+  void PFASST<time>::run_sliding(size_t nsteps)
+  {
+    const size_t nprocs = this->comm->size();
+    size_t step = this->comm->rank();
+
+    if (step < nsteps) {
+      this->comm->set_periodic(true);
+      this->ncycles = 0;
+      this->set_step(step);
+      this->first = (step == 0);
+      this->newest = (step + 1 == min(nprocs, nsteps));
+      this->set_iteration(0);
+      this->predictor(step + 1);
+
+      while (true) {
+        ML_CLOG(DEBUG, "Controller", "iterating on step " << step);
+        for (this->set_iteration(0); ; this->advance_iteration()) {
+          post();
+          if (this->get_iteration() == 0 && step >= nprocs) {
+            // newly started step: wait for the fine value of the previous step right away
+            if (!this->first) {
+              this->get_finest()->recv(comm, tag(this->finest()), false);
+            }
+            this->predictor(1);
+          }
+          iterate();
+          this->ncycles++;
+
+          if (this->newest) {
+            const size_t last = min(this->window_start + nprocs, nsteps) - 1;
+            if (last > step) {
+              this->comm->status->send_value(wtag(), int(this->window_start));
+              if (this->finished) {
+                // the next step starts right behind the window; it needs the final value of this one
+                this->get_finest()->send(comm, wtag(), true);
+              }
+              this->newest = false;
+            }
+          }
+          if (this->finished) {
+            break;
+          }
+          this->first = (this->window_start == step);
+        }
+        ML_CLOG(DEBUG, "Controller", "done iterating on step " << step
+                                     << " (" << this->get_iteration() << "/"
+                                     << this->get_max_iterations() << ")");
+
+        for (auto l = this->finest(); l >= this->coarsest(); --l) {
+          l.current()->post_step();
+        }
+
+        step += nprocs;
+        if (step >= nsteps) {
+          break;
+        }
+        this->set_step(step);
 
-      this->comm->status->clear();
+        this->window_start = size_t(this->comm->status->recv_value(wtag()));
+        this->newest = (step + 1 == min(this->window_start + nprocs, nsteps));
+        if (!this->newest) {
+          this->comm->status->send_value(wtag(), int(this->window_start));
+        }
+        this->first = (this->window_start == step);
+        if (this->first) {
+          this->get_finest()->recv(comm, wtag(), true);
+        }
+      }
+      this->comm->set_periodic(false);
     }
+
+    this->set_step(nsteps - 1);
+    this->get_finest()->broadcast_end_state(this->comm, (nsteps - 1) % nprocs);
   }
 
   template<typename time>
@@ -92,11 +267,19 @@ namespace pfasst
 
     perform_sweeps(l.level);
 
-    if (l == this->finest() && fine->converged()) {
-      this->comm->status->set_converged(true);
+    if (l == this->finest()) {
+      this->fine_converged = fine->converged();
+      if (this->fine_converged && !this->sliding) {
+        this->comm->status->set_converged(true);
+      }
     }
 
-    fine->send(comm, tag(l), false);
+    if (!this->sent[l.level]) {
+      if (!this->sliding || !this->newest) {
+        fine->send(comm, tag(l), false);
+      }
+      this->sent[l.level] = true;
+    }
     trns->restrict(crse, fine, true);
     trns->fas(this->get_step_size(), crse, fine);
     crse->save();
@@ -112,8 +295,11 @@ namespace pfasst
     auto trns = level_iter.transfer();
 
     trns->interpolate(fine, crse, true);
-    fine->recv(comm, tag(level_iter), false);
-    trns->interpolate_initial(fine, crse);
+    if (!this->received[level_iter.level]) {
+      fine->recv(comm, tag(level_iter), false);
+      trns->interpolate_initial(fine, crse);
+      this->received[level_iter.level] = true;
+    }
 
     if (level_iter < this->finest()) {
       perform_sweeps(level_iter.level);
@@ -127,6 +313,34 @@ namespace pfasst
   {
     auto crse = level_iter.current();
 
+    if (this->received[level_iter.level]) {
+      this->perform_sweeps(level_iter.level);
+      return level_iter + 1;
+    }
+    this->received[level_iter.level] = true;
+
+    if (this->sliding) {
+      // the previous process tells whether the steps before this one are finished
+      const size_t step = this->get_step();
+      if (!this->first) {
+        crse->recv(comm, tag(level_iter), true);
+      }
+      const size_t start = this->first
+                           ? step : size_t(this->comm->status->recv_value(stag(level_iter)));
+      this->perform_sweeps(level_iter.level);
+      if (!this->newest) {
+        crse->send(comm, tag(level_iter), true);
+      }
+      this->finished = (start == step)
+                       && (this->fine_converged
+                           || this->get_iteration() + 1 >= this->get_max_iterations());
+      this->window_start = this->finished ? step + 1 : start;
+      if (!this->newest) {
+        this->comm->status->send_value(stag(level_iter), int(this->window_start));
+      }
+      return level_iter + 1;
+    }
+
     if (this->comm->status->previous_is_iterating()) {
       crse->recv(comm, tag(level_iter), true);
     }
@@ -140,27 +354,54 @@ namespace pfasst
 
   template<typename time>
   typename PFASST<time>::LevelIter PFASST<time>::cycle_v(typename PFASST<time>::LevelIter level_iter)
+  {
+    return cycle(level_iter, CycleShape::V);
+  }
+
+  template<typename time>
+  typename PFASST<time>::LevelIter PFASST<time>::cycle(typename PFASST<time>::LevelIter level_iter,
+                                                       CycleShape shape)
   {
     if (level_iter.level == 0) {
       level_iter = cycle_bottom(level_iter);
     } else {
-      level_iter = cycle_down(level_iter);
-      level_iter = cycle_v(level_iter);
+      auto crse_iter = cycle_down(level_iter);
+      switch (shape) {
+        case CycleShape::W:
+          cycle(crse_iter, CycleShape::W);
+          cycle(crse_iter, CycleShape::W);
+          break;
+        case CycleShape::F:
+          cycle(crse_iter, CycleShape::F);
+          cycle(crse_iter, CycleShape::V);
+          break;
+        default:
+          cycle(crse_iter, CycleShape::V);
+      }
       level_iter = cycle_up(level_iter);
     }
     return level_iter;
   }
 
   template<typename time>
-  void PFASST<time>::predictor()
+  void PFASST<time>::iterate()
+  {
+    this->sent.assign(this->nlevels(), false);
+    this->received.assign(this->nlevels(), false);
+    cycle(this->finest(), this->cycle_shape());
+  }
+
+  template<typename time>
+  void PFASST<time>::predictor(size_t ncoarse)
   {
     this->get_finest()->spread();
 
     // restrict fine initial condition
+    //  (the transfer operator between two levels is the one of the finer level, as in cycle_down)
     for (auto l = this->finest() - 1; l >= this->coarsest(); --l) {
       auto crse = l.current();
       auto fine = l.fine();
-      auto trns = l.transfer();
+      auto trns = (l + 1).transfer();
       trns->restrict_initial(crse, fine);
       crse->spread();
       crse->save();
@@ -169,15 +410,18 @@ namespace pfasst
     // perform sweeps on the coarse level based on rank
     predict = true;
     auto crse = this->coarsest().current();
-    for (int nstep = 0; nstep < comm->rank() + 1; nstep++) {
+    for (size_t nstep = 0; nstep < ncoarse; nstep++) {
       // XXX: set iteration and step?
       perform_sweeps(0);
-      if (nstep < comm->rank()) {
+      if (nstep + 1 < ncoarse) {
         crse->advance();
       }
     }
 
-    // return to finest level, sweeping as we go
+    // return to finest level, sweeping (or cycling without communication) as we go
+    const bool full_multigrid = this->schedule && this->schedule->get_full_multigrid();
+    this->sent.assign(this->nlevels(), true);
+    this->received.assign(this->nlevels(), true);
     for (auto l = this->coarsest() + 1; l <= this->finest(); ++l) {
       auto crse = l.coarse();
       auto fine = l.current();
@@ -185,7 +429,11 @@ namespace pfasst
 
       trns->interpolate(fine, crse, true);
       if (l < this->finest()) {
-        perform_sweeps(l.level);
+        if (full_multigrid) {
+          cycle(l, CycleShape::V);
+        } else {
+          perform_sweeps(l.level);
+        }
       }
     }
   }
@@ -199,19 +447,28 @@ namespace pfasst
   template<typename time>
   int PFASST<time>::tag(LevelIter level_iter)
   {
-    return (level_iter.level+1) * 10000 + this->get_iteration();
+    const size_t index = this->sliding ? this->ncycles % 1000 : this->get_iteration();
+    return (level_iter.level+1) * 10000 + index;
   }
 
   template<typename time>
   int PFASST<time>::stag(LevelIter level_iter)
   {
-    return level_iter.level * 1000 + this->get_iteration();
+    const size_t index = this->sliding ? this->ncycles % 1000 : this->get_iteration();
+    return level_iter.level * 1000 + index + 1;
+  }
+
+  template<typename time>
+  int PFASST<time>::wtag()
+  {
+    // stag() starts at 1 and tag() at 10000, thus 0 is left to the window messages
+    return 0;
   }
 
   template<typename time>
   void PFASST<time>::post()
   {
-    if (this->comm->status->previous_is_iterating()) {
+    if (this->sliding ? !this->first : this->comm->status->previous_is_iterating()) {
       this->comm->status->post(0);
       for (auto l = this->coarsest() + 1; l <= this->finest(); ++l) {
         l.current()->post(comm, tag(l));
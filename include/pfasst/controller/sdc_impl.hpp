@@ -17,13 +17,22 @@ namespace pfasst
    * the ISweeper::post_step() hook is triggered followed by ISweeper::advance() to complete the
    * time step and advance to the next via Controller::advance_time() until Controller::get_time()
    * is equal or greater Controller::get_end_time().
+   *
+   * With a step size control (see Controller::set_step_size_control()), the local error is
+   * estimated via ISweeper::estimate_error() once the iterations on the time step are done.
+   * A rejected time step is repeated with the reduced step size right away; ISweeper::post_step()
+   * and ISweeper::advance() are only called for accepted steps.
    */
   template<typename time>
   void SDC<time>::run()
   {
     auto sweeper = this->get_level(0);
+    const bool adaptive = bool(this->step_control);
+    if (adaptive) {
+      this->set_step_size(this->clip_step_size(this->get_step_size()));
+    }
 
-    for (; this->get_time() < this->get_end_time(); this->advance_time()) {
+    while (this->get_time() < this->get_end_time()) {
       bool initial = this->get_step() == 0;
       for (this->set_iteration(0);
            this->get_iteration() < this->get_max_iterations();
@@ -40,10 +49,17 @@ namespace pfasst
           break;
         }
       }
+      if (adaptive) {
+        this->error_estimate = sweeper->estimate_error();
+        if (!this->adapt_step_size()) {
+          continue;
+        }
+      }
       sweeper->post_step();
       if (this->get_time() + this->get_step_size() < this->get_end_time()) {
         sweeper->advance();
       }
+      this->advance_time();
     }
   }
 }  // ::pfasst
@@ -0,0 +1,121 @@
+/**
+ * @file controller/step_size_control.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__CONTROLLER__STEP_SIZE_CONTROL_HPP_
+#define _PFASST__CONTROLLER__STEP_SIZE_CONTROL_HPP_
+
+#include <cstddef>
+using namespace std;
+
+#include "pfasst/interfaces.hpp"
+
+
+namespace pfasst
+{
+  /**
+   * PI controller for adaptive step sizes.
+   *
+   * After each time step, the local error estimate \\( e_n \\) of the finest sweeper (see
+   * ISweeper::estimate_error()) decides whether the step is accepted (\\( e_n \\leq tol \\)) or
+   * repeated, and the next step size is chosen as
+   * \\[
+   * \\Delta t_{n+1} = \\Delta t_n \\cdot s \\left( \\frac{tol}{e_n} \\right)^{k_I / (p+1)}
+   *   \\left( \\frac{e_{n-1}}{tol} \\right)^{k_P / (p+1)}
+   * \\]
+   * with the safety factor \\( s \\), the order \\( p \\) of the error estimate and the error
+   * \\( e_{n-1} \\) of the previously accepted step.
+   * The proportional term is dropped after rejections and for the first step, and the factor is
+   * limited to \\( [f_{\\min}, f_{\\max}] \\) (\\( f_{\\max} = 1 \\) after a rejection).
+   *
+   * @tparam time time precision; defaults to pfasst::time_precision
+   * @since v0.6.0
+   * @ingroup Controllers
+   */
+  template<typename time = time_precision>
+  class StepSizeControl
+  {
+    protected:
+      //! @{
+      time tol;
+      size_t order;
+      time dt_min, dt_max;
+      time safety;
+      time fac_min, fac_max;
+      time k_i, k_p;
+      //! @}
+
+      //! @{
+      //! Error of the last accepted step; negative before the first one.
+      time prev_error;
+
+      size_t num_accepted, num_rejected;
+      //! @}
+
+    public:
+      //! @{
+      /**
+       * @param[in] tol tolerance of the local error estimate
+       * @param[in] order order \\( p \\) of the error estimate, i.e. the estimated local error
+       *   behaves like \\( \\Delta t^{p+1} \\)
+       * @param[in] dt_min smallest step size; steps of this size are always accepted
+       * @param[in] dt_max largest step size
+       */
+      StepSizeControl(time tol, size_t order, time dt_min = 0.0, time dt_max = 0.0);
+      virtual ~StepSizeControl() = default;
+      //! @}
+
+      //! @{
+      /**
+       * Sets the safety factor \\( s \\); defaults to `0.9`.
+       */
+      virtual void set_safety(time safety);
+
+      /**
+       * Limits the change of the step size to \\( [f_{\\min}, f_{\\max}] \\); defaults to
+       * \\( [0.2, 5] \\).
+       */
+      virtual void set_limits(time fac_min, time fac_max);
+
+      /**
+       * Sets the gains \\( k_I \\) and \\( k_P \\); defaults to `0.7` and `0.4`.
+       *
+       * \\( k_I = 1, k_P = 0 \\) gives the classical (integral) controller.
+       */
+      virtual void set_gains(time k_i, time k_p);
+      //! @}
+
+      //! @{
+      /**
+       * Whether a step of size @p dt with estimated error @p error is accepted.
+       *
+       * Steps without an error estimate (negative @p error) and steps of the minimal size are
+       * always accepted.
+       */
+      virtual bool accept(time dt, time error) const;
+
+      /**
+       * Size of the next step (or of the repeated step if not @p accepted).
+       *
+       * Also updates the counters and the error history.
+       *
+       * @param[in] dt size of the current step
+       * @param[in] error estimated local error of the current step
+       * @param[in] accepted whether the current step has been accepted
+       */
+      virtual time propose(time dt, time error, bool accepted);
+
+      /**
+       * Clears the error history and the counters.
+       */
+      virtual void reset();
+
+      virtual size_t get_num_accepted() const;
+      virtual size_t get_num_rejected() const;
+      //! @}
+  };
+}  // ::pfasst
+
+#include "pfasst/controller/step_size_control_impl.hpp"
+
+#endif  // _PFASST__CONTROLLER__STEP_SIZE_CONTROL_HPP_
@@ -0,0 +1,102 @@
+#include "pfasst/controller/step_size_control.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+using namespace std;
+
+
+namespace pfasst
+{
+  template<typename time>
+  StepSizeControl<time>::StepSizeControl(time tol, size_t order, time dt_min, time dt_max)
+    :   tol(tol)
+      , order(order)
+      , dt_min(dt_min)
+      , dt_max(dt_max > time(0.0) ? dt_max : numeric_limits<time>::max())
+      , safety(0.9)
+      , fac_min(0.2)
+      , fac_max(5.0)
+      , k_i(0.7)
+      , k_p(0.4)
+  {
+    if (tol <= time(0.0)) {
+      throw ValueError("tolerance of the step size control must be positive");
+    }
+    this->reset();
+  }
+
+  template<typename time>
+  void StepSizeControl<time>::set_safety(time safety)
+  {
+    this->safety = safety;
+  }
+
+  template<typename time>
+  void StepSizeControl<time>::set_limits(time fac_min, time fac_max)
+  {
+    this->fac_min = fac_min;
+    this->fac_max = fac_max;
+  }
+
+  template<typename time>
+  void StepSizeControl<time>::set_gains(time k_i, time k_p)
+  {
+    this->k_i = k_i;
+    this->k_p = k_p;
+  }
+
+  template<typename time>
+  bool StepSizeControl<time>::accept(time dt, time error) const
+  {
+    return error <= this->tol || error < time(0.0) || dt <= this->dt_min;
+  }
+
+  template<typename time>
+  time StepSizeControl<time>::propose(time dt, time error, bool accepted)
+  {
+    if (accepted) {
+      this->num_accepted++;
+    } else {
+      this->num_rejected++;
+    }
+
+    if (error < time(0.0)) {
+      // no estimate, keep the step size
+      return max(this->dt_min, min(this->dt_max, dt));
+    }
+
+    const time p1 = time(this->order + 1);
+    const time err = max(error, numeric_limits<time>::min());
+    time fac = this->safety * pow(this->tol / err, this->k_i / p1);
+    if (accepted && this->prev_error > time(0.0)) {
+      fac *= pow(this->prev_error / this->tol, this->k_p / p1);
+    }
+    fac = max(this->fac_min, min(accepted ? this->fac_max : time(1.0), fac));
+
+    if (accepted) {
+      this->prev_error = err;
+    }
+    return max(this->dt_min, min(this->dt_max, dt * fac));
+  }
+
+  template<typename time>
+  void StepSizeControl<time>::reset()
+  {
+    this->prev_error = -1.0;
+    this->num_accepted = 0;
+    this->num_rejected = 0;
+  }
+
+  template<typename time>
+  size_t StepSizeControl<time>::get_num_accepted() const
+  {
+    return this->num_accepted;
+  }
+
+  template<typename time>
+  size_t StepSizeControl<time>::get_num_rejected() const
+  {
+    return this->num_rejected;
+  }
+}  // ::pfasst
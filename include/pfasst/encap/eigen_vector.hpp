@@ -0,0 +1,190 @@
+/**
+ * @file pfasst/encap/eigen_vector.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__ENCAP__EIGEN_VECTOR_HPP_
+#define _PFASST__ENCAP__EIGEN_VECTOR_HPP_
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include <Eigen/Dense>
+
+#ifdef WITH_MPI
+#include "pfasst/encap/mpi_buffer.hpp"
+#endif
+
+#include "pfasst/encap/encapsulation.hpp"
+#include "pfasst/encap/kernels.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    /**
+     * Encapsulation storing its values in an Eigen column vector.
+     *
+     * The values live in a single buffer aligned for Eigen's vectorized code paths and all
+     * arithmetic (saxpy(), mat_apply(), the norms) is expressed as Eigen expressions, i.e. a
+     * single vectorized pass per destination and source without any temporaries.
+     * Being an `Eigen::Matrix` itself, the values may be used directly in Eigen expressions in
+     * user code (e.g. `u = v + dt * f`).
+     *
+     * @note Inside this class, the name `Matrix` refers to `Eigen::Matrix`; the dense row-major
+     *   matrices of PFASST++ are spelled `::Matrix<time>`.
+     *
+     * @tparam scalar precision and numerical type of the data values
+     * @tparam time   precision of the time points; defaults to pfasst::time_precision
+     * @since v0.6.0
+     */
+    template<typename scalar, typename time = time_precision>
+    class EigenVectorEncapsulation
+      : public Eigen::Matrix<scalar, Eigen::Dynamic, 1>,
+        public Encapsulation<time>
+#ifdef WITH_MPI
+      , public MPIBuffer
+#endif
+    {
+      public:
+        typedef Eigen::Matrix<scalar, Eigen::Dynamic, 1> base_type;
+        //! type of the coefficients multiplied onto the values
+        typedef kernels::coeff_type<scalar, time> coeff_type;
+
+        //! @{
+        EigenVectorEncapsulation(const size_t size);
+        EigenVectorEncapsulation(const EigenVectorEncapsulation<scalar, time>& other);
+
+        /**
+         * Evaluates an arbitrary Eigen expression into a new encapsulation.
+         */
+        template<typename OtherDerived>
+        EigenVectorEncapsulation(const Eigen::MatrixBase<OtherDerived>& other)
+          : base_type(other)
+        {}
+
+        virtual ~EigenVectorEncapsulation();
+        //! @}
+
+        //! @{
+        EigenVectorEncapsulation<scalar, time>&
+        operator=(const EigenVectorEncapsulation<scalar, time>& other);
+
+        /**
+         * Evaluates an arbitrary Eigen expression into this encapsulation.
+         */
+        template<typename OtherDerived>
+        EigenVectorEncapsulation<scalar, time>& operator=(const Eigen::MatrixBase<OtherDerived>& other)
+        {
+          this->base_type::operator=(other);
+          return *this;
+        }
+        //! @}
+
+        //! @{
+        virtual void zero() override;
+        virtual void copy(shared_ptr<const Encapsulation<time>> x) override;
+
+        using base_type::swap;
+
+        /**
+         * Exchanges the buffers with @p x in constant time.
+         *
+         * @note With MPI enabled, open send requests on both vectors are completed first.
+         */
+        virtual void swap(shared_ptr<Encapsulation<time>> x) override;
+
+        /**
+         * Takes over the buffer of @p x in constant time (see swap()).
+         */
+        virtual void move_from(shared_ptr<Encapsulation<time>> x) override;
+        //! @}
+
+        //! @{
+        virtual void saxpy(time a, shared_ptr<const Encapsulation<time>> x) override;
+
+        /**
+         * Accumulates \\( dst_n = [dst_n +] \\sum_m a M_{n,m} src_m \\) for all destinations at once.
+         *
+         * Each destination is updated in place by one scaled Eigen expression per source, i.e.
+         * no gather block or destination temporary is allocated.
+         *
+         * @note All elements of @p dst and @p src must be EigenVectorEncapsulation of the same
+         *   size; the sizes are only checked in debug builds.
+         *   No destination must be one of the sources.
+         */
+        virtual void mat_apply(const vector<shared_ptr<Encapsulation<time>>>& dst,
+                               time a, const ::Matrix<time>& mat,
+                               const vector<shared_ptr<Encapsulation<time>>>& src,
+                               bool zero = true) override;
+
+        /**
+         * Maximum norm of contained elements.
+         *
+         * Same as `norm(max_norm)`.
+         */
+        virtual time norm0() const override;
+
+        using base_type::norm;
+
+        /**
+         * Supports all pfasst::encap::NormType using Eigen's reductions.
+         */
+        virtual time norm(NormType type) const override;
+
+        using base_type::dot;
+
+        /**
+         * Inner product using Eigen's vectorized `dot()`.
+         */
+        virtual time dot(shared_ptr<const Encapsulation<time>> x) const override;
+        //! @}
+
+#ifdef WITH_MPI
+        //! @{
+        /**
+         * @note Communication works on the raw aligned buffer (`data()`) without intermediate
+         *   copies.
+         */
+        virtual void post(ICommunicator* comm, int tag) override;
+        virtual void recv(ICommunicator* comm, int tag, bool blocking) override;
+        virtual void send(ICommunicator* comm, int tag, bool blocking) override;
+        virtual void broadcast(ICommunicator* comm) override;
+        virtual void broadcast(ICommunicator* comm, int root) override;
+        //! @}
+#endif
+    };
+
+
+    /**
+     * Factory creating EigenVectorEncapsulation of a fixed size.
+     *
+     * @tparam scalar precision and numerical type of the data values
+     * @tparam time   precision of the time points; defaults to pfasst::time_precision
+     * @since v0.6.0
+     */
+    template<typename scalar, typename time = time_precision>
+    class EigenFactory
+      : public EncapFactory<time>
+    {
+      protected:
+        size_t size;
+
+      public:
+        EigenFactory(const size_t size);
+        virtual shared_ptr<Encapsulation<time>> create(const EncapType) override;
+        size_t dofs() const;
+    };
+
+    template<typename scalar, typename time = time_precision>
+    EigenVectorEncapsulation<scalar, time>& as_eigen_vector(shared_ptr<Encapsulation<time>> x);
+
+    template<typename scalar, typename time = time_precision>
+    const EigenVectorEncapsulation<scalar, time>& as_eigen_vector(shared_ptr<const Encapsulation<time>> x);
+  }  // ::pfasst::encap
+}  // ::pfasst
+
+#include "pfasst/encap/eigen_vector_impl.hpp"
+
+#endif  // _PFASST__ENCAP__EIGEN_VECTOR_HPP_
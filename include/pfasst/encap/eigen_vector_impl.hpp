@@ -0,0 +1,218 @@
+#include "pfasst/encap/eigen_vector.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+using namespace std;
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    template<typename scalar, typename time>
+    EigenVectorEncapsulation<scalar, time>::EigenVectorEncapsulation(const size_t size)
+      : base_type(base_type::Zero(size))
+    {}
+
+    template<typename scalar, typename time>
+    EigenVectorEncapsulation<scalar, time>::EigenVectorEncapsulation(const EigenVectorEncapsulation<scalar, time>& other)
+      : base_type(other)
+    {}
+
+    template<typename scalar, typename time>
+    EigenVectorEncapsulation<scalar, time>::~EigenVectorEncapsulation()
+    {
+#ifdef WITH_MPI
+      this->wait_send();
+      assert(this->recv_request == MPI_REQUEST_NULL);
+      assert(this->send_request == MPI_REQUEST_NULL);
+#endif
+    }
+
+    template<typename scalar, typename time>
+    EigenVectorEncapsulation<scalar, time>&
+    EigenVectorEncapsulation<scalar, time>::operator=(const EigenVectorEncapsulation<scalar, time>& other)
+    {
+      this->base_type::operator=(other);
+      return *this;
+    }
+
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::zero()
+    {
+      this->setZero();
+    }
+
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::copy(shared_ptr<const Encapsulation<time>> x)
+    {
+      auto& x_cast = encap_cast<EigenVectorEncapsulation<scalar, time>>(*x);
+      assert(this->size() == x_cast.size());
+      this->base_type::operator=(x_cast);
+    }
+
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::swap(shared_ptr<Encapsulation<time>> x)
+    {
+      auto& x_cast = encap_cast<EigenVectorEncapsulation<scalar, time>>(*x);
+      assert(this->size() == x_cast.size());
+
+#ifdef WITH_MPI
+      // buffers of pending sends must stay with their requests
+      for (auto v : { this, &x_cast }) {
+        assert(v->recv_request == MPI_REQUEST_NULL);
+        v->wait_send();
+      }
+#endif
+      this->base_type::swap(static_cast<base_type&>(x_cast));
+    }
+
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::move_from(shared_ptr<Encapsulation<time>> x)
+    {
+      this->swap(x);
+    }
+
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::saxpy(time a, shared_ptr<const Encapsulation<time>> x)
+    {
+      auto& x_cast = encap_cast<EigenVectorEncapsulation<scalar, time>>(*x);
+      assert(this->size() == x_cast.size());
+      *this += coeff_type(a) * x_cast;
+    }
+
+    template<typename scalar, typename time>
+    void
+    EigenVectorEncapsulation<scalar, time>::mat_apply(const vector<shared_ptr<Encapsulation<time>>>& dst,
+                                                      time a, const ::Matrix<time>& mat,
+                                                      const vector<shared_ptr<Encapsulation<time>>>& src,
+                                                      bool zero)
+    {
+      typedef EigenVectorEncapsulation<scalar, time> EigenT;
+
+      const size_t ndst = dst.size();
+      const size_t nsrc = src.size();
+      assert(size_t(mat.rows()) >= ndst && size_t(mat.cols()) >= nsrc);
+
+      for (size_t n = 0; n < ndst; n++) {
+        auto& d = encap_cast<EigenT>(*dst[n]);
+        if (zero) {
+          d.setZero();
+        }
+        // accumulate in place; the scaled sources are lazy expressions, so no temporary is
+        // allocated
+        for (size_t m = 0; m < nsrc; m++) {
+          auto& s = encap_cast<EigenT>(*src[m]);
+          assert(s.size() == d.size());
+          d += coeff_type(a * mat(n, m)) * s;
+        }
+      }
+    }
+
+    template<typename scalar, typename time>
+    time EigenVectorEncapsulation<scalar, time>::norm0() const
+    {
+      return this->norm(max_norm);
+    }
+
+    template<typename scalar, typename time>
+    time EigenVectorEncapsulation<scalar, time>::norm(NormType type) const
+    {
+      if (this->size() == 0) {
+        return time(0.0);
+      }
+
+      switch (type) {
+        case max_norm:
+#if EIGEN_VERSION_AT_LEAST(3, 3, 90)
+          return time(this->cwiseAbs().template maxCoeff<Eigen::PropagateNaN>());
+#else
+          // the maximum coefficient is unspecified for NaN values
+          return this->hasNaN() ? numeric_limits<time>::quiet_NaN()
+                                : time(this->template lpNorm<Eigen::Infinity>());
+#endif
+        case l1_norm:
+          return time(this->template lpNorm<1>());
+        case l2_norm:
+          return time(this->base_type::norm());
+        case rms_norm:
+          return std::sqrt(time(this->squaredNorm()) / time(this->size()));
+        default:
+          throw ValueError("unknown norm type");
+      }
+    }
+
+    template<typename scalar, typename time>
+    time EigenVectorEncapsulation<scalar, time>::dot(shared_ptr<const Encapsulation<time>> x) const
+    {
+      auto& x_cast = encap_cast<EigenVectorEncapsulation<scalar, time>>(*x);
+      assert(this->size() == x_cast.size());
+      // Eigen conjugates the first argument
+      return time(std::real(x_cast.base_type::dot(*this)));
+    }
+
+
+    template<typename scalar, typename time>
+    EigenFactory<scalar, time>::EigenFactory(const size_t size)
+      : size(size)
+    {}
+
+    template<typename scalar, typename time>
+    size_t EigenFactory<scalar, time>::dofs() const
+    {
+      return this->size;
+    }
+
+    template<typename scalar, typename time>
+    shared_ptr<Encapsulation<time>> EigenFactory<scalar, time>::create(const EncapType)
+    {
+      return make_shared<EigenVectorEncapsulation<scalar, time>>(this->dofs());
+    }
+
+
+    template<typename scalar, typename time>
+    EigenVectorEncapsulation<scalar, time>& as_eigen_vector(shared_ptr<Encapsulation<time>> x)
+    {
+      return encap_cast<EigenVectorEncapsulation<scalar, time>>(*x);
+    }
+
+    template<typename scalar, typename time>
+    const EigenVectorEncapsulation<scalar, time>& as_eigen_vector(shared_ptr<const Encapsulation<time>> x)
+    {
+      return encap_cast<EigenVectorEncapsulation<scalar, time>>(*x);
+    }
+
+#ifdef WITH_MPI
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::post(ICommunicator* comm, int tag)
+    {
+      this->post_buffer(comm, tag, this->data(), sizeof(scalar) * this->size());
+    }
+
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::recv(ICommunicator* comm, int tag, bool blocking)
+    {
+      this->recv_buffer(comm, tag, blocking, this->data(), sizeof(scalar) * this->size());
+    }
+
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::send(ICommunicator* comm, int tag, bool blocking)
+    {
+      this->send_buffer(comm, tag, blocking, this->data(), sizeof(scalar) * this->size());
+    }
+
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::broadcast(ICommunicator* comm)
+    {
+      this->broadcast(comm, comm->size() - 1);
+    }
+
+    template<typename scalar, typename time>
+    void EigenVectorEncapsulation<scalar, time>::broadcast(ICommunicator* comm, int root)
+    {
+      this->broadcast_buffer(comm, root, this->data(), sizeof(scalar) * this->size());
+    }
+#endif
+  }  // ::pfasst::encap
+}  // ::pfasst
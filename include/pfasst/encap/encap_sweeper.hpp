@@ -12,6 +12,7 @@ using namespace std;
 #include "pfasst/interfaces.hpp"
 #include "pfasst/quadrature.hpp"
 #include "pfasst/encap/encapsulation.hpp"
+#include "pfasst/encap/inexact_solve.hpp"
 
 
 namespace pfasst
@@ -20,6 +21,16 @@ namespace pfasst
   {
     using namespace pfasst::quadrature;
 
+    /**
+     * Local error estimates of EncapSweeper::estimate_error().
+     *
+     * @since v0.6.0
+     */
+    enum class ErrorEstimate : int {
+        Embedded = 0  //!< difference to the quadrature rule without the last node
+      , Iterates = 1  //!< difference of the end values of the last two iterations
+    };
+
     /**
      * Base encapsulated sweeper.
      *
@@ -50,6 +61,34 @@ namespace pfasst
          * `residuals.size() == quadrature->get_num_nodes()`.
          */
         vector<shared_ptr<Encapsulation<time>>> residuals;
+
+        //! Whether #residuals hold the residuals of the current values (see get_current_residuals()).
+        bool residuals_valid;
+
+        //! Step and iteration of the controller #residuals were computed in.
+        size_t residuals_step, residuals_iteration;
+
+        /**
+         * '0 to node' integrals \\( \\Delta t Q F \\) of the current function values.
+         *
+         * Computed on demand by get_q_integrals() and shared by the residual and the next sweep,
+         * which derives its 'node to node' integrals from these if still valid.
+         */
+        mutable vector<shared_ptr<Encapsulation<time>>> q_integrals;
+
+        //! Whether #q_integrals are the integrals of the current function values.
+        mutable bool q_integrals_valid;
+
+        //! Width of the time interval #q_integrals were computed for.
+        mutable time q_integrals_dt;
+
+        /**
+         * Matrix mapping \\( [U_0, U, \\Delta t Q F, \\tau] \\) onto the residuals.
+         *
+         * Built on the first call of residual() after setup(); the cumulative sums of the
+         * 'node to node' FAS corrections are part of it.
+         */
+        mutable Matrix<time> residual_mat;
         //! @}
 
         //! @{
@@ -69,6 +108,23 @@ namespace pfasst
          */
         vector<shared_ptr<Encapsulation<time>>> saved_state;
 
+        /**
+         * Function values of all time nodes at the time of the last save(), one block per element
+         * of get_function_values().
+         *
+         * Only kept if enabled by set_save_function_values().
+         */
+        vector<vector<shared_ptr<Encapsulation<time>>>> saved_function_values;
+
+        //! Whether save() keeps the function values.
+        bool save_function_values;
+
+        //! Whether #saved_function_values belong to the saved solution values.
+        bool saved_function_values_valid;
+
+        //! Whether spread() overwrote the solution values since the function values last changed.
+        bool state_spread;
+
         /**
          * FAS corrections \\( \\tau \\) at all time nodes of the current iteration.
          *
@@ -76,9 +132,74 @@ namespace pfasst
          * `fas_corrections.size() == quadrature->get_num_nodes()`.
          */
         vector<shared_ptr<Encapsulation<time>>> fas_corrections;
+
+        //! @}
+
+        //! @{
+        /**
+         * '0 to node' integrals of the current function values over an interval of width @p dt.
+         *
+         * Calls integrate() unless the integrals of the same function values and interval width
+         * are still available from a previous call.
+         */
+        const vector<shared_ptr<Encapsulation<time>>>& get_q_integrals(time dt) const;
+
+        /**
+         * Whether get_q_integrals() can return the integrals over an interval of width @p dt
+         * without computing them.
+         */
+        bool has_q_integrals(time dt) const;
         //! @}
 
         //! @{
+        //! State of the SDC iteration handed to the implicit solves (see get_solver_context()).
+        SolverContext<time> solver_context;
+
+        //! Counters of the implicit solves (see record_solve()).
+        SolverStatistics<time> solver_stats;
+
+        //! Policy for the tolerances of the implicit solves; `nullptr` for fixed tolerances.
+        shared_ptr<InexactSolvePolicy<time>> solve_policy;
+
+        //! Initial guess stored in the solution values before the implicit solves.
+        InitialGuess initial_guess;
+
+        /**
+         * Prepares #solver_context for the implicit solves of a prediction or sweep.
+         *
+         * To be called by sweepers before their first call to `impl_solve()` in predict() and
+         * sweep().
+         * If the policy asks for it, the residuals of the current iterate are computed unless still
+         * available (e.g. from the convergence check of the previous iteration); their integrals are
+         * shared with the following sweep (see get_q_integrals()).
+         * For ErrorEstimate::Iterates, the end value before a sweep is kept for estimate_error().
+         *
+         * @param[in] predict whether the solves belong to the predictor
+         */
+        virtual void begin_solves(bool predict);
+
+        /**
+         * Stores the initial guess of the implicit solve for node @p m in its solution value.
+         *
+         * To be called by sequential sweepers right before `impl_solve()`; the values of the nodes
+         * before @p m must be the ones of the current sweep.
+         * In the predictor, there is no previous iterate and InitialGuess::PreviousIterate uses the
+         * value at the previous node instead.
+         *
+         * @param[in] m index of the node to solve for
+         * @param[in] rhs right hand side of the implicit system
+         * @param[in] predict whether the solve belongs to the predictor
+         */
+        virtual void store_initial_guess(size_t m, shared_ptr<const Encapsulation<time>> rhs,
+                                         bool predict);
+        //! @}
+
+        //! @{
+        /**
+         * Norm used for the residuals in converged().
+         *
+         * One of the values of pfasst::encap::NormType; defaults to the maximum norm.
+         */
         int residual_norm_order;
 
         /**
@@ -97,6 +218,31 @@ namespace pfasst
         time rel_residual_tol;
         //! @}
 
+        //! @{
+        //! Local error estimate returned by estimate_error().
+        ErrorEstimate error_estimate_type;
+
+        /**
+         * Weights \\( b_j - \\hat{b}_j \\) of the embedded error estimate.
+         *
+         * \\( \\hat{b} \\) are the weights of the quadrature rule on all but the last node; built
+         * on first use.
+         */
+        Matrix<time> embedded_weights;
+
+        //! End value before the latest sweep for ErrorEstimate::Iterates; see begin_solves().
+        shared_ptr<Encapsulation<time>> previous_end_state;
+
+        //! Whether #previous_end_state is usable.
+        bool previous_end_valid;
+
+        //! Step of the controller #previous_end_state was recorded in.
+        size_t previous_end_step;
+
+        //! Scratch value of estimate_error(); created on first use.
+        shared_ptr<Encapsulation<time>> error_scratch;
+        //! @}
+
       public:
         EncapSweeper();
 
@@ -133,20 +279,69 @@ namespace pfasst
         //! @{
         /**
          * @copybrief ISweeper::spread()
+         *
+         * If the left end point is a node, the initial value is taken from the start state, which
+         * may have been replaced since (e.g. by ITransfer::restrict_initial()).
          */
         virtual void spread() override;
 
         /**
          * @copybrief ISweeper::save()
+         *
+         * The function values are saved as well if enabled by set_save_function_values().
+         * They are only considered valid if the solution values have not been spread() since the
+         * function values last changed, as they would not match the solution values otherwise.
          */
         virtual void save(bool initial_only) override;
+
+        /**
+         * Function values at all time nodes of the current iteration.
+         *
+         * Returns one block per part of the right hand side (e.g. the explicit and the implicit
+         * part of an IMEX sweeper), each with one element per time node.
+         * The default returns no blocks, i.e. the function values are unknown to the transfer
+         * operators.
+         *
+         * @since v0.6.0
+         */
+        virtual vector<vector<shared_ptr<Encapsulation<time>>>> get_function_values() const;
+
+        /**
+         * Whether save() keeps copies of the function values.
+         *
+         * Required by transfer operators interpolating function values (see
+         * pfasst::encap::PolyInterpMixin::set_interpolate_function_values()); disabled by
+         * default.
+         *
+         * @since v0.6.0
+         */
+        virtual void set_save_function_values(bool save);
+
+        /**
+         * Whether the function values of the last save() are available.
+         *
+         * They are not after the solution values have been spread, predicted or advanced to the
+         * next time step since.
+         *
+         * @since v0.6.0
+         */
+        virtual bool has_saved_function_values() const;
+
+        /**
+         * Function values at the time of the last save(), in the layout of get_function_values().
+         *
+         * Only meaningful if has_saved_function_values().
+         *
+         * @since v0.6.0
+         */
+        virtual const vector<vector<shared_ptr<Encapsulation<time>>>>& get_saved_function_values() const;
         //! @}
 
         //! @{
         virtual void set_quadrature(shared_ptr<IQuadrature<time>> quadrature);
         virtual shared_ptr<const IQuadrature<time>> get_quadrature() const;
 
-        virtual const vector<time> get_nodes() const;
+        virtual const vector<time>& get_nodes() const;
 
         virtual void set_factory(shared_ptr<EncapFactory<time>> factory);
         virtual shared_ptr<EncapFactory<time>> get_factory() const;
@@ -185,22 +380,143 @@ namespace pfasst
          *
          * @param[in] abs_residual_tol tolerance for the absolute residual
          * @param[in] rel_residual_tol tolerance for the relative residual
-         * @param[in] order
+         * @param[in] order            norm to measure the residuals in (see
+         *   pfasst::encap::NormType)
+         * @throws ValueError if @p order is not a valid pfasst::encap::NormType
          */
         void set_residual_tolerances(time abs_residual_tol, time rel_residual_tol, int order = 0);
 
         /**
          * Compute residual at each SDC node (including FAS corrections).
          *
+         * The default implementation computes
+         * \\( r_m = U_0 - U_m + \\Delta t \\sum_j q_{m,j} F_j + \\sum_{n \\leq m} \\tau_n \\)
+         * with the integrals from integrate(), reusing them if they are still available.
+         * All residuals are formed by a single application of #residual_mat.
+         *
          * @param[in]     dt  width of the time interval to compute the residual for
          * @param[in,out] dst place to store the residuals at time nodes
          */
         virtual void residual(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const;
 
+        /**
+         * Residuals of the current values at all time nodes.
+         *
+         * The residuals are computed once per step and iteration of the controller and cached
+         * until the sweeper's values change, thus convergence checks and diagnostics (e.g. in
+         * ISweeper::post_sweep()) share a single computation.
+         *
+         * @since v0.6.0
+         */
+        virtual const vector<shared_ptr<Encapsulation<time>>>& get_current_residuals();
+
+        /**
+         * Discards the cached residuals.
+         *
+         * Sweepers and transfer operators call this whenever they change the values entering the
+         * residual (solution values, initial value or FAS corrections); user code modifying these
+         * directly must do so as well.
+         *
+         * @since v0.6.0
+         */
+        virtual void invalidate_residuals();
+
+        /**
+         * Marks function values as changed.
+         *
+         * To be called by sweepers and transfer operators whenever they modify the function
+         * values; invalidates the cached '0 to node' integrals as well as the residuals.
+         */
+        virtual void invalidate_integrals();
+
+        /**
+         * Sets the policy coupling the tolerances of the implicit solves to the SDC iteration.
+         *
+         * @param[in] policy policy to use; `nullptr` (the default) leaves the tolerance to the
+         *   solver, i.e. SolverContext::tolerance is zero
+         * @since v0.6.0
+         */
+        virtual void set_inexact_solve_policy(shared_ptr<InexactSolvePolicy<time>> policy);
+
+        /**
+         * Selects the initial guess of the implicit solves.
+         *
+         * @param[in] guess where iterative solvers start from; defaults to
+         *   InitialGuess::PreviousIterate
+         * @since v0.6.0
+         */
+        virtual void set_initial_guess(InitialGuess guess);
+
+        /**
+         * State of the SDC iteration and requested tolerance for the current implicit solves.
+         *
+         * To be queried by implementations of `impl_solve()`.
+         *
+         * @since v0.6.0
+         */
+        virtual const SolverContext<time>& get_solver_context() const;
+
+        /**
+         * Records statistics of a single implicit solve.
+         *
+         * To be called by implementations of `impl_solve()`; safe to be called concurrently.
+         *
+         * @param[in] iterations number of inner iterations
+         * @param[in] residual final residual (or update) of the inner iteration
+         * @param[in] converged whether the requested tolerance has been reached
+         * @since v0.6.0
+         */
+        virtual void record_solve(size_t iterations, time residual, bool converged);
+
+        /**
+         * Counters of all implicit solves recorded by record_solve().
+         *
+         * @since v0.6.0
+         */
+        virtual const SolverStatistics<time>& get_solver_statistics() const;
+
         /**
          * @copybrief ISweeper::converged()
+         *
+         * The residuals and the solution values are measured in the norm selected by
+         * set_residual_tolerances().
          */
         virtual bool converged() override;
+
+        /**
+         * Selects the local error estimate for adaptive step sizes.
+         *
+         * @param[in] estimate type of the estimate; defaults to ErrorEstimate::Embedded
+         * @since v0.6.0
+         */
+        virtual void set_error_estimate(ErrorEstimate estimate);
+
+        /**
+         * @copybrief ISweeper::estimate_error()
+         *
+         * ErrorEstimate::Embedded compares the end value to the one of the quadrature rule on all
+         * but the last node, i.e. it computes
+         * \\( \\| \\Delta t \\sum_j (b_j - \\hat{b}_j) F_j \\| \\) from the current function values
+         * (see get_function_values()).
+         * Its order is about one less than the number of nodes.
+         *
+         * ErrorEstimate::Iterates measures the change of the end value by the latest sweep on the
+         * same time step; there is no estimate after the prediction.
+         *
+         * Both are measured in the norm selected by set_residual_tolerances().
+         *
+         * @throws ValueError for the embedded estimate with less than two nodes
+         * @throws NotImplementedYet for the embedded estimate if the sweeper does not provide its
+         *   function values
+         */
+        virtual time estimate_error() override;
+
+        /**
+         * @copybrief ISweeper::post_step_size_change()
+         *
+         * Discards the cached integrals and residuals.
+         */
+        virtual void post_step_size_change() override;
         //! @}
 
         //! @{
@@ -223,6 +539,11 @@ namespace pfasst
          * @copybrief ISweeper::broadcast()
          */
         virtual void broadcast(ICommunicator* comm) override;
+
+        /**
+         * @copybrief ISweeper::broadcast_end_state()
+         */
+        virtual void broadcast_end_state(ICommunicator* comm, int root) override;
         //! @}
     };
 
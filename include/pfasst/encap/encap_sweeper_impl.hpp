@@ -6,6 +6,7 @@ using namespace std;
 
 #include "pfasst/globals.hpp"
 #include "pfasst/config.hpp"
+#include "pfasst/logging.hpp"
 
 
 namespace pfasst
@@ -15,8 +16,21 @@ namespace pfasst
     template<typename time>
     EncapSweeper<time>::EncapSweeper()
       :   quadrature(nullptr)
+        , residuals_valid(false)
+        , residuals_step(0)
+        , residuals_iteration(0)
+        , q_integrals_valid(false)
+        , q_integrals_dt(0.0)
+        , save_function_values(false)
+        , saved_function_values_valid(false)
+        , state_spread(false)
+        , initial_guess(InitialGuess::PreviousIterate)
+        , residual_norm_order(max_norm)
         , abs_residual_tol(0.0)
         , rel_residual_tol(0.0)
+        , error_estimate_type(ErrorEstimate::Embedded)
+        , previous_end_valid(false)
+        , previous_end_step(0)
     {}
 
     template<typename time>
@@ -46,26 +60,54 @@ namespace pfasst
       this->start_state = this->get_factory()->create(pfasst::encap::solution);
       this->end_state = this->get_factory()->create(pfasst::encap::solution);
 
-      for (size_t m = 0; m < num_nodes; m++) {
-        this->state.push_back(this->get_factory()->create(pfasst::encap::solution));
-        if (coarse) {
-          this->saved_state.push_back(this->get_factory()->create(pfasst::encap::solution));
-        }
-      }
-
+      this->state = this->get_factory()->create_block(pfasst::encap::solution, num_nodes);
       if (coarse) {
-        for (size_t m = 0; m < num_nodes; m++) {
-          this->fas_corrections.push_back(this->get_factory()->create(pfasst::encap::solution));
-        }
+        this->saved_state = this->get_factory()->create_block(pfasst::encap::solution, num_nodes);
+        this->fas_corrections = this->get_factory()->create_block(pfasst::encap::solution, num_nodes);
       }
+      this->residual_mat.resize(0, 0);
     }
 
     template<typename time>
     void EncapSweeper<time>::spread()
     {
-      for (size_t m = 1; m < this->quadrature->get_num_nodes(); m++) {
+      if (this->quadrature->left_is_node()) {
+        this->state[0]->copy(this->start_state);
+      }
+      for (size_t m = 1; m < this->state.size(); m++) {
         this->state[m]->copy(this->state[0]);
       }
+      this->invalidate_residuals();
+      this->state_spread = true;
+    }
+
+    template<typename time>
+    const vector<shared_ptr<Encapsulation<time>>>& EncapSweeper<time>::get_q_integrals(time dt) const
+    {
+      if (!this->has_q_integrals(dt)) {
+        if (this->q_integrals.size() == 0) {
+          this->q_integrals = this->get_factory()->create_block(pfasst::encap::solution,
+                                                                this->get_nodes().size());
+        }
+        this->integrate(dt, this->q_integrals);
+        this->q_integrals_valid = true;
+        this->q_integrals_dt = dt;
+      }
+      return this->q_integrals;
+    }
+
+    template<typename time>
+    bool EncapSweeper<time>::has_q_integrals(time dt) const
+    {
+      return this->q_integrals_valid && this->q_integrals_dt == dt;
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::invalidate_integrals()
+    {
+      this->q_integrals_valid = false;
+      this->state_spread = false;
+      this->invalidate_residuals();
     }
 
     template<typename time>
@@ -79,6 +121,62 @@ namespace pfasst
           this->saved_state[m]->copy(state[m]);
         }
       }
+
+      if (!this->save_function_values) {
+        return;
+      }
+
+      auto const fs = this->get_function_values();
+      if (this->saved_function_values.size() != fs.size()) {
+        this->saved_function_values.clear();
+        for (auto const& f : fs) {
+          this->saved_function_values.push_back(
+            this->get_factory()->create_block(pfasst::encap::function, f.size()));
+        }
+        this->saved_function_values_valid = false;
+      }
+
+      if (initial_only) {
+        for (size_t i = 0; i < fs.size(); i++) {
+          this->saved_function_values[i][0]->copy(fs[i][0]);
+        }
+      } else {
+        for (size_t i = 0; i < fs.size(); i++) {
+          for (size_t m = 0; m < fs[i].size(); m++) {
+            this->saved_function_values[i][m]->copy(fs[i][m]);
+          }
+        }
+        this->saved_function_values_valid = fs.size() > 0 && !this->state_spread;
+      }
+    }
+
+    template<typename time>
+    vector<vector<shared_ptr<Encapsulation<time>>>> EncapSweeper<time>::get_function_values() const
+    {
+      return vector<vector<shared_ptr<Encapsulation<time>>>>();
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::set_save_function_values(bool save)
+    {
+      this->save_function_values = save;
+      if (!save) {
+        this->saved_function_values.clear();
+        this->saved_function_values_valid = false;
+      }
+    }
+
+    template<typename time>
+    bool EncapSweeper<time>::has_saved_function_values() const
+    {
+      return this->save_function_values && this->saved_function_values_valid;
+    }
+
+    template<typename time>
+    const vector<vector<shared_ptr<Encapsulation<time>>>>&
+    EncapSweeper<time>::get_saved_function_values() const
+    {
+      return this->saved_function_values;
     }
 
     template<typename time>
@@ -100,7 +198,7 @@ namespace pfasst
     }
 
     template<typename time>
-    const vector<time> EncapSweeper<time>::get_nodes() const
+    const vector<time>& EncapSweeper<time>::get_nodes() const
     {
       return this->quadrature->get_nodes();
     }
@@ -147,6 +245,10 @@ namespace pfasst
     void EncapSweeper<time>::set_residual_tolerances(time abs_residual_tol, time rel_residual_tol,
                                                      int order)
     {
+      if (order < max_norm || order > rms_norm) {
+        ML_CLOG(ERROR, "Sweeper", "unknown residual norm order: " << order);
+        throw ValueError("unknown residual norm order");
+      }
       this->abs_residual_tol = abs_residual_tol;
       this->rel_residual_tol = rel_residual_tol;
       this->residual_norm_order = order;
@@ -155,24 +257,187 @@ namespace pfasst
     template<typename time>
     void EncapSweeper<time>::residual(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const
     {
-      UNUSED(dt); UNUSED(dst);
-      throw NotImplementedYet("residual");
+      auto const& q_int = this->get_q_integrals(dt);
+
+      const size_t num_nodes = this->state.size();
+      const bool fas = this->fas_corrections.size() > 0;
+      assert(dst.size() == num_nodes);
+
+      if (this->residual_mat.rows() == 0) {
+        // columns: [ U_0 | U_0 ... U_{M-1} | dt Q F | tau_0 ... tau_{M-1} ]
+        this->residual_mat = Matrix<time>::Zero(num_nodes, 1 + (fas ? 3 : 2) * num_nodes);
+        for (size_t m = 0; m < num_nodes; m++) {
+          this->residual_mat(m, 0) = 1.0;
+          this->residual_mat(m, 1 + m) = -1.0;
+          this->residual_mat(m, 1 + num_nodes + m) = 1.0;
+          // the FAS corrections are 'node to node', thus they are summed up to node m
+          for (size_t n = 0; fas && n <= m; n++) {
+            this->residual_mat(m, 1 + 2 * num_nodes + n) = 1.0;
+          }
+        }
+      }
+
+      vector<shared_ptr<Encapsulation<time>>> src = { this->start_state };
+      src.insert(src.end(), this->state.begin(), this->state.end());
+      src.insert(src.end(), q_int.begin(), q_int.end());
+      if (fas) {
+        src.insert(src.end(), this->fas_corrections.begin(), this->fas_corrections.end());
+      }
+      dst[0]->mat_apply(dst, 1.0, this->residual_mat, src, true);
     }
 
     template<typename time>
-    bool EncapSweeper<time>::converged()
+    const vector<shared_ptr<Encapsulation<time>>>& EncapSweeper<time>::get_current_residuals()
     {
-      if (this->abs_residual_tol > 0.0 || this->rel_residual_tol > 0.0) {
+      auto controller = this->get_controller();
+      if (!this->residuals_valid
+          || this->residuals_step != controller->get_step()
+          || this->residuals_iteration != controller->get_iteration()) {
         if (this->residuals.size() == 0) {
-          for (size_t m = 0; m < this->get_nodes().size(); m++) {
-            this->residuals.push_back(this->get_factory()->create(pfasst::encap::solution));
+          this->residuals = this->get_factory()->create_block(pfasst::encap::solution,
+                                                              this->get_nodes().size());
+        }
+        this->residual(controller->get_step_size(), this->residuals);
+        this->residuals_valid = true;
+        this->residuals_step = controller->get_step();
+        this->residuals_iteration = controller->get_iteration();
+      }
+      return this->residuals;
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::invalidate_residuals()
+    {
+      this->residuals_valid = false;
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::begin_solves(bool predict)
+    {
+      auto controller = this->get_controller();
+      this->solver_context.step = controller->get_step();
+      this->solver_context.iteration = controller->get_iteration();
+      this->solver_context.predict = predict;
+      this->solver_context.residual = -1.0;
+      this->solver_context.tolerance = 0.0;
+
+      if (this->error_estimate_type == ErrorEstimate::Iterates) {
+        this->previous_end_valid = false;
+        if (!predict) {
+          if (!this->previous_end_state) {
+            this->previous_end_state = this->get_factory()->create(pfasst::encap::solution);
           }
+          this->previous_end_state->copy(this->get_end_state());
+          this->previous_end_valid = true;
+          this->previous_end_step = controller->get_step();
         }
-        this->residual(this->get_controller()->get_step_size(), this->residuals);
-        vector<time> anorms, rnorms;
-        for (size_t m = 0; m < this->get_nodes().size(); m++) {
-          anorms.push_back(this->residuals[m]->norm0());
-          rnorms.push_back(anorms.back() / this->get_state(m)->norm0());
+      }
+
+      if (!this->solve_policy) {
+        return;
+      }
+
+      if (!predict && this->solve_policy->needs_residual()) {
+        auto const& residuals = this->residuals_valid ? this->residuals
+                                                      : this->get_current_residuals();
+        auto const norms = residuals[0]->norms(residuals, NormType(this->residual_norm_order));
+        this->solver_context.residual = *std::max_element(norms.begin(), norms.end());
+      }
+      this->solver_context.tolerance = this->solve_policy->tolerance(this->solver_context);
+
+      ML_CLOG(DEBUG, "Sweeper", "tolerance of implicit solves: " << this->solver_context.tolerance
+                                << " (residual: " << this->solver_context.residual << ")");
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::store_initial_guess(size_t m, shared_ptr<const Encapsulation<time>> rhs,
+                                                 bool predict)
+    {
+      auto const& nodes = this->quadrature->get_nodes();
+      auto dst = this->state[m];
+
+      // previous points (in time) of the current sweep; the initial value comes first
+      vector<time> taus;
+      vector<shared_ptr<Encapsulation<time>>> values;
+      if (!this->quadrature->left_is_node()) {
+        taus.push_back(0.0);
+        values.push_back(this->start_state);
+      }
+      for (size_t j = 0; j < m; j++) {
+        taus.push_back(nodes[j]);
+        values.push_back(this->state[j]);
+      }
+
+      switch (this->initial_guess) {
+        case InitialGuess::PreviousIterate:
+          if (predict && values.size() > 0) {
+            dst->copy(values.back());
+          }
+          break;
+
+        case InitialGuess::Extrapolation:
+          if (values.size() >= 2) {
+            const size_t b = values.size() - 1;
+            const time r = (nodes[m] - taus[b]) / (taus[b] - taus[b - 1]);
+            dst->lincomb({ 1.0 + r, -r }, { values[b], values[b - 1] });
+          } else if (values.size() == 1) {
+            dst->copy(values.back());
+          }
+          break;
+
+        case InitialGuess::RHS:
+          dst->copy(rhs);
+          break;
+
+        default:
+          throw ValueError("invalid initial guess");
+      }
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::set_initial_guess(InitialGuess guess)
+    {
+      this->initial_guess = guess;
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::set_inexact_solve_policy(shared_ptr<InexactSolvePolicy<time>> policy)
+    {
+      this->solve_policy = policy;
+    }
+
+    template<typename time>
+    const SolverContext<time>& EncapSweeper<time>::get_solver_context() const
+    {
+      return this->solver_context;
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::record_solve(size_t iterations, time residual, bool converged)
+    {
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_record_solve)
+#endif
+      this->solver_stats.add(iterations, residual, converged);
+    }
+
+    template<typename time>
+    const SolverStatistics<time>& EncapSweeper<time>::get_solver_statistics() const
+    {
+      return this->solver_stats;
+    }
+
+    template<typename time>
+    bool EncapSweeper<time>::converged()
+    {
+      if (this->abs_residual_tol > 0.0 || this->rel_residual_tol > 0.0) {
+        auto const& residuals = this->get_current_residuals();
+
+        auto const type = NormType(this->residual_norm_order);
+        vector<time> anorms = residuals[0]->norms(residuals, type);
+        vector<time> rnorms = this->state[0]->norms(this->state, type);
+        for (size_t m = 0; m < rnorms.size(); m++) {
+          rnorms[m] = anorms[m] / rnorms[m];
         }
         auto amax = *std::max_element(anorms.begin(), anorms.end());
         auto rmax = *std::max_element(rnorms.begin(), rnorms.end());
@@ -183,6 +448,74 @@ namespace pfasst
       return false;
     }
 
+    template<typename time>
+    void EncapSweeper<time>::set_error_estimate(ErrorEstimate estimate)
+    {
+      this->error_estimate_type = estimate;
+      this->previous_end_valid = false;
+    }
+
+    template<typename time>
+    time EncapSweeper<time>::estimate_error()
+    {
+      auto controller = this->get_controller();
+      auto const type = NormType(this->residual_norm_order);
+
+      if (!this->error_scratch) {
+        this->error_scratch = this->get_factory()->create(pfasst::encap::solution);
+      }
+
+      switch (this->error_estimate_type) {
+        case ErrorEstimate::Embedded: {
+          auto const& nodes = this->get_nodes();
+          if (nodes.size() < 2) {
+            ML_CLOG(ERROR, "Sweeper", "embedded error estimate requires at least two nodes");
+            throw ValueError("embedded error estimate requires at least two nodes");
+          }
+          auto const fs = this->get_function_values();
+          if (fs.size() == 0) {
+            throw NotImplementedYet("embedded error estimate without function values");
+          }
+
+          if (this->embedded_weights.cols() == 0) {
+            auto const b = this->quadrature->get_b_mat();
+            auto const b_hat = compute_q_vec(vector<time>(nodes.begin(), nodes.end() - 1));
+            this->embedded_weights = b;
+            for (size_t j = 0; j < b_hat.size(); j++) {
+              this->embedded_weights(0, j) -= b_hat[j];
+            }
+          }
+
+          const vector<shared_ptr<Encapsulation<time>>> dst = { this->error_scratch };
+          dst[0]->zero();
+          for (auto const& f : fs) {
+            dst[0]->mat_apply(dst, controller->get_step_size(), this->embedded_weights, f, false);
+          }
+          return dst[0]->norm(type);
+        }
+
+        case ErrorEstimate::Iterates: {
+          if (!this->previous_end_valid || this->previous_end_step != controller->get_step()) {
+            return -1.0;
+          }
+          auto diff = this->error_scratch;
+          diff->copy(this->get_end_state());
+          diff->saxpy(-1.0, this->previous_end_state);
+          return diff->norm(type);
+        }
+
+        default:
+          throw ValueError("invalid error estimate");
+      }
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::post_step_size_change()
+    {
+      this->invalidate_integrals();
+      this->previous_end_valid = false;
+    }
+
     template<typename time>
     void EncapSweeper<time>::post(ICommunicator* comm, int tag)
     {
@@ -199,6 +532,7 @@ namespace pfasst
     void EncapSweeper<time>::recv(ICommunicator* comm, int tag, bool blocking)
     {
       this->start_state->recv(comm, tag, blocking);
+      this->invalidate_residuals();
       if (this->quadrature->left_is_node()) {
         this->state[0]->copy(this->start_state);
       }
@@ -211,23 +545,28 @@ namespace pfasst
         this->start_state->copy(this->end_state);
       }
       this->start_state->broadcast(comm);
+      this->invalidate_residuals();
+    }
+
+    template<typename time>
+    void EncapSweeper<time>::broadcast_end_state(ICommunicator* comm, int root)
+    {
+      this->end_state->broadcast(comm, root);
     }
 
 
     template<typename time>
     EncapSweeper<time>& as_encap_sweeper(shared_ptr<ISweeper<time>> x)
     {
-      shared_ptr<EncapSweeper<time>> y = dynamic_pointer_cast<EncapSweeper<time>>(x);
-      assert(y);
-      return *y.get();
+      assert(dynamic_pointer_cast<EncapSweeper<time>>(x));
+      return static_cast<EncapSweeper<time>&>(*x);
     }
 
     template<typename time>
     const EncapSweeper<time>& as_encap_sweeper(shared_ptr<const ISweeper<time>> x)
     {
-      shared_ptr<const EncapSweeper<time>> y = dynamic_pointer_cast<const EncapSweeper<time>>(x);
-      assert(y);
-      return *y.get();
+      assert(dynamic_pointer_cast<const EncapSweeper<time>>(x));
+      return static_cast<const EncapSweeper<time>&>(*x);
     }
 
   }  // ::pfasst::encap
@@ -5,7 +5,9 @@
 #ifndef _PFASST_ENCAPSULATED_HPP_
 #define _PFASST_ENCAPSULATED_HPP_
 
+#include <cassert>
 #include <memory>
+#include <typeinfo>
 #include <vector>
 using namespace std;
 
@@ -28,6 +30,21 @@ namespace pfasst
   {
     typedef enum EncapType { solution, function } EncapType;
 
+    /**
+     * Norms provided by Encapsulation::norm().
+     *
+     * The values are the `order` accepted by pfasst::encap::EncapSweeper::set_residual_tolerances().
+     * All of them are NaN if any of the values is NaN.
+     *
+     * @since v0.6.0
+     */
+    typedef enum NormType {
+      max_norm = 0,  //!< \\( \\max_i |x_i| \\) (see Encapsulation::norm0())
+      l1_norm  = 1,  //!< \\( \\sum_i |x_i| \\)
+      l2_norm  = 2,  //!< \\( \\sqrt{\\sum_i |x_i|^2} \\)
+      rms_norm = 3   //!< \\( \\sqrt{\\frac{1}{N} \\sum_i |x_i|^2} \\) (root mean square, unweighted)
+    } NormType;
+
     /**
      * Data/solution encapsulation.
      *
@@ -55,6 +72,32 @@ namespace pfasst
          * @param[in] other other data structure to copy data from
          */
         virtual void copy(shared_ptr<const Encapsulation<time>> other);
+
+        /**
+         * Exchanges the values of this data structure with those of @p other.
+         *
+         * Implementations should exchange the underlying buffers instead of copying values
+         * wherever possible.
+         *
+         * @param[in,out] other other data structure to exchange data with
+         * @since v0.6.0
+         */
+        virtual void swap(shared_ptr<Encapsulation<time>> other);
+
+        /**
+         * Takes over the values of @p other, which are not needed anymore.
+         *
+         * After this call @p other is in a valid but unspecified state (e.g. it holds the previous
+         * values of this data structure).
+         * This is used where PFASST would otherwise copy values of a data structure which is
+         * overwritten right afterwards (e.g. the end state when advancing in time).
+         *
+         * The default implementation calls copy().
+         *
+         * @param[in,out] other other data structure to take the data from
+         * @since v0.6.0
+         */
+        virtual void move_from(shared_ptr<Encapsulation<time>> other);
         //! @}
 
         //! @{
@@ -64,6 +107,48 @@ namespace pfasst
          * @returns \\( 0 \\)-norm of this data structure
          */
         virtual time norm0() const;
+
+        /**
+         * Computes the norm of type @p type of the data structure's values.
+         *
+         * The default implementation provides pfasst::encap::max_norm through norm0() only.
+         *
+         * @param[in] type which norm to compute
+         * @throws NotImplementedYet for any unsupported @p type
+         * @since v0.6.0
+         */
+        virtual time norm(NormType type) const;
+
+        /**
+         * Computes the norms of type @p type of all of @p x at once.
+         *
+         * This data structure only selects the implementation; it is usually the first element of
+         * @p x.
+         * Implementations may use this to process a whole family of per-node data structures in
+         * one go.
+         * The default implementation calls norm() on each element.
+         *
+         * @param[in] x    data structures to compute the norms of
+         * @param[in] type which norm to compute
+         * @returns norms of the elements of @p x in the same order
+         * @since v0.6.0
+         */
+        virtual vector<time> norms(const vector<shared_ptr<Encapsulation<time>>>& x,
+                                   NormType type) const;
+
+        /**
+         * Computes the inner product of this data structure's values with the ones of @p x.
+         *
+         * Required by Krylov methods only (see pfasst::encap::KrylovSolverMixin); the induced
+         * norm is the \\( l_2 \\) norm.
+         * For complex values, this is the real part of \\( \\sum_i \\bar{y}_i x_i \\).
+         *
+         * @param[in] x data structure of the same type and size
+         * @returns inner product with @p x
+         * @throws NotImplementedYet if not implemented by the data structure
+         * @since v0.6.0
+         */
+        virtual time dot(shared_ptr<const Encapsulation<time>> x) const;
         //! @}
 
         //! @{
@@ -79,6 +164,28 @@ namespace pfasst
          */
         virtual void saxpy(time a, shared_ptr<const Encapsulation<time>> x);
 
+        /**
+         * Fused linear combination \\( y = [y +] \\sum_i a_i x_i \\).
+         *
+         * Computes the same as a copy() (or zero()) followed by one saxpy() per term, with the
+         * terms added in the given order, but allows implementations to do so in a single pass
+         * over memory.
+         *
+         * If @p zero is `true`, the former values of this data structure are discarded, elsewise
+         * the linear combination is added onto them.
+         *
+         * @param[in] a    coefficients \\( a_i \\)
+         * @param[in] x    data structures \\( x_i \\); must have the same length as @p a
+         * @param[in] zero whether to overwrite (`true`) or add onto (`false`) this data structure
+         *
+         * @note The default implementation falls back to copy() and saxpy(), thus this data
+         *   structure may only be one of @p x if @p zero is `false`.
+         * @since v0.6.0
+         */
+        virtual void lincomb(const vector<time>& a,
+                             const vector<shared_ptr<Encapsulation<time>>>& x,
+                             bool zero = true);
+
         /**
          * Defines matrix-vector multiplication for this data type.
          *
@@ -96,10 +203,16 @@ namespace pfasst
          * @param[in]     mat
          * @param[in]     src
          * @param[in]     zero
+         *
+         * @note Since v0.6.0 @p dst, @p mat and @p src are passed by const reference instead of by
+         *   value.
+         *   Overriders written against the old by-value signature no longer override this method
+         *   and have to be adapted; declaring them `override` turns the mismatch into a compile
+         *   error.
          */
-        virtual void mat_apply(vector<shared_ptr<Encapsulation<time>>> dst,
-                               time a, Matrix<time> mat,
-                               vector<shared_ptr<Encapsulation<time>>> src,
+        virtual void mat_apply(const vector<shared_ptr<Encapsulation<time>>>& dst,
+                               time a, const Matrix<time>& mat,
+                               const vector<shared_ptr<Encapsulation<time>>>& src,
                                bool zero = true);
         //! @}
 
@@ -136,10 +249,53 @@ namespace pfasst
          * @param[in] comm communicator managing the processes to send this data structure to
          */
         virtual void broadcast(ICommunicator* comm);
+
+        /**
+         * Broadcast this data structure from process @p root to all processes in @p comm.
+         *
+         * @param[in] comm communicator managing the processes to send this data structure to
+         * @param[in] root rank of the process in @p comm holding the data to send
+         *
+         * @since v0.6.0
+         */
+        virtual void broadcast(ICommunicator* comm, int root);
         //! @}
     };
 
 
+    /**
+     * Checked down-cast of an Encapsulation to its type @p EncapT.
+     *
+     * If @p x is exactly of type @p EncapT, which is the common case in performance critical code
+     * where the type is known by construction (e.g. all encapsulations of a level are created by
+     * the same factory), the check is a single comparison of `typeid`s and no reference counting
+     * is involved.
+     * Types derived from @p EncapT are handled by a `dynamic_cast`.
+     *
+     * @tparam EncapT type of @p x or a base of it
+     * @throws std::bad_cast if @p x is not an @p EncapT
+     * @since v0.6.0
+     */
+    template<class EncapT, typename time>
+    inline EncapT& encap_cast(Encapsulation<time>& x)
+    {
+      if (typeid(x) != typeid(EncapT)) {
+        return dynamic_cast<EncapT&>(x);
+      }
+      return static_cast<EncapT&>(x);
+    }
+
+    //! @copydoc encap_cast()
+    template<class EncapT, typename time>
+    inline const EncapT& encap_cast(const Encapsulation<time>& x)
+    {
+      if (typeid(x) != typeid(EncapT)) {
+        return dynamic_cast<const EncapT&>(x);
+      }
+      return static_cast<const EncapT&>(x);
+    }
+
+
     /**
      * Abstract interface of factory for creating Encapsulation objects.
      *
@@ -159,6 +315,25 @@ namespace pfasst
          * @param[in] type encapsulation type of the requested Encapsulation object
          */
         virtual shared_ptr<Encapsulation<time>> create(const EncapType type) = 0;
+
+        /**
+         * Creates a family of @p num Encapsulation objects of the same type at once.
+         *
+         * This is used by the sweepers to allocate their per-node data (e.g. the solution or the
+         * function values at all collocation nodes).
+         * Factories may override this to place the whole family in a single contiguous block of
+         * memory with the returned objects being views into it.
+         * Callers must not rely on the order of the objects within such a block, as sweepers
+         * exchange the objects of a family (e.g. in ISweeper::advance()).
+         *
+         * The default implementation calls create() @p num times.
+         *
+         * @param[in] type encapsulation type of the requested Encapsulation objects
+         * @param[in] num  number of requested Encapsulation objects
+         * @since v0.6.0
+         */
+        virtual vector<shared_ptr<Encapsulation<time>>> create_block(const EncapType type,
+                                                                     const size_t num);
     };
   }  // ::pfasst::encap
 } // ::pfasst
@@ -23,12 +23,51 @@ namespace pfasst
       throw NotImplementedYet("encap");
     }
 
+    template<typename time>
+    void Encapsulation<time>::swap(shared_ptr<Encapsulation<time>>)
+    {
+      throw NotImplementedYet("encap");
+    }
+
+    template<typename time>
+    void Encapsulation<time>::move_from(shared_ptr<Encapsulation<time>> other)
+    {
+      this->copy(other);
+    }
+
     template<typename time>
     time Encapsulation<time>::norm0() const
     {
       throw NotImplementedYet("encap");
     }
 
+    template<typename time>
+    time Encapsulation<time>::norm(NormType type) const
+    {
+      if (type == max_norm) {
+        return this->norm0();
+      }
+      throw NotImplementedYet("encap");
+    }
+
+    template<typename time>
+    vector<time> Encapsulation<time>::norms(const vector<shared_ptr<Encapsulation<time>>>& x,
+                                            NormType type) const
+    {
+      vector<time> result(x.size());
+      for (size_t m = 0; m < x.size(); m++) {
+        result[m] = x[m]->norm(type);
+      }
+      return result;
+    }
+
+    template<typename time>
+    time Encapsulation<time>::dot(shared_ptr<const Encapsulation<time>> x) const
+    {
+      UNUSED(x);
+      throw NotImplementedYet("encap");
+    }
+
     template<typename time>
     void Encapsulation<time>::saxpy(time a, shared_ptr<const Encapsulation<time>> x)
     {
@@ -37,9 +76,31 @@ namespace pfasst
     }
 
     template<typename time>
-    void Encapsulation<time>::mat_apply(vector<shared_ptr<Encapsulation<time>>> dst,
-                                        time a, Matrix<time> mat,
-                                        vector<shared_ptr<Encapsulation<time>>> src,
+    void Encapsulation<time>::lincomb(const vector<time>& a,
+                                      const vector<shared_ptr<Encapsulation<time>>>& x,
+                                      bool zero)
+    {
+      assert(a.size() == x.size());
+
+      size_t first = 0;
+      if (zero) {
+        if (x.size() > 0 && a[0] == time(1.0)) {
+          this->copy(x[0]);
+          first = 1;
+        } else {
+          this->zero();
+        }
+      }
+
+      for (size_t i = first; i < x.size(); i++) {
+        this->saxpy(a[i], x[i]);
+      }
+    }
+
+    template<typename time>
+    void Encapsulation<time>::mat_apply(const vector<shared_ptr<Encapsulation<time>>>& dst,
+                                        time a, const Matrix<time>& mat,
+                                        const vector<shared_ptr<Encapsulation<time>>>& src,
                                         bool zero)
     {
       size_t ndst = dst.size();
@@ -85,5 +146,24 @@ namespace pfasst
       UNUSED(comm);
       throw NotImplementedYet("pfasst");
     }
+
+    template<typename time>
+    void Encapsulation<time>::broadcast(ICommunicator* comm, int root)
+    {
+      UNUSED(comm); UNUSED(root);
+      throw NotImplementedYet("pfasst");
+    }
+
+
+    template<typename time>
+    vector<shared_ptr<Encapsulation<time>>> EncapFactory<time>::create_block(const EncapType type,
+                                                                             const size_t num)
+    {
+      vector<shared_ptr<Encapsulation<time>>> encaps;
+      for (size_t m = 0; m < num; m++) {
+        encaps.push_back(this->create(type));
+      }
+      return encaps;
+    }
   }  // ::pfasst::encap
 }  // ::pfasst
@@ -28,6 +28,11 @@ namespace pfasst
      * and one routine that solves (perhaps with an external solver) the backward-Euler equation
      * \\( U^{n+1} - \\Delta t F_{\\rm impl}(U^{n+1}) = RHS \\) for \\( U^{n+1} \\).
      *
+     * The sweeps are preconditioned with one lower triangular \\( Q_\\Delta \\) for each piece (see
+     * pfasst::quadrature::QDeltaType).
+     * By default, these are forward Euler for the explicit and backward Euler for the implicit
+     * piece; the predictor always uses Euler steps.
+     *
      * @tparam time precision type of the time dimension
      */
     template<typename time = time_precision>
@@ -54,6 +59,35 @@ namespace pfasst
          * iteration.
          */
         vector<shared_ptr<Encapsulation<time>>> fs_impl;
+
+        /**
+         * Matrices mapping the function values and FAS corrections onto #s_integrals.
+         *
+         * Index `1` holds the variant based on the '0 to node' integrals (see
+         * EncapSweeper::get_q_integrals()), index `0` the one applying \\( S \\) directly.
+         * Built on first use and whenever the step size changes.
+         */
+        Matrix<time> s_integrals_mat[2];
+        time s_integrals_mat_dt[2];
+        //! @}
+
+        //! @{
+        /**
+         * Preconditioners \\( Q_\\Delta \\) of the explicit and implicit piece.
+         *
+         * Computed in setup() from the types unless given explicitly.
+         */
+        quadrature::QDeltaType q_delta_expl_type = quadrature::QDeltaType::ExplicitEuler;
+        quadrature::QDeltaType q_delta_impl_type = quadrature::QDeltaType::ImplicitEuler;
+        Matrix<time> q_delta_expl;
+        Matrix<time> q_delta_impl;
+
+        /**
+         * Node-to-node form of the preconditioners, i.e. the differences of consecutive rows of
+         * #q_delta_expl and #q_delta_impl.
+         */
+        Matrix<time> s_delta_expl;
+        Matrix<time> s_delta_impl;
         //! @}
 
         /**
@@ -61,6 +95,25 @@ namespace pfasst
         */
         virtual void integrate_end_state(time dt);
 
+        /**
+         * Computes the right hand side terms of the sweep, i.e. for each node the integral from
+         * the previous node, minus the \\( Q_\\Delta \\) terms of the previous iteration, plus the
+         * FAS correction, with a single matrix application.
+         */
+        virtual void compute_s_integrals(time dt);
+
+        /**
+         * Computes the preconditioners from their types, checks them and derives #s_delta_expl
+         * and #s_delta_impl.
+         *
+         * Drops the matrices built from the previous preconditioners (#s_integrals_mat and
+         * EncapSweeper::residual_mat).
+         *
+         * @throws ValueError if a given \\( Q_\\Delta \\) does not match the quadrature or is not
+         *   (strictly) lower triangular
+         */
+        virtual void setup_q_delta();
+
       public:
         //! @{
         IMEXSweeper() = default;
@@ -68,8 +121,46 @@ namespace pfasst
         //! @}
 
         //! @{
+        /**
+         * Selects the preconditioner of the explicit piece.
+         *
+         * If called after setup(), the preconditioner is set up right away (see setup_q_delta()).
+         *
+         * @param[in] type type of \\( Q_\\Delta \\); must be strictly lower triangular, i.e.
+         *   pfasst::quadrature::QDeltaType::ExplicitEuler
+         */
+        virtual void set_explicit_q_delta(quadrature::QDeltaType type);
+
+        /**
+         * Sets the preconditioner of the explicit piece to a custom matrix, e.g. the Butcher
+         * matrix of an explicit Runge-Kutta method with the quadrature nodes as stages.
+         *
+         * @param[in] q_delta strictly lower triangular matrix of the size of \\( Q \\)
+         */
+        virtual void set_explicit_q_delta(const Matrix<time>& q_delta);
+
+        /**
+         * Selects the preconditioner of the implicit piece.
+         *
+         * If called after setup(), the preconditioner is set up right away (see setup_q_delta()).
+         *
+         * @param[in] type type of \\( Q_\\Delta \\)
+         */
+        virtual void set_implicit_q_delta(quadrature::QDeltaType type);
+
+        /**
+         * Sets the preconditioner of the implicit piece to a custom matrix, e.g. the Butcher
+         * matrix of a diagonally implicit Runge-Kutta method with the quadrature nodes as stages.
+         *
+         * @param[in] q_delta lower triangular matrix of the size of \\( Q \\)
+         */
+        virtual void set_implicit_q_delta(const Matrix<time>& q_delta);
+
         /**
          * @copydoc ISweeper::setup(bool)
+         *
+         * @throws ValueError if a given \\( Q_\\Delta \\) does not match the quadrature or is not
+         *   (strictly) lower triangular
          */
         virtual void setup(bool coarse) override;
 
@@ -87,7 +178,11 @@ namespace pfasst
          * Perform one SDC sweep/iteration.
          *
          * This computes a high-order solution from the previous iteration's function values and
-         * corrects it using forward/backward Euler steps across the nodes.
+         * corrects it with the preconditioners \\( Q_\\Delta \\) node by node.
+         *
+         * The 'node to node' integrals are taken as differences of the '0 to node' integrals if
+         * these are still available from computing the residual after the previous sweep (see
+         * EncapSweeper::get_q_integrals()).
          */
         virtual void sweep() override;
 
@@ -110,12 +205,11 @@ namespace pfasst
         virtual void integrate(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const override;
 
         /**
-         * @copybrief EncapSweeper::residual()
+         * @copybrief EncapSweeper::get_function_values()
          *
-         * @param[in] dt width of time interval to integrate over
-         * @param[in,out] dst residuals
+         * @returns the explicit and the implicit function values, in this order
          */
-        virtual void residual(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const override;
+        virtual vector<vector<shared_ptr<Encapsulation<time>>>> get_function_values() const override;
         //! @}
 
         //! @{
@@ -150,18 +244,52 @@ namespace pfasst
                                  shared_ptr<Encapsulation<time>> u_encap,
                                  time t);
 
+        /**
+         * Evaluate the explicit part of the ODE at several time points at once.
+         *
+         * Called by reevaluate() for all collocation nodes.
+         * The default calls f_expl_eval() for each time point; derived sweepers may override it to
+         * batch the evaluations (e.g. a single multi-dimensional FFT across all nodes).
+         *
+         * @param[in,out] f_expl_encaps Encapsulations to store the explicit function evaluations.
+         * @param[in] u_encaps Encapsulations storing the solution states at which to evaluate.
+         * @param[in] ts Time points of the evaluations; one per element of @p u_encaps.
+         */
+        virtual void f_expl_eval_all(const vector<shared_ptr<Encapsulation<time>>>& f_expl_encaps,
+                                     const vector<shared_ptr<Encapsulation<time>>>& u_encaps,
+                                     const vector<time>& ts);
+
+        /**
+         * Evaluate the implicit part of the ODE at several time points at once.
+         *
+         * @see f_expl_eval_all()
+         *
+         * @param[in,out] f_impl_encaps Encapsulations to store the implicit function evaluations.
+         * @param[in] u_encaps Encapsulations storing the solution states at which to evaluate.
+         * @param[in] ts Time points of the evaluations; one per element of @p u_encaps.
+         */
+        virtual void f_impl_eval_all(const vector<shared_ptr<Encapsulation<time>>>& f_impl_encaps,
+                                     const vector<shared_ptr<Encapsulation<time>>>& u_encaps,
+                                     const vector<time>& ts);
+
         /**
          * Solve \\( U - \\Delta t F_{\\rm impl}(U) = RHS \\) for \\( U \\).
          *
          * During an IMEX SDC sweep, the correction equation is evolved using a forward-Euler
-         * stepper for the explicit piece, and a backward-Euler stepper for the implicit piece.
+         * stepper for the explicit piece, and a backward-Euler stepper for the implicit piece
+         * (or the selected preconditioners).
          * This routine (implemented by the user) performs the solve required to perform one
          * backward-Euler sub-step, and also returns \\( F_{\\rm impl}(U) \\).
          *
+         * Iterative solvers should stop at the tolerance of get_solver_context(), if set, and
+         * report their iterations via record_solve().
+         *
          * @param[in,out] f_encap Encapsulation to store the evaluated implicit piece.
-         * @param[in,out] u_encap Encapsulation to store the solution of the backward-Euler sub-step.
-         * @param[in] t time point (of \\( RHS \\)).
-         * @param[in] dt sub-step size to the previous time point (\\( \\Delta t \\)).
+         * @param[in,out] u_encap Encapsulation to store the solution of the backward-Euler sub-step;
+         *   holds the initial guess on entry (see EncapSweeper::set_initial_guess()).
+         * @param[in] t time point (of \\( RHS \\)); the solution is sought at \\( t + \\Delta t \\).
+         * @param[in] dt sub-step size to the previous time point (\\( \\Delta t \\)); in a sweep
+         *   the step size times the diagonal entry of the implicit \\( Q_\\Delta \\).
          * @param[in] rhs_encap Encapsulation that stores \\( RHS \\).
          *
          * @note This method must be implemented in derived sweepers.
@@ -175,8 +303,6 @@ namespace pfasst
       private:
         virtual void predict_with_left(bool initial);
         virtual void predict_without_left(bool initial);
-        virtual void sweep_with_left();
-        virtual void sweep_without_left();
     };
   }  // ::pfasst::encap
 }  // ::pfasst
@@ -21,6 +21,139 @@ namespace pfasst
       dst[0]->mat_apply(dst, dt, this->quadrature->get_b_mat(), this->fs_impl, false);
     }
 
+    template<typename time>
+    void IMEXSweeper<time>::compute_s_integrals(time dt)
+    {
+      auto const& nodes = this->quadrature->get_nodes();
+      auto const& s_mat = this->quadrature->get_s_mat();
+      const size_t num_nodes = nodes.size();
+      const bool left = this->quadrature->left_is_node();
+      const bool fas = this->fas_corrections.size() > 0;
+      const bool from_q = this->has_q_integrals(dt);
+
+      // columns: [ dt Q F | F_expl | F_impl | tau ], first block if needed
+      const size_t c_expl = from_q ? num_nodes : 0;
+      const size_t c_impl = c_expl + num_nodes;
+      const size_t c_tau = c_impl + num_nodes;
+      const size_t num_cols = c_tau + (fas ? num_nodes : 0);
+
+      Matrix<time>& mat = this->s_integrals_mat[from_q ? 1 : 0];
+      time& mat_dt = this->s_integrals_mat_dt[from_q ? 1 : 0];
+      if (size_t(mat.cols()) != num_cols || mat_dt != dt) {
+        mat = Matrix<time>::Zero(this->s_integrals.size(), num_cols);
+        for (size_t m = 0; m < this->s_integrals.size(); m++) {
+          // the integral leading to node n
+          const size_t n = left ? m + 1 : m;
+
+          if (from_q) {
+            // S F is the difference of consecutive rows of Q F
+            mat(m, n) = 1.0;
+            if (n > 0) { mat(m, n - 1) = -1.0; }
+          } else {
+            for (size_t j = 0; j < num_nodes; j++) {
+              mat(m, c_expl + j) = dt * s_mat(n, j);
+              mat(m, c_impl + j) = dt * s_mat(n, j);
+            }
+          }
+
+          // preconditioner terms of the previous iteration
+          for (size_t j = 0; j <= n; j++) {
+            mat(m, c_expl + j) -= dt * this->s_delta_expl(n, j);
+            mat(m, c_impl + j) -= dt * this->s_delta_impl(n, j);
+          }
+
+          if (fas) {
+            mat(m, c_tau + n) = 1.0;
+          }
+        }
+        mat_dt = dt;
+      }
+
+      vector<shared_ptr<Encapsulation<time>>> src;
+      if (from_q) {
+        auto const& q_int = this->get_q_integrals(dt);
+        src.insert(src.end(), q_int.begin(), q_int.end());
+      }
+      src.insert(src.end(), this->fs_expl.begin(), this->fs_expl.end());
+      src.insert(src.end(), this->fs_impl.begin(), this->fs_impl.end());
+      if (fas) {
+        src.insert(src.end(), this->fas_corrections.begin(), this->fas_corrections.end());
+      }
+
+      this->s_integrals[0]->mat_apply(this->s_integrals, 1.0, mat, src, true);
+    }
+
+    template<typename time>
+    void IMEXSweeper<time>::setup_q_delta()
+    {
+      auto const num_nodes = this->quadrature->get_num_nodes();
+
+      if (this->q_delta_expl_type != quadrature::QDeltaType::UNDEFINED) {
+        this->q_delta_expl = quadrature::compute_q_delta(*(this->quadrature), this->q_delta_expl_type);
+      }
+      if (this->q_delta_impl_type != quadrature::QDeltaType::UNDEFINED) {
+        this->q_delta_impl = quadrature::compute_q_delta(*(this->quadrature), this->q_delta_impl_type);
+      }
+      for (auto q_delta : { &this->q_delta_expl, &this->q_delta_impl }) {
+        if (size_t(q_delta->rows()) != num_nodes || size_t(q_delta->cols()) != num_nodes) {
+          throw ValueError("Q_delta must have the size of the quadrature matrix");
+        }
+      }
+      if (!this->q_delta_impl.isLowerTriangular()) {
+        throw ValueError("implicit Q_delta must be lower triangular");
+      }
+      if (!this->q_delta_expl.isLowerTriangular() || !this->q_delta_expl.diagonal().isZero()) {
+        throw ValueError("explicit Q_delta must be strictly lower triangular");
+      }
+      ML_CLOG(DEBUG, "Sweeper", "explicit Q_delta:" << endl << this->q_delta_expl);
+      ML_CLOG(DEBUG, "Sweeper", "implicit Q_delta:" << endl << this->q_delta_impl);
+
+      this->s_delta_expl = quadrature::compute_s_matrix(this->q_delta_expl);
+      this->s_delta_impl = quadrature::compute_s_matrix(this->q_delta_impl);
+      for (auto& mat : this->s_integrals_mat) {
+        mat.resize(0, 0);
+      }
+      this->residual_mat.resize(0, 0);
+    }
+
+    template<typename time>
+    void IMEXSweeper<time>::set_explicit_q_delta(quadrature::QDeltaType type)
+    {
+      this->q_delta_expl_type = type;
+      if (this->s_delta_expl.size() > 0) {
+        this->setup_q_delta();
+      }
+    }
+
+    template<typename time>
+    void IMEXSweeper<time>::set_explicit_q_delta(const Matrix<time>& q_delta)
+    {
+      this->q_delta_expl_type = quadrature::QDeltaType::UNDEFINED;
+      this->q_delta_expl = q_delta;
+      if (this->s_delta_expl.size() > 0) {
+        this->setup_q_delta();
+      }
+    }
+
+    template<typename time>
+    void IMEXSweeper<time>::set_implicit_q_delta(quadrature::QDeltaType type)
+    {
+      this->q_delta_impl_type = type;
+      if (this->s_delta_impl.size() > 0) {
+        this->setup_q_delta();
+      }
+    }
+
+    template<typename time>
+    void IMEXSweeper<time>::set_implicit_q_delta(const Matrix<time>& q_delta)
+    {
+      this->q_delta_impl_type = quadrature::QDeltaType::UNDEFINED;
+      this->q_delta_impl = q_delta;
+      if (this->s_delta_impl.size() > 0) {
+        this->setup_q_delta();
+      }
+    }
+
     template<typename time>
     void IMEXSweeper<time>::setup(bool coarse)
     {
@@ -29,22 +162,24 @@ namespace pfasst
       auto const num_nodes = this->quadrature->get_num_nodes();
       auto const num_s_integrals = this->quadrature->left_is_node() ? num_nodes - 1 : num_nodes;
 
-      for (size_t m = 0; m < num_nodes; m++) {
-        this->fs_expl.push_back(this->get_factory()->create(pfasst::encap::function));
-        this->fs_impl.push_back(this->get_factory()->create(pfasst::encap::function));
-      }
-      for (size_t m = 0; m < num_s_integrals; m++) {
-        this->s_integrals.push_back(this->get_factory()->create(pfasst::encap::solution));
-      }
+      this->fs_expl = this->get_factory()->create_block(pfasst::encap::function, num_nodes);
+      this->fs_impl = this->get_factory()->create_block(pfasst::encap::function, num_nodes);
+      this->s_integrals = this->get_factory()->create_block(pfasst::encap::solution, num_s_integrals);
 
       if (! this->quadrature->left_is_node()) {
         this->fs_expl_start = this->get_factory()->create(pfasst::encap::function);
       }
+
+      this->setup_q_delta();
     }
 
     template<typename time>
     void IMEXSweeper<time>::predict(bool initial)
     {
+      // the saved function values belong to the solution before this prediction
+      this->saved_function_values_valid = false;
+      this->begin_solves(true);
+
       if (this->quadrature->left_is_node()) {
         this->predict_with_left(initial);
       } else {
@@ -56,15 +191,49 @@ namespace pfasst
       } else {
         this->integrate_end_state(this->get_controller()->get_step_size());
       }
+
+      this->invalidate_integrals();
     }
 
     template<typename time>
     void IMEXSweeper<time>::sweep()
     {
-      if (this->quadrature->left_is_node()) {
-        this->sweep_with_left();
-      } else {
-        this->sweep_without_left();
+      auto const& nodes = this->quadrature->get_nodes();
+      auto const dt = this->get_controller()->get_step_size();
+      auto const t0 = this->get_controller()->get_time();
+      ML_CVLOG(1, "Sweeper", "sweeping on step " << this->get_controller()->get_step() + 1
+                             << " in iteration " << this->get_controller()->get_iteration()
+                             << " (dt=" << dt << ")");
+
+      this->begin_solves(false);
+      this->compute_s_integrals(dt);
+
+      shared_ptr<Encapsulation<time>> rhs = this->get_factory()->create(pfasst::encap::solution);
+
+      // step across all nodes; with the left node, the first one holds the initial value
+      const size_t first = this->quadrature->left_is_node() ? 1 : 0;
+      vector<time> a;
+      vector<shared_ptr<Encapsulation<time>>> x;
+      for (size_t n = first; n < nodes.size(); ++n) {
+        a = { 1.0, 1.0 };
+        x = { n == 0 ? this->start_state : this->state[n-1], this->s_integrals[n - first] };
+        for (size_t j = 0; j < n; ++j) {
+          if (this->s_delta_expl(n, j) != time(0.0)) {
+            a.push_back(dt * this->s_delta_expl(n, j));
+            x.push_back(this->fs_expl[j]);
+          }
+          if (this->s_delta_impl(n, j) != time(0.0)) {
+            a.push_back(dt * this->s_delta_impl(n, j));
+            x.push_back(this->fs_impl[j]);
+          }
+        }
+        rhs->lincomb(a, x);
+
+        auto const t = t0 + dt * nodes[n];
+        auto const ds = dt * this->s_delta_impl(n, n);
+        this->store_initial_guess(n, rhs, false);
+        this->impl_solve(this->fs_impl[n], this->state[n], t - ds, ds, rhs);
+        this->f_expl_eval(this->fs_expl[n], this->state[n], t);
       }
 
       if (this->quadrature->right_is_node()) {
@@ -72,22 +241,31 @@ namespace pfasst
       } else {
         this->integrate_end_state(this->get_controller()->get_step_size());
       }
+
+      this->invalidate_integrals();
     }
 
     template<typename time>
     void IMEXSweeper<time>::advance()
     {
+      this->invalidate_integrals();
+      this->saved_function_values_valid = false;
+
+      // the function values at the last node are recomputed in the next step, thus their slots
+      // are exchanged with the first node instead of copying values
       this->start_state->copy(this->end_state);
       if (this->quadrature->left_is_node() && this->quadrature->right_is_node()) {
         this->state[0]->copy(this->start_state);
-        this->fs_expl.front()->copy(this->fs_expl.back());
-        this->fs_impl.front()->copy(this->fs_impl.back());
+        std::swap(this->fs_expl.front(), this->fs_expl.back());
+        std::swap(this->fs_impl.front(), this->fs_impl.back());
       }
     }
 
     template<typename time>
     void IMEXSweeper<time>::reevaluate(bool initial_only)
     {
+      this->invalidate_integrals();
+
       time t0 = this->get_controller()->get_time();
       time dt = this->get_controller()->get_step_size();
       if (initial_only) {
@@ -98,39 +276,27 @@ namespace pfasst
           throw NotImplementedYet("reevaluate");
         }
       } else {
-        for (size_t m = 0; m < this->quadrature->get_num_nodes(); m++) {
-          time t =  t0 + dt * this->quadrature->get_nodes()[m];
-          this->f_expl_eval(this->fs_expl[m], this->state[m], t);
-          this->f_impl_eval(this->fs_impl[m], this->state[m], t);
+        vector<time> ts(this->quadrature->get_num_nodes());
+        for (size_t m = 0; m < ts.size(); m++) {
+          ts[m] = t0 + dt * this->quadrature->get_nodes()[m];
         }
+        this->f_expl_eval_all(this->fs_expl, this->state, ts);
+        this->f_impl_eval_all(this->fs_impl, this->state, ts);
       }
     }
 
     template<typename time>
-    void IMEXSweeper<time>::integrate(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const
+    vector<vector<shared_ptr<Encapsulation<time>>>> IMEXSweeper<time>::get_function_values() const
     {
-      auto const q_mat = this->quadrature->get_q_mat();
-      dst[0]->mat_apply(dst, dt, q_mat, this->fs_expl, true);
-      dst[0]->mat_apply(dst, dt, q_mat, this->fs_impl, false);
+      return { this->fs_expl, this->fs_impl };
     }
 
     template<typename time>
-    void IMEXSweeper<time>::residual(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const
+    void IMEXSweeper<time>::integrate(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const
     {
-      for (size_t m = 0; m < this->quadrature->get_num_nodes(); m++) {
-        dst[m]->copy(this->start_state);
-        dst[m]->saxpy(-1.0, this->state[m]);
-      }
-      if (this->fas_corrections.size() > 0) {
-        // XXX: build a matrix and use mat_apply to do this
-        for (size_t m = 0; m < this->quadrature->get_num_nodes(); m++) {
-          for (size_t n = 0; n <= m; n++) {
-            dst[m]->saxpy(1.0, this->fas_corrections[n]);
-          }
-        }
-      }
-      dst[0]->mat_apply(dst, dt, this->quadrature->get_q_mat(), this->fs_expl, false);
-      dst[0]->mat_apply(dst, dt, this->quadrature->get_q_mat(), this->fs_impl, false);
+      auto const q_mat = this->quadrature->get_q_mat();
+      dst[0]->mat_apply(dst, dt, q_mat, this->fs_expl, true);
+      dst[0]->mat_apply(dst, dt, q_mat, this->fs_impl, false);
     }
 
     template<typename time>
@@ -151,6 +317,28 @@ namespace pfasst
       throw NotImplementedYet("imex (f_impl_eval)");
     }
 
+    template<typename time>
+    void IMEXSweeper<time>::f_expl_eval_all(const vector<shared_ptr<Encapsulation<time>>>& f_expl_encaps,
+                                            const vector<shared_ptr<Encapsulation<time>>>& u_encaps,
+                                            const vector<time>& ts)
+    {
+      assert(f_expl_encaps.size() >= u_encaps.size() && ts.size() == u_encaps.size());
+      for (size_t m = 0; m < u_encaps.size(); m++) {
+        this->f_expl_eval(f_expl_encaps[m], u_encaps[m], ts[m]);
+      }
+    }
+
+    template<typename time>
+    void IMEXSweeper<time>::f_impl_eval_all(const vector<shared_ptr<Encapsulation<time>>>& f_impl_encaps,
+                                            const vector<shared_ptr<Encapsulation<time>>>& u_encaps,
+                                            const vector<time>& ts)
+    {
+      assert(f_impl_encaps.size() >= u_encaps.size() && ts.size() == u_encaps.size());
+      for (size_t m = 0; m < u_encaps.size(); m++) {
+        this->f_impl_eval(f_impl_encaps[m], u_encaps[m], ts[m]);
+      }
+    }
+
     template<typename time>
     void IMEXSweeper<time>::impl_solve(shared_ptr<Encapsulation<time>> f_encap,
                                        shared_ptr<Encapsulation<time>> u_encap,
@@ -177,13 +365,13 @@ namespace pfasst
 
       shared_ptr<Encapsulation<time>> rhs = this->get_factory()->create(pfasst::encap::solution);
 
-      auto const nodes = this->quadrature->get_nodes();
+      auto const& nodes = this->quadrature->get_nodes();
 
       // step across all nodes
       for (size_t m = 0; m < nodes.size() - 1; ++m) {
         time ds = dt * (nodes[m+1] - nodes[m]);
-        rhs->copy(this->state[m]);
-        rhs->saxpy(ds, this->fs_expl[m]);
+        rhs->lincomb({ 1.0, ds }, { this->state[m], this->fs_expl[m] });
+        this->store_initial_guess(m + 1, rhs, true);
         this->impl_solve(this->fs_impl[m + 1], this->state[m + 1], t, ds, rhs);
         this->f_expl_eval(this->fs_expl[m + 1], this->state[m + 1], t + ds);
         t += ds;
@@ -202,111 +390,21 @@ namespace pfasst
 
       shared_ptr<Encapsulation<time>> rhs = this->get_factory()->create(pfasst::encap::solution);
 
-      auto const nodes = this->quadrature->get_nodes();
-
-      // step to first node
-      ds = dt * nodes[0];
-      this->f_expl_eval(this->fs_expl_start, this->start_state, t);
-      rhs->copy(this->start_state);
-      rhs->saxpy(ds, this->fs_expl_start);
-      this->impl_solve(this->fs_impl[0], this->state[0], t, ds, rhs);
-      this->f_expl_eval(this->fs_expl[0], this->state[0], t + ds);
-
-      // step across all nodes
-      for (size_t m = 0; m < nodes.size() - 1; ++m) {
-        ds = dt * (nodes[m+1] - nodes[m]);
-        rhs->copy(this->state[m]);
-        rhs->saxpy(ds, this->fs_expl[m]);
-        this->impl_solve(this->fs_impl[m+1], this->state[m+1], t, ds, rhs);
-        this->f_expl_eval(this->fs_expl[m+1], this->state[m+1], t + ds);
-        t += ds;
-      }
-    }
-
-    template<typename time>
-    void IMEXSweeper<time>::sweep_with_left()
-    {
-      auto const nodes = this->quadrature->get_nodes();
-      auto const dt    = this->get_controller()->get_step_size();
-      auto const s_mat = this->quadrature->get_s_mat().block(1, 0, nodes.size()-1, nodes.size());
-      ML_CVLOG(1, "Sweeper", "sweeping on step " << this->get_controller()->get_step() + 1
-                             << " in iteration " << this->get_controller()->get_iteration()
-                             << " (dt=" << dt << ")");
-      time ds;
-
-      this->s_integrals[0]->mat_apply(this->s_integrals, dt, s_mat, this->fs_expl, true);
-      this->s_integrals[0]->mat_apply(this->s_integrals, dt, s_mat, this->fs_impl, false);
-      for (size_t m = 0; m < nodes.size() - 1; ++m) {
-        ds = dt * (nodes[m+1] - nodes[m]);
-        this->s_integrals[m]->saxpy(-ds, this->fs_expl[m]);
-        this->s_integrals[m]->saxpy(-ds, this->fs_impl[m+1]);
-      }
-      if (this->fas_corrections.size() > 0) {
-        for (size_t m = 0; m < this->s_integrals.size(); m++) {
-          this->s_integrals[m]->saxpy(1.0, this->fas_corrections[m+1]);
-        }
-      }
-
-      shared_ptr<Encapsulation<time>> rhs = this->get_factory()->create(pfasst::encap::solution);
-
-      // step across all nodes
-      auto t = this->get_controller()->get_time();
-      for (size_t m = 0; m < nodes.size() - 1; ++m) {
-        ds = dt * (nodes[m+1] - nodes[m]);
-        rhs->copy(this->state[m]);
-        rhs->saxpy(ds, this->fs_expl[m]);
-        rhs->saxpy(1.0, this->s_integrals[m]);
-        this->impl_solve(this->fs_impl[m + 1], this->state[m + 1], t, ds, rhs);
-        this->f_expl_eval(this->fs_expl[m + 1], this->state[m + 1], t + ds);
-        t += ds;
-      }
-    }
-
-    template<typename time>
-    void IMEXSweeper<time>::sweep_without_left()
-    {
-      auto const nodes = this->quadrature->get_nodes();
-      auto const dt    = this->get_controller()->get_step_size();
-      auto const s_mat = this->quadrature->get_s_mat();
-      ML_CVLOG(1, "Sweeper", "sweeping on step " << this->get_controller()->get_step() + 1
-                             << " in iteration " << this->get_controller()->get_iteration()
-                             << " (dt=" << dt << ")");
-      time ds;
-
-      this->s_integrals[0]->mat_apply(this->s_integrals, dt, s_mat, this->fs_expl, true);
-      this->s_integrals[0]->mat_apply(this->s_integrals, dt, s_mat, this->fs_impl, false);
-      ds = dt * nodes[0];
-      this->s_integrals[0]->saxpy(-ds, this->fs_expl_start);
-      this->s_integrals[0]->saxpy(-ds, this->fs_impl[0]);
-      for (size_t m = 0; m < nodes.size() - 1; ++m) {
-        ds = dt * (nodes[m+1] - nodes[m]);
-        this->s_integrals[m+1]->saxpy(-ds, this->fs_expl[m]);
-        this->s_integrals[m+1]->saxpy(-ds, this->fs_impl[m+1]);
-      }
-      if (this->fas_corrections.size() > 0) {
-        for (size_t m = 0; m < this->s_integrals.size(); m++) {
-          this->s_integrals[m]->saxpy(1.0, this->fas_corrections[m]);
-        }
-      }
-
-      shared_ptr<Encapsulation<time>> rhs = this->get_factory()->create(pfasst::encap::solution);
+      auto const& nodes = this->quadrature->get_nodes();
 
       // step to first node
-      auto t = this->get_controller()->get_time();
       ds = dt * nodes[0];
       this->f_expl_eval(this->fs_expl_start, this->start_state, t);
-      rhs->copy(this->start_state);
-      rhs->saxpy(ds, this->fs_expl_start);
-      rhs->saxpy(1.0, this->s_integrals[0]);
+      rhs->lincomb({ 1.0, ds }, { this->start_state, this->fs_expl_start });
+      this->store_initial_guess(0, rhs, true);
       this->impl_solve(this->fs_impl[0], this->state[0], t, ds, rhs);
       this->f_expl_eval(this->fs_expl[0], this->state[0], t + ds);
 
       // step across all nodes
       for (size_t m = 0; m < nodes.size() - 1; ++m) {
         ds = dt * (nodes[m+1] - nodes[m]);
-        rhs->copy(this->state[m]);
-        rhs->saxpy(ds, this->fs_expl[m]);
-        rhs->saxpy(1.0, this->s_integrals[m+1]);
+        rhs->lincomb({ 1.0, ds }, { this->state[m], this->fs_expl[m] });
+        this->store_initial_guess(m + 1, rhs, true);
         this->impl_solve(this->fs_impl[m+1], this->state[m+1], t, ds, rhs);
         this->f_expl_eval(this->fs_expl[m+1], this->state[m+1], t + ds);
         t += ds;
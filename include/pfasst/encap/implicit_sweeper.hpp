@@ -36,12 +36,57 @@ namespace pfasst
          * iteration.
          */
         vector<shared_ptr<Encapsulation<time>>> fs_impl;
+
+        /**
+         * Matrices mapping the function values and FAS corrections onto #integrals.
+         *
+         * Index `1` holds the variant based on the '0 to node' integrals (see
+         * EncapSweeper::get_q_integrals()), index `0` the one applying \\( S \\) directly.
+         * Built on first use and whenever the step size changes.
+         */
+        Matrix<time> integrals_mat[2];
+        time integrals_mat_dt[2];
         //! @}
 
-        Matrix<time> q_tilde;
+        //! @{
+        /**
+         * Preconditioner \\( Q_\\Delta \\) of the sweeps.
+         *
+         * Computed in setup() from the type unless given explicitly.
+         * The default pfasst::quadrature::QDeltaType::EulerLU takes backward Euler steps from node
+         * to node and uses \\( \\tilde{Q} \\), i.e. \\( U^T \\) of the LU decomposition of
+         * \\( Q^T \\), for the terms of the previous nodes.
+         */
+        quadrature::QDeltaType q_delta_type = quadrature::QDeltaType::EulerLU;
+        Matrix<time> q_delta;
+
+        /**
+         * Node-to-node form of the preconditioner, i.e. the differences of consecutive rows of
+         * #q_delta.
+         */
+        Matrix<time> s_delta;
+        //! @}
 
         void set_end_state();
 
+        /**
+         * Computes the 'node to node' integrals minus the \\( Q_\\Delta \\) terms of the
+         * previous iteration plus the accumulated FAS corrections with a single matrix
+         * application.
+         */
+        virtual void compute_integrals(time dt);
+
+        /**
+         * Computes the preconditioner from its type, checks it and derives #s_delta.
+         *
+         * Drops the matrices built from the previous preconditioner (#integrals_mat and
+         * EncapSweeper::residual_mat).
+         *
+         * @throws ValueError if a given \\( Q_\\Delta \\) does not match the quadrature or is not
+         *   lower triangular
+         */
+        virtual void setup_q_delta();
+
       public:
         //! @{
         ImplicitSweeper() = default;
@@ -49,8 +94,29 @@ namespace pfasst
         //! @}
 
         //! @{
+        /**
+         * Selects the preconditioner of the sweeps.
+         *
+         * If called after setup(), the preconditioner is set up right away (see setup_q_delta()).
+         * Defaults to pfasst::quadrature::QDeltaType::EulerLU (see #q_delta_type).
+         *
+         * @param[in] type type of \\( Q_\\Delta \\)
+         */
+        virtual void set_q_delta(quadrature::QDeltaType type);
+
+        /**
+         * Sets the preconditioner of the sweeps to a custom matrix, e.g. the Butcher matrix of a
+         * diagonally implicit Runge-Kutta method with the quadrature nodes as stages.
+         *
+         * @param[in] q_delta lower triangular matrix of the size of \\( Q \\)
+         */
+        virtual void set_q_delta(const Matrix<time>& q_delta);
+
         /**
          * @copydoc ISweeper::setup(bool)
+         *
+         * @throws ValueError if a given \\( Q_\\Delta \\) does not match the quadrature or is not
+         *   lower triangular
          */
         virtual void setup(bool coarse) override;
 
@@ -68,7 +134,13 @@ namespace pfasst
          * Perform one SDC sweep/iteration.
          *
          * This computes a high-order solution from the previous iteration's function values and
-         * corrects it using forward/backward Euler steps across the nodes.
+         * corrects it with the preconditioner \\( Q_\\Delta \\) node by node.
+         *
+         * The 'node to node' integrals are taken as differences of the '0 to node' integrals if
+         * these are still available from computing the residual after the previous sweep (see
+         * EncapSweeper::get_q_integrals()).
+         * Together with the FAS corrections they are computed by one matrix application (see
+         * compute_integrals()).
          */
         virtual void sweep() override;
 
@@ -89,6 +161,11 @@ namespace pfasst
          * @param[in,out] dst integrated values; will get zeroed out beforehand
          */
         virtual void integrate(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const override;
+
+        /**
+         * @copybrief EncapSweeper::get_function_values()
+         */
+        virtual vector<vector<shared_ptr<Encapsulation<time>>>> get_function_values() const override;
         //! @}
 
         //! @{
@@ -113,6 +190,21 @@ namespace pfasst
           throw NotImplementedYet("implicit (f_impl_eval)");
         }
 
+        /**
+         * Evaluate the implicit part of the ODE at several time points at once.
+         *
+         * Called by reevaluate() for all collocation nodes.
+         * The default calls f_impl_eval() for each time point; derived sweepers may override it to
+         * batch the evaluations (e.g. a single vectorized kernel across all nodes).
+         *
+         * @param[in,out] f_impl_encaps Encapsulations to store the implicit function evaluations.
+         * @param[in] u_encaps Encapsulations storing the solution states at which to evaluate.
+         * @param[in] ts Time points of the evaluations; one per element of @p u_encaps.
+         */
+        virtual void f_impl_eval_all(const vector<shared_ptr<Encapsulation<time>>>& f_impl_encaps,
+                                     const vector<shared_ptr<Encapsulation<time>>>& u_encaps,
+                                     const vector<time>& ts);
+
         /**
          * Solve \\( U - \\Delta t F_{\\rm impl}(U) = RHS \\) for \\( U \\).
          *
@@ -120,10 +212,15 @@ namespace pfasst
          * stepper.  This routine (implemented by the user) performs the solve required to perform
          * one backward-Euler sub-step, and also returns \\( F_{\\rm impl}(U) \\).
          *
+         * Iterative solvers should stop at the tolerance of get_solver_context(), if set, and
+         * report their iterations via record_solve().
+         *
          * @param[in,out] f_encap Encapsulation to store the evaluated implicit piece.
-         * @param[in,out] u_encap Encapsulation to store the solution of the backward-Euler sub-step.
-         * @param[in] t time point (of \\( RHS \\)).
-         * @param[in] dt sub-step size to the previous time point (\\( \\Delta t \\)).
+         * @param[in,out] u_encap Encapsulation to store the solution of the backward-Euler sub-step;
+         *   holds the initial guess on entry (see EncapSweeper::set_initial_guess()).
+         * @param[in] t time point (of \\( RHS \\)); the solution is sought at \\( t + \\Delta t \\).
+         * @param[in] dt sub-step size to the previous time point (\\( \\Delta t \\)); in a sweep
+         *   the step size times the diagonal entry of \\( Q_\\Delta \\).
          * @param[in] rhs_encap Encapsulation that stores \\( RHS \\).
          *
          * @note This method must be implemented in derived sweepers.
@@ -11,51 +11,6 @@ namespace pfasst
 {
   namespace encap
   {
-    template<typename scalar>
-    using lu_pair = pair< Matrix<scalar>, Matrix<scalar> >;
-
-    /**
-     * LU (without pivoting) decomposition.
-     */
-    template<typename scalar>
-    static lu_pair<scalar> lu_decomposition(const Matrix<scalar>& A)
-    {
-      assert(A.rows() == A.cols());
-
-      auto n = A.rows();
-
-      Matrix<scalar> L = Matrix<scalar>::Zero(n, n);
-      Matrix<scalar> U = Matrix<scalar>::Zero(n, n);
-
-      if (A.rows() == 1) {
-
-        L(0, 0) = 1.0;
-        U(0, 0) = A(0,0);
-
-      } else {
-
-        // first row of U is first row of A
-        auto U12 = A.block(0, 1, 1, n-1);
-
-        // first column of L is first column of A / a11
-        auto L21 = A.block(1, 0, n-1, 1) / A(0, 0);
-
-        // remove first row and column and recurse
-        auto A22  = A.block(1, 1, n-1, n-1);
-        Matrix<scalar> tmp = A22 - L21 * U12;
-        auto LU22 = lu_decomposition(tmp);
-
-        L(0, 0) = 1.0;
-        U(0, 0) = A(0, 0);
-        L.block(1, 0, n-1, 1) = L21;
-        U.block(0, 1, 1, n-1) = U12;
-        L.block(1, 1, n-1, n-1) = get<0>(LU22);
-        U.block(1, 1, n-1, n-1) = get<1>(LU22);
-      }
-
-      return lu_pair<scalar>(L, U);
-    }
-
     /**
      * Augment nodes: nodes <- [t0] + dt * nodes
      */
@@ -86,12 +41,103 @@ namespace pfasst
       }
     }
 
+    template<typename time>
+    void ImplicitSweeper<time>::compute_integrals(time dt)
+    {
+      auto const& s_mat = this->quadrature->get_s_mat();
+      const size_t num_nodes = this->integrals.size();
+      const bool fas = this->fas_corrections.size() > 0;
+      const bool from_q = this->has_q_integrals(dt);
+
+      // columns: [ dt Q F | F_impl | tau ], first block if needed
+      const size_t c_impl = from_q ? num_nodes : 0;
+      const size_t c_tau = c_impl + num_nodes;
+      const size_t num_cols = c_tau + (fas ? num_nodes : 0);
+
+      Matrix<time>& mat = this->integrals_mat[from_q ? 1 : 0];
+      time& mat_dt = this->integrals_mat_dt[from_q ? 1 : 0];
+      if (size_t(mat.cols()) != num_cols || mat_dt != dt) {
+        mat = Matrix<time>::Zero(num_nodes, num_cols);
+        for (size_t m = 0; m < num_nodes; m++) {
+          if (from_q) {
+            // S F is the difference of consecutive rows of Q F
+            mat(m, m) = 1.0;
+            if (m > 0) { mat(m, m - 1) = -1.0; }
+          } else {
+            for (size_t j = 0; j < num_nodes; j++) {
+              mat(m, c_impl + j) = dt * s_mat(m, j);
+            }
+          }
+          // preconditioner terms of the previous iteration
+          for (size_t j = 0; j <= m; j++) {
+            mat(m, c_impl + j) -= dt * this->s_delta(m, j);
+          }
+          for (size_t n = 0; fas && n < m; n++) {
+            mat(m, c_tau + n) = 1.0;
+          }
+        }
+        mat_dt = dt;
+      }
+
+      vector<shared_ptr<Encapsulation<time>>> src;
+      if (from_q) {
+        auto const& q_int = this->get_q_integrals(dt);
+        src.insert(src.end(), q_int.begin(), q_int.end());
+      }
+      src.insert(src.end(), this->fs_impl.begin(), this->fs_impl.end());
+      if (fas) {
+        src.insert(src.end(), this->fas_corrections.begin(), this->fas_corrections.end());
+      }
+
+      this->integrals[0]->mat_apply(this->integrals, 1.0, mat, src, true);
+    }
+
+    template<typename time>
+    void ImplicitSweeper<time>::setup_q_delta()
+    {
+      auto const num_nodes = this->quadrature->get_num_nodes();
+
+      if (this->q_delta_type != quadrature::QDeltaType::UNDEFINED) {
+        this->q_delta = quadrature::compute_q_delta(*(this->quadrature), this->q_delta_type);
+      }
+      if (size_t(this->q_delta.rows()) != num_nodes || size_t(this->q_delta.cols()) != num_nodes) {
+        throw ValueError("Q_delta must have the size of the quadrature matrix");
+      }
+      if (!this->q_delta.isLowerTriangular()) {
+        throw ValueError("Q_delta must be lower triangular");
+      }
+      this->s_delta = quadrature::compute_s_matrix(this->q_delta);
+      ML_CLOG(DEBUG, "Sweeper", "Q_delta:" << endl << this->q_delta);
+      for (auto& mat : this->integrals_mat) {
+        mat.resize(0, 0);
+      }
+      this->residual_mat.resize(0, 0);
+    }
+
+    template<typename time>
+    void ImplicitSweeper<time>::set_q_delta(quadrature::QDeltaType type)
+    {
+      this->q_delta_type = type;
+      if (this->s_delta.size() > 0) {
+        this->setup_q_delta();
+      }
+    }
+
+    template<typename time>
+    void ImplicitSweeper<time>::set_q_delta(const Matrix<time>& q_delta)
+    {
+      this->q_delta_type = quadrature::QDeltaType::UNDEFINED;
+      this->q_delta = q_delta;
+      if (this->s_delta.size() > 0) {
+        this->setup_q_delta();
+      }
+    }
+
     template<typename time>
     void ImplicitSweeper<time>::setup(bool coarse)
     {
       pfasst::encap::EncapSweeper<time>::setup(coarse);
 
-      auto const nodes = this->quadrature->get_nodes();
       auto const num_nodes = this->quadrature->get_num_nodes();
 
       if (this->quadrature->left_is_node()) {
@@ -99,22 +145,10 @@ namespace pfasst
         throw ValueError("implicit sweeper shouldn't include left endpoint");
       }
 
-      for (size_t m = 0; m < num_nodes; m++) {
-        this->integrals.push_back(this->get_factory()->create(pfasst::encap::solution));
-        this->fs_impl.push_back(this->get_factory()->create(pfasst::encap::function));
-      }
-
-      Matrix<time> QT = this->quadrature->get_q_mat().transpose();
-      auto lu = lu_decomposition(QT);
-      auto L = get<0>(lu);
-      auto U = get<1>(lu);
-      this->q_tilde = U.transpose();
+      this->integrals = this->get_factory()->create_block(pfasst::encap::solution, num_nodes);
+      this->fs_impl = this->get_factory()->create_block(pfasst::encap::function, num_nodes);
 
-      ML_CLOG(DEBUG, "Sweeper", "Q^T':" << endl << QT);
-      ML_CLOG(DEBUG, "Sweeper", "L:" << endl << L);
-      ML_CLOG(DEBUG, "Sweeper", "U:" << endl << U);
-      ML_CLOG(DEBUG, "Sweeper", "LU:" << endl << L * U);
-      ML_CLOG(DEBUG, "Sweeper", "q_tilde:" << endl << this->q_tilde);
+      this->setup_q_delta();
     }
 
     template<typename time>
@@ -128,13 +162,19 @@ namespace pfasst
       ML_CLOG(DEBUG, "Sweeper", "predicting step " << this->get_controller()->get_step() + 1
                                << " (t=" << t << ", dt=" << dt << ")");
 
+      // the saved function values belong to the solution before this prediction
+      this->saved_function_values_valid = false;
+      this->begin_solves(true);
+
       auto const anodes = augment(t, dt, this->quadrature->get_nodes());
       for (size_t m = 0; m < anodes.size() - 1; ++m) {
-        this->impl_solve(this->fs_impl[m], this->state[m], anodes[m], anodes[m+1] - anodes[m],
-                         m == 0 ? this->get_start_state() : this->state[m-1]);
+        auto const rhs = (m == 0) ? this->get_start_state() : this->state[m-1];
+        this->store_initial_guess(m, rhs, true);
+        this->impl_solve(this->fs_impl[m], this->state[m], anodes[m], anodes[m+1] - anodes[m], rhs);
       }
 
       this->set_end_state();
+      this->invalidate_integrals();
     }
 
     template<typename time>
@@ -147,40 +187,39 @@ namespace pfasst
                                << " in iteration " << this->get_controller()->get_iteration()
                                << " (dt=" << dt << ")");
 
-      this->integrals[0]->mat_apply(this->integrals, dt, this->quadrature->get_s_mat(), this->fs_impl, true);
-      if (this->fas_corrections.size() > 0) {
-        for (size_t m = 0; m < this->integrals.size(); m++) {
-          for (size_t n = 0; n < m; n++) {
-            this->integrals[m]->saxpy(1.0, this->fas_corrections[n]);
-          }
-        }
-      }
-
-      for (size_t m = 0; m < this->integrals.size(); m++) {
-        for (size_t n = 0; n < m; n++) {
-          this->integrals[m]->saxpy(-dt*this->q_tilde(m, n), this->fs_impl[n]);
-        }
-      }
+      this->begin_solves(false);
+      this->compute_integrals(dt);
 
       shared_ptr<Encapsulation<time>> rhs = this->get_factory()->create(pfasst::encap::solution);
 
-      auto const anodes = augment(t, dt, this->quadrature->get_nodes());
-      for (size_t m = 0; m < anodes.size() - 1; ++m) {
-        auto const ds = anodes[m+1] - anodes[m];
-        rhs->copy(m == 0 ? this->get_start_state() : this->state[m-1]);
-        rhs->saxpy(1.0, this->integrals[m]);
-        rhs->saxpy(-ds, this->fs_impl[m]);
+      auto const& nodes = this->quadrature->get_nodes();
+      vector<time> a;
+      vector<shared_ptr<Encapsulation<time>>> x;
+      for (size_t m = 0; m < nodes.size(); ++m) {
+        a = { 1.0, 1.0 };
+        x = { m == 0 ? this->get_start_state() : this->state[m-1], this->integrals[m] };
         for (size_t n = 0; n < m; n++) {
-          rhs->saxpy(dt*this->q_tilde(m, n), this->fs_impl[n]);
+          if (this->s_delta(m, n) != time(0.0)) {
+            a.push_back(dt * this->s_delta(m, n));
+            x.push_back(this->fs_impl[n]);
+          }
         }
-        this->impl_solve(this->fs_impl[m], this->state[m], anodes[m], ds, rhs);
+        rhs->lincomb(a, x);
+
+        auto const tm = t + dt * nodes[m];
+        auto const ds = dt * this->s_delta(m, m);
+        this->store_initial_guess(m, rhs, false);
+        this->impl_solve(this->fs_impl[m], this->state[m], tm - ds, ds, rhs);
       }
       this->set_end_state();
+      this->invalidate_integrals();
     }
 
     template<typename time>
     void ImplicitSweeper<time>::advance()
     {
+      this->invalidate_integrals();
+      this->saved_function_values_valid = false;
       this->start_state->copy(this->end_state);
     }
 
@@ -190,12 +229,33 @@ namespace pfasst
       if (initial_only) {
         return;
       }
+      this->invalidate_integrals();
+
       auto const dt = this->get_controller()->get_step_size();
       auto const t0 = this->get_controller()->get_time();
-      auto const nodes = this->quadrature->get_nodes();
+      auto const& nodes = this->quadrature->get_nodes();
+      vector<time> ts(nodes.size());
       for (size_t m = 0; m < nodes.size(); m++) {
-        this->f_impl_eval(this->fs_impl[m], this->state[m], t0 + dt * nodes[m]);
+        ts[m] = t0 + dt * nodes[m];
       }
+      this->f_impl_eval_all(this->fs_impl, this->state, ts);
+    }
+
+    template<typename time>
+    void ImplicitSweeper<time>::f_impl_eval_all(const vector<shared_ptr<Encapsulation<time>>>& f_impl_encaps,
+                                                const vector<shared_ptr<Encapsulation<time>>>& u_encaps,
+                                                const vector<time>& ts)
+    {
+      assert(f_impl_encaps.size() >= u_encaps.size() && ts.size() == u_encaps.size());
+      for (size_t m = 0; m < u_encaps.size(); m++) {
+        this->f_impl_eval(f_impl_encaps[m], u_encaps[m], ts[m]);
+      }
+    }
+
+    template<typename time>
+    vector<vector<shared_ptr<Encapsulation<time>>>> ImplicitSweeper<time>::get_function_values() const
+    {
+      return { this->fs_impl };
     }
 
     template<typename time>
@@ -0,0 +1,219 @@
+/**
+ * @file pfasst/encap/inexact_solve.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__ENCAP__INEXACT_SOLVE_HPP_
+#define _PFASST__ENCAP__INEXACT_SOLVE_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+using namespace std;
+
+#include "pfasst/globals.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    /**
+     * Initial guesses of the implicit solves of a sweep.
+     *
+     * Before calling `impl_solve()`, sweepers store the initial guess in the encapsulation to
+     * solve for, where iterative solvers should start from.
+     *
+     * @see EncapSweeper::set_initial_guess()
+     * @since v0.6.0
+     */
+    enum class InitialGuess : int {
+        PreviousIterate = 0  //!< value of the previous iteration at the same node
+      , Extrapolation   = 1  //!< linear extrapolation from the two previous nodes of the same sweep
+      , RHS             = 2  //!< right hand side of the implicit system
+    };
+
+
+    /**
+     * State of the SDC iteration handed to the implicit solves of a sweep.
+     *
+     * Filled by the sweepers before calling `impl_solve()` and available there through
+     * EncapSweeper::get_solver_context().
+     *
+     * @tparam time precision type of the time dimension
+     * @since v0.6.0
+     */
+    template<typename time = time_precision>
+    struct SolverContext
+    {
+      //! Step and SDC iteration of the controller the solves belong to.
+      size_t step, iteration;
+
+      //! Whether the solves belong to the predictor, i.e. there is no previous iterate.
+      bool predict;
+
+      /**
+       * Maximum norm over all nodes of the SDC residual of the previous iterate.
+       *
+       * Negative if not known, e.g. in the predictor.
+       */
+      time residual;
+
+      /**
+       * Tolerance requested for the inner solver.
+       *
+       * Zero if no pfasst::encap::InexactSolvePolicy is set, in which case the solver is expected to
+       * use its own tolerance.
+       */
+      time tolerance;
+
+      SolverContext()
+        :   step(0)
+          , iteration(0)
+          , predict(true)
+          , residual(-1.0)
+          , tolerance(0.0)
+      {}
+    };
+
+
+    /**
+     * Counters of the inner solves of a sweeper.
+     *
+     * Updated by the implementations of `impl_solve()` via EncapSweeper::record_solve().
+     *
+     * @tparam time precision type of the time dimension
+     * @since v0.6.0
+     */
+    template<typename time = time_precision>
+    struct SolverStatistics
+    {
+      //! Number of calls to `impl_solve()`.
+      size_t num_solves;
+
+      //! Total and maximum number of inner iterations of a single call.
+      size_t num_iterations, max_iterations;
+
+      //! Number of calls which did not reach the requested tolerance.
+      size_t num_failures;
+
+      //! Number of inner iterations and final residual of the last call.
+      size_t last_iterations;
+      time last_residual;
+
+      SolverStatistics()
+      {
+        this->reset();
+      }
+
+      void reset()
+      {
+        this->num_solves = 0;
+        this->num_iterations = 0;
+        this->max_iterations = 0;
+        this->num_failures = 0;
+        this->last_iterations = 0;
+        this->last_residual = 0.0;
+      }
+
+      /**
+       * Records a single call of `impl_solve()`.
+       *
+       * @param[in] iterations number of inner iterations
+       * @param[in] residual final residual (or update) of the inner iteration
+       * @param[in] converged whether the requested tolerance has been reached
+       */
+      void add(size_t iterations, time residual, bool converged)
+      {
+        this->num_solves++;
+        this->num_iterations += iterations;
+        this->max_iterations = std::max(this->max_iterations, iterations);
+        if (!converged) {
+          this->num_failures++;
+        }
+        this->last_iterations = iterations;
+        this->last_residual = residual;
+      }
+    };
+
+
+    /**
+     * Couples the tolerances of the inner solves to the progress of the SDC iteration.
+     *
+     * Solving the implicit systems of early sweeps more accurately than the error of the current
+     * iterate is wasted effort.
+     * Following the idea of inexact SDC (Speck et al.), the inner tolerance is
+     * \\[
+     * \\mathrm{tol} = \\max\\left(\\mathrm{tol}_{\\min}, \\min\\left(\\mathrm{tol}_{\\max},
+     *   \\eta \\|r^k\\|\\right)\\right)
+     * \\]
+     * with the SDC residual \\( r^k \\) of the previous iterate.
+     * If the residual is not known, the tolerance is reduced geometrically with the iteration
+     * index instead, starting from \\( \\mathrm{tol}_{\\max} \\) in the predictor.
+     *
+     * @tparam time precision type of the time dimension
+     * @since v0.6.0
+     */
+    template<typename time = time_precision>
+    class InexactSolvePolicy
+    {
+      protected:
+        //! @{
+        time min_tol;
+        time max_tol;
+        time factor;
+        time reduction;
+        bool use_residual;
+        //! @}
+
+      public:
+        //! @{
+        /**
+         * @param[in] min_tol tolerance of the final iterations, i.e. the tolerance of an exact
+         *   solve
+         * @param[in] max_tol loosest tolerance used, e.g. in the predictor
+         * @param[in] factor \\( \\eta \\), ratio of inner tolerance and SDC residual
+         * @param[in] reduction factor the tolerance is reduced by per iteration if the residual is
+         *   not known
+         * @param[in] use_residual whether the sweeper should provide the SDC residual; if `false`,
+         *   only the iteration index is used and no residuals are computed for this purpose
+         */
+        InexactSolvePolicy(time min_tol, time max_tol = 1e-2, time factor = 1e-1,
+                           time reduction = 1e-1, bool use_residual = true)
+          :   min_tol(min_tol)
+            , max_tol(std::max(min_tol, max_tol))
+            , factor(factor)
+            , reduction(reduction)
+            , use_residual(use_residual)
+        {}
+
+        virtual ~InexactSolvePolicy() = default;
+        //! @}
+
+        //! @{
+        //! Whether tolerance() benefits from SolverContext::residual.
+        virtual bool needs_residual() const
+        {
+          return this->use_residual;
+        }
+
+        /**
+         * Tolerance of the inner solves in the given state of the SDC iteration.
+         */
+        virtual time tolerance(const SolverContext<time>& context) const
+        {
+          time tol = this->max_tol;
+          if (context.predict) {
+            return tol;
+          } else if (context.residual >= time(0.0)) {
+            tol = this->factor * context.residual;
+          } else {
+            tol = this->max_tol * std::pow(this->reduction, time(context.iteration));
+          }
+          return std::max(this->min_tol, std::min(this->max_tol, tol));
+        }
+        //! @}
+    };
+  }  // ::pfasst::encap
+}  // ::pfasst
+
+#endif  // _PFASST__ENCAP__INEXACT_SOLVE_HPP_
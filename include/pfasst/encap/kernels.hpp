@@ -0,0 +1,492 @@
+/**
+ * @file pfasst/encap/kernels.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__ENCAP__KERNELS_HPP_
+#define _PFASST__ENCAP__KERNELS_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+#include "pfasst/encap/parallel.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    /**
+     * Low-level numerical kernels operating on contiguous arrays of values.
+     *
+     * These are the building blocks of the arithmetic of array-like encapsulations such as
+     * pfasst::encap::VectorEncapsulation.
+     * They are written to be auto-vectorized by the compiler and do not allocate any heap memory.
+     * Large arrays are split into chunks processed by separate threads (see
+     * pfasst::encap::parallel).
+     *
+     * @since v0.6.0
+     */
+    namespace kernels
+    {
+      /**
+       * Type of the coefficients multiplied onto values of type @p scalar.
+       *
+       * For real valued data the coefficients are converted into the data type up-front, for
+       * complex valued data they stay real (i.e. of type @p time) to avoid complex
+       * multiplications.
+       */
+      template<typename scalar, typename time>
+      using coeff_type = typename conditional<is_arithmetic<scalar>::value, scalar, time>::type;
+
+      /**
+       * Number of values processed per tile of a blocked kernel.
+       *
+       * A tile of all source vectors of a typical collocation matrix plus one accumulator tile
+       * fits into the L1 cache of current CPUs.
+       */
+      static const size_t TILE_SIZE = 128;
+      static_assert(TILE_SIZE == parallel::CHUNK_GRAIN, "chunks must consist of whole tiles");
+
+      /**
+       * Largest number of source vectors with a specialized (fully unrolled) tile kernel.
+       *
+       * Covers the `Q`, `S` and `B` matrices of up to 18 nodes and the FAS matrix
+       * (`[ -Q_crse | R Q_fine ]`) of up to 9 coarse nodes.
+       */
+      static const size_t MAX_UNROLLED_SOURCES = 18;
+
+      /**
+       * Scratch array living on the stack for up to @p N elements and on the heap beyond.
+       *
+       * Used for the per-call pointer and coefficient arrays of the kernels to avoid heap
+       * allocations for the usual (small) number of collocation nodes.
+       */
+      template<typename T, size_t N>
+      class ScratchArray
+      {
+        protected:
+          T local[N];
+          vector<T> heap;
+          T* ptr;
+
+        public:
+          explicit ScratchArray(const size_t n)
+            : ptr(local)
+          {
+            if (n > N) {
+              this->heap.resize(n);
+              this->ptr = this->heap.data();
+            }
+          }
+
+          ScratchArray(const ScratchArray<T, N>&) = delete;
+          void operator=(const ScratchArray<T, N>&) = delete;
+
+          T* data() { return this->ptr; }
+          T& operator[](const size_t i) { return this->ptr[i]; }
+      };
+
+      /**
+       * Accumulates one row of a matrix-vector product onto a tile.
+       *
+       * Computes \\( acc_i = acc_i + \\sum_m c_m src_{m,i} \\) for \\( i = 0, \\dots, len-1 \\)
+       * with the sum over \\( m \\) evaluated in ascending order.
+       * The number of sources is a compile time constant, thus the sum is unrolled and each
+       * accumulator stays in a register while all sources are streamed through.
+       */
+      template<size_t NSRC, typename scalar, typename coeff>
+      inline void tile_row(scalar* acc, const coeff* c, const scalar* const* src,
+                           const size_t offset, const size_t len)
+      {
+        for (size_t i = 0; i < len; ++i) {
+          scalar value = acc[i];
+          for (size_t m = 0; m < NSRC; ++m) {
+            value += c[m] * src[m][offset + i];
+          }
+          acc[i] = value;
+        }
+      }
+
+      /**
+       * Generic variant of tile_row() for arbitrary many sources.
+       *
+       * Vanishing coefficients are skipped.
+       */
+      template<typename scalar, typename coeff>
+      inline void tile_row(scalar* acc, const coeff* c, const scalar* const* src,
+                           const size_t nsrc, const size_t offset, const size_t len)
+      {
+        for (size_t m = 0; m < nsrc; ++m) {
+          const coeff cm = c[m];
+          if (cm == coeff(0.0)) { continue; }
+          const scalar* s = src[m] + offset;
+          for (size_t i = 0; i < len; ++i) {
+            acc[i] += cm * s[i];
+          }
+        }
+      }
+
+      /**
+       * Dispatches a row of a tile to the unrolled kernel matching the number of sources.
+       */
+      template<size_t NSRC>
+      struct TileDispatch
+      {
+        template<typename scalar, typename coeff>
+        static inline void row(scalar* acc, const coeff* c, const scalar* const* src,
+                               const size_t nsrc, const size_t offset, const size_t len)
+        {
+          if (nsrc == NSRC) {
+            tile_row<NSRC>(acc, c, src, offset, len);
+          } else {
+            TileDispatch<NSRC - 1>::row(acc, c, src, nsrc, offset, len);
+          }
+        }
+      };
+
+      template<>
+      struct TileDispatch<0>
+      {
+        template<typename scalar, typename coeff>
+        static inline void row(scalar* acc, const coeff* c, const scalar* const* src,
+                               const size_t nsrc, const size_t offset, const size_t len)
+        {
+          tile_row(acc, c, src, nsrc, offset, len);
+        }
+      };
+
+      /**
+       * Cache-blocked matrix application onto arrays of values.
+       *
+       * Computes \\( dst_n = [dst_n +] \\sum_m c_{n,m} src_m \\) for all \\( n \\) where
+       * @p c is a row-major `ndst x nsrc` matrix of (already scaled) coefficients.
+       *
+       * The index range is processed in tiles of TILE_SIZE values.
+       * Within a tile every destination row is accumulated in a local buffer, thus the sources
+       * are read once from memory per tile (and from cache for all further destination rows)
+       * and each destination is written exactly once.
+       *
+       * For each value the products are summed up in ascending order of the source index, which
+       * gives results identical to the naive triple loop.
+       * Large arrays are split into chunks of whole tiles processed by separate threads; as each
+       * value is still computed by a single thread, the results do not depend on the number of
+       * threads.
+       *
+       * @param[in,out] dst   pointers to the `ndst` destination arrays
+       * @param[in]     c     row-major coefficient matrix
+       * @param[in]     src   pointers to the `nsrc` source arrays
+       * @param[in]     ndofs number of values per array
+       * @param[in]     zero  whether to overwrite (`true`) or add onto (`false`) @p dst
+       *
+       * @note No destination array must alias any of the source arrays.
+       */
+      template<typename scalar, typename coeff>
+      inline void mat_apply(scalar* const* dst, const size_t ndst,
+                            const coeff* c,
+                            const scalar* const* src, const size_t nsrc,
+                            const size_t ndofs, const bool zero)
+      {
+        parallel::for_chunks(ndofs, [&](size_t, size_t begin, size_t end) {
+          scalar acc[TILE_SIZE];
+
+          for (size_t offset = begin; offset < end; offset += TILE_SIZE) {
+            const size_t len = min(TILE_SIZE, end - offset);
+
+            for (size_t n = 0; n < ndst; ++n) {
+              scalar* d = dst[n] + offset;
+              if (zero) {
+                std::fill(acc, acc + len, scalar(0.0));
+              } else {
+                std::copy(d, d + len, acc);
+              }
+
+              TileDispatch<MAX_UNROLLED_SOURCES>::row(acc, c + n * nsrc, src, nsrc, offset, len);
+
+              std::copy(acc, acc + len, d);
+            }
+          }
+        });
+      }
+
+      /**
+       * Fused linear combination of arrays of values.
+       *
+       * Computes \\( dst = [dst +] \\sum_m c_m src_m \\) in a single pass over memory with the
+       * terms added in ascending order of \\( m \\), which gives results identical to a copy of
+       * the first (unit weighted) source followed by one `saxpy` per further source.
+       *
+       * @param[in,out] dst   destination array
+       * @param[in]     c     the `nsrc` coefficients
+       * @param[in]     src   pointers to the `nsrc` source arrays
+       * @param[in]     ndofs number of values per array
+       * @param[in]     zero  whether to overwrite (`true`) or add onto (`false`) @p dst
+       *
+       * @note As each tile is read completely before it is written, @p dst may be one of the
+       *   sources.
+       */
+      template<typename scalar, typename coeff>
+      inline void lincomb(scalar* dst, const coeff* c,
+                          const scalar* const* src, const size_t nsrc,
+                          const size_t ndofs, const bool zero)
+      {
+        const size_t first = (zero && nsrc > 0) ? 1 : 0;
+
+        parallel::for_chunks(ndofs, [&](size_t, size_t begin, size_t end) {
+          scalar acc[TILE_SIZE];
+
+          for (size_t offset = begin; offset < end; offset += TILE_SIZE) {
+            const size_t len = min(TILE_SIZE, end - offset);
+            scalar* d = dst + offset;
+
+            if (!zero) {
+              std::copy(d, d + len, acc);
+            } else if (nsrc > 0) {
+              const scalar* s = src[0] + offset;
+              for (size_t i = 0; i < len; ++i) {
+                acc[i] = c[0] * s[i];
+              }
+            } else {
+              std::fill(acc, acc + len, scalar(0.0));
+            }
+
+            TileDispatch<MAX_UNROLLED_SOURCES>::row(acc, c + first, src + first, nsrc - first,
+                                                    offset, len);
+
+            std::copy(acc, acc + len, d);
+          }
+        });
+      }
+
+      /**
+       * Sets all values of an array to @p value.
+       */
+      template<typename scalar>
+      inline void fill(scalar* dst, const size_t n, const scalar value)
+      {
+        parallel::for_chunks(n, [=](size_t, size_t begin, size_t end) {
+          std::fill(dst + begin, dst + end, value);
+        });
+      }
+
+      /**
+       * Copies an array of values; the arrays must not overlap.
+       */
+      template<typename scalar>
+      inline void copy(scalar* dst, const scalar* src, const size_t n)
+      {
+        parallel::for_chunks(n, [=](size_t, size_t begin, size_t end) {
+          std::copy(src + begin, src + end, dst + begin);
+        });
+      }
+
+      /**
+       * Computes \\( dst = dst + a src \\).
+       */
+      template<typename scalar, typename coeff>
+      inline void axpy(scalar* dst, const coeff a, const scalar* src, const size_t n)
+      {
+        parallel::for_chunks(n, [=](size_t, size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            dst[i] += a * src[i];
+          }
+        });
+      }
+
+      /**
+       * Number of independent partial results of the reductions below.
+       *
+       * Splitting a reduction into independent chains allows the compiler to keep them in
+       * separate (vector) registers and hides the latency of the additions.
+       */
+      static const size_t REDUCTION_LANES = 4;
+
+      /**
+       * Serial sum of `op(x_i)` over an array of values using REDUCTION_LANES partial sums.
+       */
+      template<typename real, typename scalar, typename UnaryOp>
+      inline real reduce_sum_chunk(const scalar* x, const size_t n, UnaryOp op)
+      {
+        real acc[REDUCTION_LANES] = {};
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+          for (size_t l = 0; l < REDUCTION_LANES; ++l) {
+            acc[l] += op(x[i + l]);
+          }
+        }
+        for (; i < n; ++i) {
+          acc[0] += op(x[i]);
+        }
+
+        real sum = real(0.0);
+        for (size_t l = 0; l < REDUCTION_LANES; ++l) {
+          sum += acc[l];
+        }
+        return sum;
+      }
+
+      /**
+       * Larger of two values; NaN if either of them is NaN.
+       *
+       * Unlike `std::max()`, which drops a NaN in its second argument, this lets a NaN in the
+       * values propagate to their maximum norm.
+       */
+      template<typename real>
+      inline real nan_max(const real a, const real b)
+      {
+        return (a > b || a != a) ? a : b;
+      }
+
+      /**
+       * Serial largest absolute value of an array of values; `0` for an empty array and NaN if
+       * any of the values is NaN.
+       */
+      template<typename real, typename scalar>
+      inline real max_abs_chunk(const scalar* x, const size_t n)
+      {
+        real acc[REDUCTION_LANES] = {};
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+          for (size_t l = 0; l < REDUCTION_LANES; ++l) {
+            acc[l] = nan_max(acc[l], real(std::abs(x[i + l])));
+          }
+        }
+        for (; i < n; ++i) {
+          acc[0] = nan_max(acc[0], real(std::abs(x[i])));
+        }
+
+        real result = acc[0];
+        for (size_t l = 1; l < REDUCTION_LANES; ++l) {
+          result = nan_max(result, acc[l]);
+        }
+        return result;
+      }
+
+      /**
+       * Sum of `op(x_i)` over an array of values.
+       *
+       * Each chunk of the array is summed up using REDUCTION_LANES partial sums; the results of
+       * the chunks are added up in ascending order afterwards.
+       *
+       * @note The order of summation differs from a plain loop and depends on the number of
+       *   threads, thus results may differ in the last bits.
+       */
+      template<typename real, typename scalar, typename UnaryOp>
+      inline real reduce_sum(const scalar* x, const size_t n, UnaryOp op)
+      {
+        if (n == 0) {
+          return real(0.0);
+        }
+
+        ScratchArray<real, 64> partial(parallel::num_chunks(n));
+        const size_t nchunks = parallel::for_chunks(n, [&](size_t k, size_t begin, size_t end) {
+          partial[k] = reduce_sum_chunk<real>(x + begin, end - begin, op);
+        });
+
+        real sum = partial[0];
+        for (size_t k = 1; k < nchunks; ++k) {
+          sum += partial[k];
+        }
+        return sum;
+      }
+
+      /**
+       * Largest absolute value of an array of values; `0` for an empty array and NaN if any of
+       * the values is NaN.
+       */
+      template<typename real, typename scalar>
+      inline real max_abs(const scalar* x, const size_t n)
+      {
+        if (n == 0) {
+          return real(0.0);
+        }
+
+        ScratchArray<real, 64> partial(parallel::num_chunks(n));
+        const size_t nchunks = parallel::for_chunks(n, [&](size_t k, size_t begin, size_t end) {
+          partial[k] = max_abs_chunk<real>(x + begin, end - begin);
+        });
+
+        real result = partial[0];
+        for (size_t k = 1; k < nchunks; ++k) {
+          result = nan_max(result, partial[k]);
+        }
+        return result;
+      }
+
+      /**
+       * Sum of absolute values of an array of values.
+       */
+      template<typename real, typename scalar>
+      inline real sum_abs(const scalar* x, const size_t n)
+      {
+        return reduce_sum<real>(x, n, [](const scalar& v) { return real(std::abs(v)); });
+      }
+
+      /**
+       * Sum of squared absolute values of an array of values.
+       */
+      template<typename real, typename scalar>
+      inline real sum_sq_abs(const scalar* x, const size_t n)
+      {
+        return reduce_sum<real>(x, n, [](const scalar& v) { return real(std::norm(v)); });
+      }
+
+      /**
+       * Serial real part of \\( \\sum_i \\bar{x}_i y_i \\) using REDUCTION_LANES partial sums.
+       */
+      template<typename real, typename scalar>
+      inline real dot_chunk(const scalar* x, const scalar* y, const size_t n)
+      {
+        real acc[REDUCTION_LANES] = {};
+        size_t i = 0;
+        for (; i + REDUCTION_LANES <= n; i += REDUCTION_LANES) {
+          for (size_t l = 0; l < REDUCTION_LANES; ++l) {
+            acc[l] += real(std::real(x[i + l]) * std::real(y[i + l])
+                           + std::imag(x[i + l]) * std::imag(y[i + l]));
+          }
+        }
+        for (; i < n; ++i) {
+          acc[0] += real(std::real(x[i]) * std::real(y[i]) + std::imag(x[i]) * std::imag(y[i]));
+        }
+
+        real sum = real(0.0);
+        for (size_t l = 0; l < REDUCTION_LANES; ++l) {
+          sum += acc[l];
+        }
+        return sum;
+      }
+
+      /**
+       * Real part of the inner product \\( \\sum_i \\bar{x}_i y_i \\) of two arrays of values.
+       *
+       * For complex values, this is the Euclidean inner product of the real and imaginary parts.
+       * Summed up chunk-wise like reduce_sum().
+       */
+      template<typename real, typename scalar>
+      inline real dot(const scalar* x, const scalar* y, const size_t n)
+      {
+        if (n == 0) {
+          return real(0.0);
+        }
+
+        ScratchArray<real, 64> partial(parallel::num_chunks(n));
+        const size_t nchunks = parallel::for_chunks(n, [&](size_t k, size_t begin, size_t end) {
+          partial[k] = dot_chunk<real>(x + begin, y + begin, end - begin);
+        });
+
+        real sum = partial[0];
+        for (size_t k = 1; k < nchunks; ++k) {
+          sum += partial[k];
+        }
+        return sum;
+      }
+    }  // ::pfasst::encap::kernels
+  }  // ::pfasst::encap
+}  // ::pfasst
+
+#endif  // _PFASST__ENCAP__KERNELS_HPP_
@@ -0,0 +1,266 @@
+/**
+ * @file pfasst/encap/krylov_solver.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__ENCAP__KRYLOV_SOLVER_HPP_
+#define _PFASST__ENCAP__KRYLOV_SOLVER_HPP_
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include "pfasst/globals.hpp"
+#include "pfasst/encap/encapsulation.hpp"
+#include "pfasst/encap/implicit_sweeper.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    /**
+     * Krylov methods of pfasst::encap::KrylovSolverMixin.
+     *
+     * @since v0.6.0
+     */
+    enum class KrylovMethod : int {
+        GMRES = 0  //!< restarted GMRES with right preconditioning; for general operators
+      , CG    = 1  //!< preconditioned conjugate gradients; for symmetric positive definite operators
+    };
+
+
+    /**
+     * Matrix-free Newton-Krylov implementation of `impl_solve()`.
+     *
+     * Solves \\( G(U) = U - \\Delta t F(U) - RHS = 0 \\) with an inexact Newton iteration starting
+     * from the initial guess provided by the sweeper.
+     * The Newton corrections \\( S \\) are computed from
+     * \\[
+     * \\left( I - \\Delta t J(U) \\right) S = -G(U)
+     * \\]
+     * with a Krylov method (see set_krylov_method()) to the relative tolerance given by
+     * set_krylov_tolerance().
+     *
+     * The mixin only relies on the operations of pfasst::encap::Encapsulation (including
+     * Encapsulation::dot()) and on the `f_impl_eval()` of the sweeper; the operator is only ever
+     * applied to vectors, by apply_operator().
+     * Its default is Jacobian-free, approximating \\( J(U) S \\) by a finite difference of
+     * \\( F \\), and may be overridden by problems with a cheap Jacobian-vector product.
+     * A preconditioner is plugged in by overriding precondition().
+     *
+     * The Newton iteration stops once the maximum norm of \\( G(U) \\) drops below the tolerance of
+     * EncapSweeper::get_solver_context(), if set by a pfasst::encap::InexactSolvePolicy, or below
+     * the tolerance given by set_newton_tolerance() otherwise.
+     * The number of Krylov iterations of each solve is reported via EncapSweeper::record_solve().
+     *
+     * The mixin is put between a fully implicit sweeper and the problem specific sweeper, which
+     * then only implements `f_impl_eval()`:
+     *
+     * @code
+     * class HeatSweeper
+     *   : public KrylovSolverMixin<double, ImplicitSweeper<double>>
+     * {
+     *   public:
+     *     void f_impl_eval(shared_ptr<Encapsulation<double>> f, shared_ptr<Encapsulation<double>> u,
+     *                      double t) override;
+     * };
+     * @endcode
+     *
+     * Temporaries are created once per thread from the factory of the sweeper, thus the solves may
+     * run concurrently for different nodes (see pfasst::encap::ParallelNodesSweeper).
+     *
+     * @tparam time precision type of the time dimension
+     * @tparam base_sweeper sweeper calling `impl_solve()`, e.g. pfasst::encap::ImplicitSweeper,
+     *   pfasst::encap::IMEXSweeper or pfasst::encap::ParallelNodesSweeper
+     * @since v0.6.0
+     */
+    template<typename time = time_precision,
+             typename base_sweeper = ImplicitSweeper<time>>
+    class KrylovSolverMixin
+      : public base_sweeper
+    {
+      protected:
+        //! Temporaries of a single thread.
+        struct Workspace
+        {
+          //! Orthonormal basis of the Krylov space (GMRES only).
+          vector<shared_ptr<Encapsulation<time>>> basis;
+
+          //! @{
+          shared_ptr<Encapsulation<time>> residual;
+          shared_ptr<Encapsulation<time>> correction;
+          shared_ptr<Encapsulation<time>> direction;
+          shared_ptr<Encapsulation<time>> preconditioned;
+          shared_ptr<Encapsulation<time>> product;
+          //! @}
+
+          //! Perturbed state and its function value of the finite difference in apply_operator().
+          shared_ptr<Encapsulation<time>> perturbed, f_perturbed;
+        };
+
+        //! @{
+        KrylovMethod krylov_method;
+        size_t krylov_restart;
+        size_t krylov_maxit;
+        time krylov_tol;
+        size_t newton_maxit;
+        time newton_tol;
+
+        //! Step size of the finite difference in apply_operator(); `0` for the automatic choice.
+        time fd_step;
+
+        //! Workspaces indexed by the OpenMP thread number; created on first use.
+        vector<shared_ptr<Workspace>> workspaces;
+        //! @}
+
+        //! @{
+        /**
+         * Workspace of the calling thread.
+         */
+        virtual shared_ptr<Workspace> get_workspace();
+
+        /**
+         * Computes \\( b - (I - \\Delta t J(U)) x \\) for @p x and @p b.
+         */
+        virtual void linear_residual(shared_ptr<Encapsulation<time>> r,
+                                     shared_ptr<Encapsulation<time>> x,
+                                     shared_ptr<Encapsulation<time>> b,
+                                     shared_ptr<Encapsulation<time>> u,
+                                     shared_ptr<Encapsulation<time>> f_u,
+                                     time t, time dt);
+
+        /**
+         * Solves \\( (I - \\Delta t J(U)) x = b \\) with restarted, right preconditioned GMRES.
+         *
+         * @returns number of applications of the operator
+         */
+        virtual size_t gmres(shared_ptr<Encapsulation<time>> x,
+                             shared_ptr<Encapsulation<time>> b,
+                             shared_ptr<Encapsulation<time>> u,
+                             shared_ptr<Encapsulation<time>> f_u,
+                             time t, time dt);
+
+        /**
+         * Solves \\( (I - \\Delta t J(U)) x = b \\) with preconditioned conjugate gradients.
+         *
+         * Stops early if the operator turns out not to be positive definite.
+         *
+         * @returns number of applications of the operator
+         */
+        virtual size_t cg(shared_ptr<Encapsulation<time>> x,
+                          shared_ptr<Encapsulation<time>> b,
+                          shared_ptr<Encapsulation<time>> u,
+                          shared_ptr<Encapsulation<time>> f_u,
+                          time t, time dt);
+        //! @}
+
+      public:
+        //! @{
+        KrylovSolverMixin();
+        virtual ~KrylovSolverMixin() = default;
+        //! @}
+
+        //! @{
+        /**
+         * Selects the Krylov method of the Newton corrections.
+         *
+         * pfasst::encap::KrylovMethod::CG requires \\( I - \\Delta t J(U) \\) and the
+         * preconditioner to be symmetric and positive definite, e.g. for diffusion problems.
+         * Defaults to pfasst::encap::KrylovMethod::GMRES.
+         */
+        virtual void set_krylov_method(KrylovMethod method);
+
+        /**
+         * Sets the number of GMRES iterations between restarts, i.e. the size of the Krylov basis.
+         *
+         * Defaults to `20`.
+         */
+        virtual void set_krylov_restart(size_t restart);
+
+        /**
+         * Sets the stopping criterion of a single linear solve.
+         *
+         * @param[in] rtol reduction of the \\( l_2 \\) norm of the linear residual (the forcing term
+         *   of the inexact Newton iteration); defaults to `1e-3`
+         * @param[in] maxit maximum number of applications of the operator; defaults to `100`
+         */
+        virtual void set_krylov_tolerance(time rtol, size_t maxit);
+
+        /**
+         * Sets the stopping criterion of the Newton iteration.
+         *
+         * The tolerance is only used without a tolerance in EncapSweeper::get_solver_context().
+         *
+         * @param[in] tol maximum norm of \\( G(U) \\); defaults to `1e-12`
+         * @param[in] maxit maximum number of Newton iterations; defaults to `50`
+         */
+        virtual void set_newton_tolerance(time tol, size_t maxit);
+
+        /**
+         * Sets the step size of the finite difference in apply_operator().
+         *
+         * @param[in] step fixed step size; `0` (the default) chooses
+         *   \\( \\sqrt{\\epsilon} (1 + \\|U\\|_2) / \\|V\\|_2 \\)
+         */
+        virtual void set_fd_step(time step);
+        //! @}
+
+        //! @{
+        /**
+         * Computes \\( (I - \\Delta t J(U)) V \\), the operator of the Newton corrections.
+         *
+         * The default approximates the Jacobian-vector product by
+         * \\( J(U) V \\approx (F(U + \\varepsilon V) - F(U)) / \\varepsilon \\) at the cost of one
+         * evaluation of `f_impl_eval()`.
+         *
+         * @param[out] result Encapsulation to store the product.
+         * @param[in] v Encapsulation to multiply.
+         * @param[in] u current Newton iterate \\( U \\).
+         * @param[in] f_u function value \\( F(U) \\) at the current Newton iterate.
+         * @param[in] t time point of \\( U \\).
+         * @param[in] dt \\( \\Delta t \\) of the implicit solve.
+         */
+        virtual void apply_operator(shared_ptr<Encapsulation<time>> result,
+                                    shared_ptr<Encapsulation<time>> v,
+                                    shared_ptr<Encapsulation<time>> u,
+                                    shared_ptr<Encapsulation<time>> f_u,
+                                    time t, time dt);
+
+        /**
+         * Applies the preconditioner, an approximate inverse of \\( I - \\Delta t J(U) \\).
+         *
+         * The default is the identity.
+         *
+         * @param[out] dst Encapsulation to store the preconditioned values.
+         * @param[in] src Encapsulation to precondition.
+         * @param[in] u current Newton iterate \\( U \\).
+         * @param[in] t time point of \\( U \\).
+         * @param[in] dt \\( \\Delta t \\) of the implicit solve.
+         */
+        virtual void precondition(shared_ptr<Encapsulation<time>> dst,
+                                  shared_ptr<Encapsulation<time>> src,
+                                  shared_ptr<Encapsulation<time>> u,
+                                  time t, time dt);
+
+        /**
+         * Solve \\( U - \\Delta t F(U) = RHS \\) for \\( U \\) with the Newton-Krylov iteration.
+         *
+         * @param[in,out] f_encap Encapsulation to store the evaluated right hand side.
+         * @param[in,out] u_encap Encapsulation to store the solution; holds the initial guess on
+         *   entry.
+         * @param[in] t time point (of \\( RHS \\)); the solution is sought at \\( t + \\Delta t \\).
+         * @param[in] dt sub-step size (\\( \\Delta t \\)).
+         * @param[in] rhs_encap Encapsulation that stores \\( RHS \\).
+         */
+        virtual void impl_solve(shared_ptr<Encapsulation<time>> f_encap,
+                                shared_ptr<Encapsulation<time>> u_encap,
+                                time t, time dt,
+                                shared_ptr<Encapsulation<time>> rhs_encap) override;
+        //! @}
+    };
+  }  // ::pfasst::encap
+}  // ::pfasst
+
+#include "pfasst/encap/krylov_solver_impl.hpp"
+
+#endif  // _PFASST__ENCAP__KRYLOV_SOLVER_HPP_
@@ -0,0 +1,341 @@
+#include "pfasst/encap/krylov_solver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+using namespace std;
+
+#include "pfasst/globals.hpp"
+#include "pfasst/logging.hpp"
+#include "pfasst/encap/parallel.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    template<typename time, typename base_sweeper>
+    KrylovSolverMixin<time, base_sweeper>::KrylovSolverMixin()
+      :   base_sweeper()
+        , krylov_method(KrylovMethod::GMRES)
+        , krylov_restart(20)
+        , krylov_maxit(100)
+        , krylov_tol(1e-3)
+        , newton_maxit(50)
+        , newton_tol(1e-12)
+        , fd_step(0.0)
+    {}
+
+    template<typename time, typename base_sweeper>
+    shared_ptr<typename KrylovSolverMixin<time, base_sweeper>::Workspace>
+    KrylovSolverMixin<time, base_sweeper>::get_workspace()
+    {
+      const size_t thread = size_t(parallel::get_thread_num());
+      shared_ptr<Workspace> ws;
+
+      // the workspaces of all threads share one vector
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_krylov_workspace)
+#endif
+      {
+        if (this->workspaces.size() <= thread) {
+          this->workspaces.resize(thread + 1);
+        }
+        if (!this->workspaces[thread]) {
+          auto factory = this->get_factory();
+          ws = make_shared<Workspace>();
+          for (size_t i = 0; i < max(this->krylov_restart, size_t(1)) + 1; i++) {
+            ws->basis.push_back(factory->create(pfasst::encap::solution));
+          }
+          ws->residual = factory->create(pfasst::encap::solution);
+          ws->correction = factory->create(pfasst::encap::solution);
+          ws->direction = factory->create(pfasst::encap::solution);
+          ws->preconditioned = factory->create(pfasst::encap::solution);
+          ws->product = factory->create(pfasst::encap::solution);
+          ws->perturbed = factory->create(pfasst::encap::solution);
+          ws->f_perturbed = factory->create(pfasst::encap::function);
+          this->workspaces[thread] = ws;
+        } else {
+          ws = this->workspaces[thread];
+        }
+      }
+
+      return ws;
+    }
+
+    template<typename time, typename base_sweeper>
+    void KrylovSolverMixin<time, base_sweeper>::set_krylov_method(KrylovMethod method)
+    {
+      this->krylov_method = method;
+    }
+
+    template<typename time, typename base_sweeper>
+    void KrylovSolverMixin<time, base_sweeper>::set_krylov_restart(size_t restart)
+    {
+      this->krylov_restart = max(restart, size_t(1));
+      this->workspaces.clear();
+    }
+
+    template<typename time, typename base_sweeper>
+    void KrylovSolverMixin<time, base_sweeper>::set_krylov_tolerance(time rtol, size_t maxit)
+    {
+      this->krylov_tol = rtol;
+      this->krylov_maxit = maxit;
+    }
+
+    template<typename time, typename base_sweeper>
+    void KrylovSolverMixin<time, base_sweeper>::set_newton_tolerance(time tol, size_t maxit)
+    {
+      this->newton_tol = tol;
+      this->newton_maxit = maxit;
+    }
+
+    template<typename time, typename base_sweeper>
+    void KrylovSolverMixin<time, base_sweeper>::set_fd_step(time step)
+    {
+      this->fd_step = step;
+    }
+
+    template<typename time, typename base_sweeper>
+    void KrylovSolverMixin<time, base_sweeper>::apply_operator(shared_ptr<Encapsulation<time>> result,
+                                                               shared_ptr<Encapsulation<time>> v,
+                                                               shared_ptr<Encapsulation<time>> u,
+                                                               shared_ptr<Encapsulation<time>> f_u,
+                                                               time t, time dt)
+    {
+      const time v_norm = v->norm(l2_norm);
+      if (v_norm == time(0.0)) {
+        result->zero();
+        return;
+      }
+
+      const time eps = (this->fd_step > time(0.0))
+                       ? this->fd_step
+                       : std::sqrt(numeric_limits<time>::epsilon()) * (time(1.0) + u->norm(l2_norm)) / v_norm;
+
+      auto ws = this->get_workspace();
+      ws->perturbed->copy(u);
+      ws->perturbed->saxpy(eps, v);
+      this->f_impl_eval(ws->f_perturbed, ws->perturbed, t);
+
+      // (I - dt J) v ~ v - dt (F(u + eps v) - F(u)) / eps
+      result->lincomb({ time(1.0), -dt / eps, dt / eps }, { v, ws->f_perturbed, f_u });
+    }
+
+    template<typename time, typename base_sweeper>
+    void KrylovSolverMixin<time, base_sweeper>::precondition(shared_ptr<Encapsulation<time>> dst,
+                                                             shared_ptr<Encapsulation<time>> src,
+                                                             shared_ptr<Encapsulation<time>> u,
+                                                             time t, time dt)
+    {
+      UNUSED(u); UNUSED(t); UNUSED(dt);
+      dst->copy(src);
+    }
+
+    template<typename time, typename base_sweeper>
+    void KrylovSolverMixin<time, base_sweeper>::linear_residual(shared_ptr<Encapsulation<time>> r,
+                                                                shared_ptr<Encapsulation<time>> x,
+                                                                shared_ptr<Encapsulation<time>> b,
+                                                                shared_ptr<Encapsulation<time>> u,
+                                                                shared_ptr<Encapsulation<time>> f_u,
+                                                                time t, time dt)
+    {
+      auto ws = this->get_workspace();
+      this->apply_operator(ws->product, x, u, f_u, t, dt);
+      r->copy(b);
+      r->saxpy(-1.0, ws->product);
+    }
+
+    template<typename time, typename base_sweeper>
+    size_t KrylovSolverMixin<time, base_sweeper>::gmres(shared_ptr<Encapsulation<time>> x,
+                                                        shared_ptr<Encapsulation<time>> b,
+                                                        shared_ptr<Encapsulation<time>> u,
+                                                        shared_ptr<Encapsulation<time>> f_u,
+                                                        time t, time dt)
+    {
+      auto ws = this->get_workspace();
+      auto& v = ws->basis;
+      auto r = ws->direction;
+      const size_t m_max = v.size() - 1;
+
+      x->zero();
+      r->copy(b);
+      const time target = this->krylov_tol * b->norm(l2_norm);
+      size_t iter = 0;
+
+      while (iter < this->krylov_maxit) {
+        const time beta = r->norm(l2_norm);
+        if (beta <= target || beta == time(0.0)) {
+          break;
+        }
+
+        v[0]->zero();
+        v[0]->saxpy(time(1.0) / beta, r);
+
+        // Hessenberg matrix reduced to upper triangular form by Givens rotations
+        Matrix<time> h = Matrix<time>::Zero(m_max + 1, m_max);
+        vector<time> g(m_max + 1, time(0.0)), cs(m_max, time(0.0)), sn(m_max, time(0.0));
+        g[0] = beta;
+
+        size_t k = 0;
+        time res = beta;
+        while (k < m_max && iter < this->krylov_maxit) {
+          this->precondition(ws->preconditioned, v[k], u, t, dt);
+          this->apply_operator(ws->product, ws->preconditioned, u, f_u, t, dt);
+          iter++;
+
+          // modified Gram-Schmidt
+          for (size_t i = 0; i <= k; i++) {
+            h(i, k) = ws->product->dot(v[i]);
+            ws->product->saxpy(-h(i, k), v[i]);
+          }
+          h(k + 1, k) = ws->product->norm(l2_norm);
+          const bool breakdown = !(h(k + 1, k) > time(0.0));
+          if (!breakdown) {
+            v[k + 1]->zero();
+            v[k + 1]->saxpy(time(1.0) / h(k + 1, k), ws->product);
+          }
+
+          for (size_t i = 0; i < k; i++) {
+            const time tmp = cs[i] * h(i, k) + sn[i] * h(i + 1, k);
+            h(i + 1, k) = -sn[i] * h(i, k) + cs[i] * h(i + 1, k);
+            h(i, k) = tmp;
+          }
+          const time denom = std::hypot(h(k, k), h(k + 1, k));
+          if (denom == time(0.0)) {
+            // singular operator
+            break;
+          }
+          cs[k] = h(k, k) / denom;
+          sn[k] = h(k + 1, k) / denom;
+          h(k, k) = denom;
+          h(k + 1, k) = time(0.0);
+          g[k + 1] = -sn[k] * g[k];
+          g[k] = cs[k] * g[k];
+
+          res = std::abs(g[k + 1]);
+          k++;
+          if (res <= target || breakdown) {
+            break;
+          }
+        }
+
+        if (k == 0) {
+          break;
+        }
+
+        // x += M^{-1} V y with H y = g
+        vector<time> y(k);
+        for (size_t i = k; i-- > 0;) {
+          y[i] = g[i];
+          for (size_t j = i + 1; j < k; j++) {
+            y[i] -= h(i, j) * y[j];
+          }
+          y[i] /= h(i, i);
+        }
+        ws->product->lincomb(y, vector<shared_ptr<Encapsulation<time>>>(v.begin(), v.begin() + k));
+        this->precondition(ws->preconditioned, ws->product, u, t, dt);
+        x->saxpy(1.0, ws->preconditioned);
+
+        if (res <= target || iter >= this->krylov_maxit) {
+          break;
+        }
+        this->linear_residual(r, x, b, u, f_u, t, dt);
+        iter++;
+      }
+
+      return iter;
+    }
+
+    template<typename time, typename base_sweeper>
+    size_t KrylovSolverMixin<time, base_sweeper>::cg(shared_ptr<Encapsulation<time>> x,
+                                                     shared_ptr<Encapsulation<time>> b,
+                                                     shared_ptr<Encapsulation<time>> u,
+                                                     shared_ptr<Encapsulation<time>> f_u,
+                                                     time t, time dt)
+    {
+      auto ws = this->get_workspace();
+      auto r = ws->direction;
+      auto z = ws->preconditioned;
+      auto q = ws->product;
+      auto p = ws->basis[0];
+      auto p_next = ws->basis[1];
+
+      x->zero();
+      r->copy(b);
+      const time target = this->krylov_tol * b->norm(l2_norm);
+      size_t iter = 0;
+      if (!(r->norm(l2_norm) > target)) {
+        return iter;
+      }
+
+      this->precondition(z, r, u, t, dt);
+      p->copy(z);
+      time rz = r->dot(z);
+
+      while (iter < this->krylov_maxit) {
+        this->apply_operator(q, p, u, f_u, t, dt);
+        iter++;
+
+        const time pq = p->dot(q);
+        if (!(pq > time(0.0))) {
+          ML_CLOG(WARNING, "Sweeper", "operator of CG is not positive definite");
+          break;
+        }
+        const time alpha = rz / pq;
+        x->saxpy(alpha, p);
+        r->saxpy(-alpha, q);
+        if (r->norm(l2_norm) <= target) {
+          break;
+        }
+
+        this->precondition(z, r, u, t, dt);
+        const time rz_next = r->dot(z);
+        p_next->lincomb({ time(1.0), rz_next / rz }, { z, p });
+        std::swap(p, p_next);
+        rz = rz_next;
+      }
+
+      return iter;
+    }
+
+    template<typename time, typename base_sweeper>
+    void KrylovSolverMixin<time, base_sweeper>::impl_solve(shared_ptr<Encapsulation<time>> f_encap,
+                                                           shared_ptr<Encapsulation<time>> u_encap,
+                                                           time t, time dt,
+                                                           shared_ptr<Encapsulation<time>> rhs_encap)
+    {
+      auto ws = this->get_workspace();
+      auto const& context = this->get_solver_context();
+      const time tol = (context.tolerance > time(0.0)) ? context.tolerance : this->newton_tol;
+      const time t_new = t + dt;
+
+      // -G(U) = RHS + dt F(U) - U
+      auto neg_residual = [&]() {
+        this->f_impl_eval(f_encap, u_encap, t_new);
+        ws->residual->lincomb({ time(1.0), dt, time(-1.0) }, { rhs_encap, f_encap, u_encap });
+        return ws->residual->norm0();
+      };
+
+      time residual = neg_residual();
+      size_t newton_iter = 0, krylov_iter = 0;
+      while (residual > tol && newton_iter < this->newton_maxit) {
+        if (this->krylov_method == KrylovMethod::CG) {
+          krylov_iter += this->cg(ws->correction, ws->residual, u_encap, f_encap, t_new, dt);
+        } else {
+          krylov_iter += this->gmres(ws->correction, ws->residual, u_encap, f_encap, t_new, dt);
+        }
+        u_encap->saxpy(1.0, ws->correction);
+        newton_iter++;
+        residual = neg_residual();
+      }
+
+      const bool converged = residual <= tol;
+      this->record_solve(krylov_iter, residual, converged);
+      if (!converged) {
+        ML_CLOG(WARNING, "Sweeper", "Newton-Krylov did not converge in " << newton_iter
+                                    << " iterations: residual=" << residual << " tol=" << tol);
+      }
+    }
+  }  // ::pfasst::encap
+}  // ::pfasst
@@ -0,0 +1,92 @@
+/**
+ * @file pfasst/encap/mpi_buffer.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__ENCAP__MPI_BUFFER_HPP_
+#define _PFASST__ENCAP__MPI_BUFFER_HPP_
+
+#include <cassert>
+#include <cstddef>
+using namespace std;
+
+#include <mpi.h>
+
+#include "pfasst/interfaces.hpp"
+#include "pfasst/mpi_communicator.hpp"
+using namespace pfasst::mpi;
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    /**
+     * MPI communication of values stored in a single contiguous buffer.
+     *
+     * Encapsulations keeping their values in one buffer derive from this class and implement
+     * Encapsulation::post(), Encapsulation::recv(), Encapsulation::send() and
+     * Encapsulation::broadcast() by handing their buffer to the corresponding methods below.
+     * The values are sent as raw bytes without intermediate copies.
+     *
+     * @note The buffer of a pending send must outlive the request; derived classes complete it
+     *   with wait_send() before giving up the buffer (e.g. on destruction).
+     *
+     * @since v0.6.0
+     */
+    class MPIBuffer
+    {
+      public:
+        //! @{
+        MPI_Request recv_request = MPI_REQUEST_NULL;
+        MPI_Request send_request = MPI_REQUEST_NULL;
+        //! @}
+
+        //! @{
+        inline MPICommunicator& as_mpi(ICommunicator* comm)
+        {
+          auto mpi = dynamic_cast<MPICommunicator*>(comm);
+          assert(mpi);
+          return *mpi;
+        }
+        //! @}
+
+      protected:
+        //! @{
+        /**
+         * Completes the open send request, if any.
+         */
+        void wait_send();
+
+        /**
+         * Posts a non-blocking receive of @p bytes bytes from the previous rank into @p data.
+         *
+         * @throws MPIError if a previous receive request is still open
+         */
+        void post_buffer(ICommunicator* comm, int tag, void* data, size_t bytes);
+
+        /**
+         * Receives @p bytes bytes from the previous rank into @p data.
+         *
+         * The non-blocking variant waits for the receive posted by post_buffer().
+         */
+        void recv_buffer(ICommunicator* comm, int tag, bool blocking, void* data, size_t bytes);
+
+        /**
+         * Sends @p bytes bytes of @p data to the next rank.
+         *
+         * The non-blocking variant waits for the previous send request to finish first.
+         */
+        void send_buffer(ICommunicator* comm, int tag, bool blocking, void* data, size_t bytes);
+
+        /**
+         * Broadcasts @p bytes bytes of @p data from rank @p root.
+         */
+        void broadcast_buffer(ICommunicator* comm, int root, void* data, size_t bytes);
+        //! @}
+    };
+  }  // ::pfasst::encap
+}  // ::pfasst
+
+#include "pfasst/encap/mpi_buffer_impl.hpp"
+
+#endif  // _PFASST__ENCAP__MPI_BUFFER_HPP_
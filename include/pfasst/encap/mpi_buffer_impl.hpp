@@ -0,0 +1,99 @@
+#include "pfasst/encap/mpi_buffer.hpp"
+
+#include "pfasst/logging.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    inline void MPIBuffer::wait_send()
+    {
+      if (this->send_request != MPI_REQUEST_NULL) {
+        MPI_Status stat = MPI_Status_factory();
+        ML_CLOG(DEBUG, "Encap", "waiting for open send request");
+        int err = MPI_Wait(&(this->send_request), &stat);
+        check_mpi_error(err);
+        ML_CLOG(DEBUG, "Encap", "waited for open send request");
+      }
+    }
+
+    inline void MPIBuffer::post_buffer(ICommunicator* comm, int tag, void* data, size_t bytes)
+    {
+      auto& mpi = as_mpi(comm);
+      if (!mpi.has_previous()) { return; }
+
+      if (this->recv_request != MPI_REQUEST_NULL) {
+        throw MPIError("a previous receive request is still open");
+      }
+
+      int src = mpi.previous();
+      ML_CLOG(DEBUG, "Encap", "non-blocking receiving from rank " << src << " with tag=" << tag);
+      int err = MPI_Irecv(data, bytes, MPI_CHAR, src, tag, mpi.comm, &this->recv_request);
+      check_mpi_error(err);
+      ML_CLOG(DEBUG, "Encap", "non-blocking received from rank " << src << " with tag=" << tag);
+    }
+
+    inline void MPIBuffer::recv_buffer(ICommunicator* comm, int tag, bool blocking, void* data,
+                                       size_t bytes)
+    {
+      auto& mpi = as_mpi(comm);
+      if (!mpi.has_previous()) { return; }
+
+      MPI_Status stat = MPI_Status_factory();
+      int err = MPI_SUCCESS;
+
+      if (blocking) {
+        int src = mpi.previous();
+        ML_CLOG(DEBUG, "Encap", "blocking receive from rank " << src << " with tag=" << tag);
+        err = MPI_Recv(data, bytes, MPI_CHAR, src, tag, mpi.comm, &stat);
+        check_mpi_error(err);
+        ML_CLOG(DEBUG, "Encap", "received blocking from rank " << src << " with tag=" << tag << ": " << stat);
+      } else {
+        if (this->recv_request != MPI_REQUEST_NULL) {
+          ML_CLOG(DEBUG, "Encap", "waiting on last receive request");
+          err = MPI_Wait(&(this->recv_request), &stat);
+          check_mpi_error(err);
+          ML_CLOG(DEBUG, "Encap", "waited on last receive request: " << stat);
+        }
+      }
+    }
+
+    inline void MPIBuffer::send_buffer(ICommunicator* comm, int tag, bool blocking, void* data,
+                                       size_t bytes)
+    {
+      auto& mpi = as_mpi(comm);
+      if (!mpi.has_next()) { return; }
+
+      MPI_Status stat = MPI_Status_factory();
+      int err = MPI_SUCCESS;
+      int dest = mpi.next();
+
+      if (blocking) {
+        ML_CLOG(DEBUG, "Encap", "blocking send to rank " << dest << " with tag=" << tag);
+        err = MPI_Send(data, bytes, MPI_CHAR, dest, tag, mpi.comm);
+        check_mpi_error(err);
+        ML_CLOG(DEBUG, "Encap", "sent blocking to rank " << dest << " with tag=" << tag);
+      } else {
+        ML_CLOG(DEBUG, "Encap", "waiting on last send request to finish");
+        err = MPI_Wait(&(this->send_request), &stat);
+        check_mpi_error(err);
+        ML_CLOG(DEBUG, "Encap", "waited on last send request: " << stat);
+        ML_CLOG(DEBUG, "Encap", "non-blocking sending to rank " << dest << " with tag=" << tag);
+        err = MPI_Isend(data, bytes, MPI_CHAR, dest, tag, mpi.comm, &(this->send_request));
+        check_mpi_error(err);
+        ML_CLOG(DEBUG, "Encap", "sent non-blocking to rank " << dest << " with tag=" << tag);
+      }
+    }
+
+    inline void MPIBuffer::broadcast_buffer(ICommunicator* comm, int root, void* data,
+                                            size_t bytes)
+    {
+      auto& mpi = as_mpi(comm);
+      ML_CLOG(DEBUG, "Encap", "broadcasting from rank " << root);
+      int err = MPI_Bcast(data, bytes, MPI_CHAR, root, mpi.comm);
+      check_mpi_error(err);
+      ML_CLOG(DEBUG, "Encap", "broadcasted");
+    }
+  }  // ::pfasst::encap
+}  // ::pfasst
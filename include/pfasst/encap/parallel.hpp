@@ -0,0 +1,216 @@
+/**
+ * @file pfasst/encap/parallel.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__ENCAP__PARALLEL_HPP_
+#define _PFASST__ENCAP__PARALLEL_HPP_
+
+#include <algorithm>
+#include <cstddef>
+using namespace std;
+
+#ifdef WITH_OPENMP
+  #include <omp.h>
+#endif
+
+#include "pfasst/config.hpp"
+#include "pfasst/globals.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    /**
+     * Thread parallelism of the kernels operating on arrays of values.
+     *
+     * When built with OpenMP (i.e. with `WITH_OPENMP` defined, see the CMake option
+     * `pfasst_WITH_OPENMP`), large arrays are split among the threads of the OpenMP runtime,
+     * which are created once and shared by all kernels.
+     * Without OpenMP all functions here fall back to serial execution.
+     *
+     * Arrays are always split into the same contiguous chunks of whole tiles for a given array
+     * length and number of chunks (see fixed_num_chunks()).
+     * Hence, element-wise kernels give results identical to serial execution and each thread
+     * touches the same chunk of an array in every kernel.
+     *
+     * @since v0.6.0
+     */
+    namespace parallel
+    {
+      /**
+       * Number of values a chunk is a multiple of.
+       *
+       * Equals pfasst::encap::kernels::TILE_SIZE, so that chunks consist of whole tiles.
+       */
+      static const size_t CHUNK_GRAIN = 128;
+
+      /**
+       * Smallest number of values of an array for which a kernel is run in parallel.
+       *
+       * Smaller arrays are processed by the calling thread, as the fork-join overhead would
+       * exceed the gain.
+       */
+      inline size_t& min_parallel_size()
+      {
+        static size_t threshold = 32768;
+        return threshold;
+      }
+
+      /**
+       * Number of chunks large arrays are split into regardless of the number of threads.
+       *
+       * `0` (the default) splits them into one chunk per thread.
+       * Chunks are processed serially whenever they cannot be processed in parallel, so fixing
+       * their number gives the same partition (and the same rounding of reductions) with and
+       * without OpenMP.
+       */
+      inline size_t& fixed_num_chunks()
+      {
+        static size_t nchunks = 0;
+        return nchunks;
+      }
+
+      /**
+       * Number of threads used by the kernels; `1` without OpenMP.
+       */
+      inline int get_num_threads()
+      {
+#ifdef WITH_OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+      }
+
+      /**
+       * Index of the calling thread in the current OpenMP team; `0` without OpenMP.
+       */
+      inline int get_thread_num()
+      {
+#ifdef WITH_OPENMP
+        return omp_get_thread_num();
+#else
+        return 0;
+#endif
+      }
+
+      /**
+       * Sets the number of threads used by the kernels.
+       *
+       * Without OpenMP this has no effect.
+       *
+       * @param[in] num_threads number of threads; values smaller than `1` are ignored, i.e. the
+       *   OpenMP default (e.g. from `OMP_NUM_THREADS`) is kept
+       */
+      inline void set_num_threads(const int num_threads)
+      {
+#ifdef WITH_OPENMP
+        if (num_threads > 0) {
+          omp_set_num_threads(num_threads);
+        }
+#else
+        UNUSED(num_threads);
+#endif
+      }
+
+      /**
+       * Whether the calling thread is inside an OpenMP parallel region; `false` without OpenMP.
+       *
+       * Unlike `omp_in_parallel()` this includes inactive regions, e.g. those run by a team of a
+       * single thread; the kernels never open nested parallel regions.
+       */
+      inline bool in_parallel()
+      {
+#ifdef WITH_OPENMP
+        return omp_get_level() > 0;
+#else
+        return false;
+#endif
+      }
+
+      /**
+       * Reads the threading parameters from pfasst::config.
+       *
+       * Recognized parameters are `num_threads` (see set_num_threads()) and
+       * `min_parallel_size` (see min_parallel_size()).
+       * Called by pfasst::init().
+       */
+      inline void init_from_config()
+      {
+        set_num_threads(config::get_value<int>("num_threads", 0));
+        min_parallel_size() = config::get_value<size_t>("min_parallel_size", min_parallel_size());
+      }
+
+      /**
+       * Number of chunks an array of @p n values is split into.
+       *
+       * Is `1` for arrays smaller than min_parallel_size() and, unless fixed_num_chunks() is set,
+       * if the kernels run serially.
+       */
+      inline size_t num_chunks(const size_t n)
+      {
+        if (n < min_parallel_size()) {
+          return 1;
+        }
+        size_t nchunks = fixed_num_chunks();
+        if (nchunks == 0) {
+          nchunks = in_parallel() ? 1 : size_t(get_num_threads());
+        }
+        const size_t ngrains = (n + CHUNK_GRAIN - 1) / CHUNK_GRAIN;
+        return max(size_t(1), min(nchunks, ngrains));
+      }
+
+      /**
+       * Half-open index range of chunk @p k of @p nchunks of an array of @p n values.
+       */
+      inline void chunk_range(const size_t n, const size_t nchunks, const size_t k,
+                              size_t& begin, size_t& end)
+      {
+        const size_t ngrains = (n + CHUNK_GRAIN - 1) / CHUNK_GRAIN;
+        begin = min(n, (ngrains * k / nchunks) * CHUNK_GRAIN);
+        end = min(n, (ngrains * (k + 1) / nchunks) * CHUNK_GRAIN);
+      }
+
+      /**
+       * Calls `body(k, begin, end)` for each chunk `k` of an array of @p n values.
+       *
+       * The chunks are processed in parallel if there is more than one and the kernels are not
+       * called from within a parallel region (see in_parallel()); no chunk is empty.
+       *
+       * @returns number of chunks, i.e. the number of calls of @p body
+       */
+      template<typename Body>
+      inline size_t for_chunks(const size_t n, Body body)
+      {
+        const size_t nchunks = num_chunks(n);
+        if (nchunks == 1) {
+          if (n > 0) {
+            body(size_t(0), size_t(0), n);
+          }
+          return nchunks;
+        }
+
+#ifdef WITH_OPENMP
+        if (!in_parallel() && get_num_threads() > 1) {
+          #pragma omp parallel for schedule(static, 1) num_threads(int(nchunks))
+          for (long k = 0; k < long(nchunks); ++k) {
+            size_t begin, end;
+            chunk_range(n, nchunks, size_t(k), begin, end);
+            body(size_t(k), begin, end);
+          }
+          return nchunks;
+        }
+#endif
+        for (size_t k = 0; k < nchunks; ++k) {
+          size_t begin, end;
+          chunk_range(n, nchunks, k, begin, end);
+          body(k, begin, end);
+        }
+        return nchunks;
+      }
+    }  // ::pfasst::encap::parallel
+  }  // ::pfasst::encap
+}  // ::pfasst
+
+#endif  // _PFASST__ENCAP__PARALLEL_HPP_
@@ -0,0 +1,293 @@
+/**
+ * @file pfasst/encap/parallel_nodes_sweeper.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__ENCAP__PARALLEL_NODES_SWEEPER_HPP_
+#define _PFASST__ENCAP__PARALLEL_NODES_SWEEPER_HPP_
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include "pfasst/interfaces.hpp"
+#include "pfasst/quadrature.hpp"
+#include "pfasst/encap/encapsulation.hpp"
+#include "pfasst/encap/encap_sweeper.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    /**
+     * Implicit sweeper solving for all nodes concurrently.
+     *
+     * For ODEs \\( \\dot{U} = F(t,U) \\), each sweep solves
+     * \\[
+     * U_m^{k+1} - \\Delta t d_m F(U_m^{k+1})
+     *   = U_0 + \\Delta t \\left( Q F(U^k) \\right)_m - \\Delta t d_m F(U_m^k) + \\sum_{n \\leq m} \\tau_n
+     * \\]
+     * with a diagonal preconditioner \\( Q_\\Delta = \\mathrm{diag}(d_m) \\).
+     * As the right hand sides only depend on the previous iteration, the implicit solves and
+     * function evaluations of all nodes are independent of each other and are distributed
+     *
+     * - among the threads of the OpenMP runtime (when built with `WITH_OPENMP`; see
+     *   set_num_node_threads()) and
+     * - among the processes of a node communicator (see set_node_comm()), which is independent of
+     *   the communicator of the PFASST controller.
+     *
+     * Each process solves every `size`-th node and the results are broadcast to all other
+     * processes of the node communicator afterwards.
+     *
+     * The sweeper requires the same two routines as pfasst::encap::ImplicitSweeper, f_impl_eval()
+     * and impl_solve().
+     * As the nodes are solved for concurrently, there are no values of the current sweep to
+     * extrapolate from and pfasst::encap::InitialGuess::Extrapolation starts from the previous
+     * iterate.
+     * If more than one thread is used, they are called concurrently for different nodes and must
+     * be thread-safe; an exception thrown on any of the threads is rethrown once all threads are
+     * done.
+     *
+     * @tparam time precision type of the time dimension
+     * @since v0.6.0
+     */
+    template<typename time = time_precision>
+    class ParallelNodesSweeper
+      : public EncapSweeper<time>
+    {
+      protected:
+        //! @{
+        /**
+         * Right hand sides of the implicit solves of all nodes.
+         */
+        vector<shared_ptr<Encapsulation<time>>> rhs;
+
+        /**
+         * Values of the right hand side \\( F(t,u) \\) at all time nodes of the current
+         * iteration.
+         */
+        vector<shared_ptr<Encapsulation<time>>> fs_impl;
+
+        /**
+         * Matrix mapping \\( [U_0, \\Delta t Q F, F, \\tau] \\) onto #rhs.
+         *
+         * Built on first use and whenever the step size changes.
+         */
+        Matrix<time> rhs_mat;
+        time rhs_mat_dt;
+        //! @}
+
+        //! @{
+        /**
+         * Preconditioner \\( Q_\\Delta \\) of the sweeps; has to be diagonal.
+         *
+         * Computed in setup() from the type unless given explicitly.
+         */
+        quadrature::QDeltaType q_delta_type;
+        Matrix<time> q_delta;
+
+        //! Communicator distributing the nodes among processes; `nullptr` if not distributed.
+        ICommunicator* node_comm;
+
+        //! Number of threads working on the nodes of this process; `0` for the OpenMP default.
+        int num_node_threads;
+        //! @}
+
+        //! @{
+        //! Index of the first node solved for, i.e. `1` if the first node is the initial value.
+        size_t first_node() const;
+
+        //! Nodes solved for by this process, i.e. every `size`-th node (see set_node_comm()).
+        vector<size_t> local_nodes() const;
+
+        /**
+         * Calls `body(i)` for \\( i = 0, \\dots, n-1 \\), concurrently if more than one thread is
+         * used (see set_num_node_threads()).
+         *
+         * An exception thrown by @p body must not leave an OpenMP parallel region; the first one
+         * caught is rethrown once all threads are done.
+         */
+        template<typename Body>
+        void for_each_thread(size_t n, Body body);
+
+        /**
+         * Broadcasts the results of all nodes from the processes solving for them (see
+         * set_node_comm()).
+         *
+         * @param[in] with_state whether to broadcast the solution values as well as the function
+         *   values
+         */
+        void share_nodes(bool with_state);
+
+        /**
+         * Calls `body(m)` for all nodes \\( m \\) solved for by this process, concurrently if
+         * more than one thread is used, and broadcasts the results afterwards (see set_node_comm()).
+         *
+         * @param[in] body work on a single node
+         * @param[in] with_state whether to broadcast the solution values as well as the function
+         *   values
+         */
+        template<typename Body>
+        void for_nodes(Body body, bool with_state);
+
+        /**
+         * Computes the right hand sides and solves for all nodes.
+         */
+        virtual void solve_nodes();
+
+        /**
+         * Sets the end state from the values at the nodes.
+         */
+        virtual void set_end_state();
+        //! @}
+
+      public:
+        //! @{
+        ParallelNodesSweeper();
+        virtual ~ParallelNodesSweeper() = default;
+        //! @}
+
+        //! @{
+        /**
+         * Selects the preconditioner of the sweeps.
+         *
+         * Has to be called before setup().
+         * Defaults to pfasst::quadrature::QDeltaType::MIN.
+         *
+         * @param[in] type type of \\( Q_\\Delta \\); must result in a diagonal matrix
+         */
+        virtual void set_q_delta(quadrature::QDeltaType type);
+
+        /**
+         * Sets the preconditioner of the sweeps to a custom diagonal matrix.
+         *
+         * @param[in] q_delta diagonal matrix of the size of \\( Q \\)
+         */
+        virtual void set_q_delta(const Matrix<time>& q_delta);
+
+        /**
+         * Distributes the nodes among the processes of @p comm.
+         *
+         * @param[in] comm communicator of the processes sharing the work on the nodes of a single
+         *   time step; all its processes must run the same controller on the same time step
+         */
+        virtual void set_node_comm(ICommunicator* comm);
+
+        /**
+         * Sets the number of threads working on the nodes of this process.
+         *
+         * Without OpenMP this has no effect.
+         *
+         * @param[in] num_threads number of threads; `1` solves the nodes one after the other,
+         *   `0` uses the OpenMP default (see pfasst::encap::parallel::get_num_threads())
+         */
+        virtual void set_num_node_threads(int num_threads);
+        //! @}
+
+        //! @{
+        /**
+         * @copydoc ISweeper::setup(bool)
+         *
+         * @throws ValueError if \\( Q_\\Delta \\) does not match the quadrature or is not diagonal
+         */
+        virtual void setup(bool coarse) override;
+
+        /**
+         * Compute a provisional solution.
+         *
+         * Spreads the initial value and its function value to all nodes and performs one sweep
+         * on top.
+         *
+         * @param[in] initial unused; the function value at the initial value is always evaluated
+         */
+        virtual void predict(bool initial) override;
+
+        /**
+         * Perform one SDC sweep/iteration solving for all nodes concurrently.
+         *
+         * The '0 to node' integrals are reused if they are still available from computing the
+         * residual after the previous sweep (see EncapSweeper::get_q_integrals()).
+         */
+        virtual void sweep() override;
+
+        /**
+         * Advance the end solution to start solution.
+         */
+        virtual void advance() override;
+
+        /**
+         * @copybrief EncapSweeper::reevaluate()
+         */
+        virtual void reevaluate(bool initial_only) override;
+
+        /**
+         * @copybrief EncapSweeper::integrate()
+         *
+         * @param[in] dt width of time interval to integrate over
+         * @param[in,out] dst integrated values; will get zeroed out beforehand
+         */
+        virtual void integrate(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const override;
+
+        /**
+         * @copybrief EncapSweeper::get_function_values()
+         */
+        virtual vector<vector<shared_ptr<Encapsulation<time>>>> get_function_values() const override;
+        //! @}
+
+        //! @{
+        /**
+         * Evaluate the right hand side of the ODE.
+         *
+         * @param[in,out] f_impl_encap Encapsulation to store the function evaluation.
+         * @param[in] u_encap Encapsulation storing the solution state at which to evaluate.
+         * @param[in] t Time point of the evaluation.
+         *
+         * @note This method must be implemented in derived sweepers.
+         */
+        virtual void f_impl_eval(shared_ptr<Encapsulation<time>> f_impl_encap,
+                                 shared_ptr<Encapsulation<time>> u_encap,
+                                 time t);
+
+        /**
+         * Evaluate the right hand side of the ODE at several time points at once.
+         *
+         * Called by reevaluate() for the nodes solved for by this process (see set_node_comm()).
+         * The default calls f_impl_eval() for each time point on the threads of this process
+         * (see set_num_node_threads()); derived sweepers may override it to batch the evaluations.
+         *
+         * @param[in,out] f_impl_encaps Encapsulations to store the function evaluations.
+         * @param[in] u_encaps Encapsulations storing the solution states at which to evaluate.
+         * @param[in] ts Time points of the evaluations; one per element of @p u_encaps.
+         */
+        virtual void f_impl_eval_all(const vector<shared_ptr<Encapsulation<time>>>& f_impl_encaps,
+                                     const vector<shared_ptr<Encapsulation<time>>>& u_encaps,
+                                     const vector<time>& ts);
+
+        /**
+         * Solve \\( U - \\Delta t F(U) = RHS \\) for \\( U \\).
+         *
+         * Iterative solvers should stop at the tolerance of get_solver_context(), if set, and
+         * report their iterations via record_solve().
+         *
+         * @param[in,out] f_encap Encapsulation to store the evaluated right hand side.
+         * @param[in,out] u_encap Encapsulation to store the solution; holds the initial guess on
+         *   entry (see EncapSweeper::set_initial_guess()).
+         * @param[in] t time point (of \\( RHS \\)); the solution is sought at \\( t + \\Delta t \\).
+         * @param[in] dt the step size times the diagonal entry of \\( Q_\\Delta \\) of the node
+         *   (\\( \\Delta t \\)).
+         * @param[in] rhs_encap Encapsulation that stores \\( RHS \\).
+         *
+         * @note This method must be implemented in derived sweepers.
+         */
+        virtual void impl_solve(shared_ptr<Encapsulation<time>> f_encap,
+                                shared_ptr<Encapsulation<time>> u_encap,
+                                time t, time dt,
+                                shared_ptr<Encapsulation<time>> rhs_encap);
+        //! @}
+    };
+  }  // ::pfasst::encap
+}  // ::pfasst
+
+#include "pfasst/encap/parallel_nodes_sweeper_impl.hpp"
+
+#endif  // _PFASST__ENCAP__PARALLEL_NODES_SWEEPER_HPP_
@@ -0,0 +1,330 @@
+#include "pfasst/encap/parallel_nodes_sweeper.hpp"
+
+#include <cassert>
+#include <exception>
+using namespace std;
+
+#include "pfasst/globals.hpp"
+#include "pfasst/logging.hpp"
+#include "pfasst/encap/parallel.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    template<typename time>
+    ParallelNodesSweeper<time>::ParallelNodesSweeper()
+      :   EncapSweeper<time>()
+        , rhs_mat_dt(0.0)
+        , q_delta_type(quadrature::QDeltaType::MIN)
+        , node_comm(nullptr)
+        , num_node_threads(0)
+    {}
+
+    template<typename time>
+    size_t ParallelNodesSweeper<time>::first_node() const
+    {
+      return this->quadrature->left_is_node() ? 1 : 0;
+    }
+
+    template<typename time>
+    vector<size_t> ParallelNodesSweeper<time>::local_nodes() const
+    {
+      const size_t num_nodes = this->quadrature->get_num_nodes();
+      const size_t rank = this->node_comm ? size_t(this->node_comm->rank()) : 0;
+      const size_t size = this->node_comm ? size_t(this->node_comm->size()) : 1;
+
+      vector<size_t> mine;
+      for (size_t m = this->first_node() + rank; m < num_nodes; m += size) {
+        mine.push_back(m);
+      }
+      return mine;
+    }
+
+    template<typename time>
+    template<typename Body>
+    void ParallelNodesSweeper<time>::for_each_thread(size_t n, Body body)
+    {
+#ifdef WITH_OPENMP
+      const int nthreads = (this->num_node_threads > 0) ? this->num_node_threads
+                                                         : parallel::get_num_threads();
+      exception_ptr error;
+      #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads) if(nthreads > 1 && n > 1)
+      for (long i = 0; i < long(n); ++i) {
+        try {
+          body(size_t(i));
+        } catch (...) {
+          #pragma omp critical(pfasst_parallel_nodes_error)
+          if (!error) {
+            error = current_exception();
+          }
+        }
+      }
+      if (error) {
+        rethrow_exception(error);
+      }
+#else
+      for (size_t i = 0; i < n; ++i) {
+        body(i);
+      }
+#endif
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::share_nodes(bool with_state)
+    {
+      const size_t first = this->first_node();
+      const size_t num_nodes = this->quadrature->get_num_nodes();
+      const size_t size = this->node_comm ? size_t(this->node_comm->size()) : 1;
+
+      if (size > 1) {
+        for (size_t m = first; m < num_nodes; ++m) {
+          const int root = int((m - first) % size);
+          if (with_state) {
+            this->state[m]->broadcast(this->node_comm, root);
+          }
+          this->fs_impl[m]->broadcast(this->node_comm, root);
+        }
+      }
+    }
+
+    template<typename time>
+    template<typename Body>
+    void ParallelNodesSweeper<time>::for_nodes(Body body, bool with_state)
+    {
+      const vector<size_t> mine = this->local_nodes();
+      this->for_each_thread(mine.size(), [&body, &mine](size_t i) { body(mine[i]); });
+      this->share_nodes(with_state);
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::solve_nodes()
+    {
+      auto const& nodes = this->quadrature->get_nodes();
+      auto const dt = this->get_controller()->get_step_size();
+      auto const t0 = this->get_controller()->get_time();
+      auto const& q_int = this->get_q_integrals(dt);
+
+      const size_t num_nodes = nodes.size();
+      const bool fas = this->fas_corrections.size() > 0;
+      const size_t num_cols = 1 + (fas ? 3 : 2) * num_nodes;
+
+      if (size_t(this->rhs_mat.cols()) != num_cols || this->rhs_mat_dt != dt) {
+        // columns: [ U_0 | dt Q F | F_0 ... F_{M-1} | tau_0 ... tau_{M-1} ]
+        this->rhs_mat = Matrix<time>::Zero(num_nodes, num_cols);
+        for (size_t m = 0; m < num_nodes; m++) {
+          this->rhs_mat(m, 0) = 1.0;
+          this->rhs_mat(m, 1 + m) = 1.0;
+          this->rhs_mat(m, 1 + num_nodes + m) = -dt * this->q_delta(m, m);
+          // the FAS corrections are 'node to node', thus they are summed up to node m
+          for (size_t n = 0; fas && n <= m; n++) {
+            this->rhs_mat(m, 1 + 2 * num_nodes + n) = 1.0;
+          }
+        }
+        this->rhs_mat_dt = dt;
+      }
+
+      vector<shared_ptr<Encapsulation<time>>> src = { this->start_state };
+      src.insert(src.end(), q_int.begin(), q_int.end());
+      src.insert(src.end(), this->fs_impl.begin(), this->fs_impl.end());
+      if (fas) {
+        src.insert(src.end(), this->fas_corrections.begin(), this->fas_corrections.end());
+      }
+      this->rhs[0]->mat_apply(this->rhs, 1.0, this->rhs_mat, src, true);
+
+      this->for_nodes([this, &nodes, dt, t0](size_t m) {
+        const time ds = dt * this->q_delta(m, m);
+        const time t = t0 + dt * nodes[m];
+        if (this->initial_guess == InitialGuess::RHS) {
+          this->state[m]->copy(this->rhs[m]);
+        }
+        this->impl_solve(this->fs_impl[m], this->state[m], t - ds, ds, this->rhs[m]);
+      }, true);
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::set_end_state()
+    {
+      if (this->quadrature->right_is_node()) {
+        this->end_state->copy(this->state.back());
+      } else {
+        vector<shared_ptr<Encapsulation<time>>> dst = { this->end_state };
+        dst[0]->copy(this->start_state);
+        dst[0]->mat_apply(dst, this->get_controller()->get_step_size(),
+                          this->quadrature->get_b_mat(), this->fs_impl, false);
+      }
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::set_q_delta(quadrature::QDeltaType type)
+    {
+      this->q_delta_type = type;
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::set_q_delta(const Matrix<time>& q_delta)
+    {
+      this->q_delta_type = quadrature::QDeltaType::UNDEFINED;
+      this->q_delta = q_delta;
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::set_node_comm(ICommunicator* comm)
+    {
+      this->node_comm = comm;
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::set_num_node_threads(int num_threads)
+    {
+      this->num_node_threads = num_threads;
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::setup(bool coarse)
+    {
+      EncapSweeper<time>::setup(coarse);
+
+      auto const num_nodes = this->quadrature->get_num_nodes();
+
+      this->rhs = this->get_factory()->create_block(pfasst::encap::solution, num_nodes);
+      this->fs_impl = this->get_factory()->create_block(pfasst::encap::function, num_nodes);
+
+      if (this->q_delta_type != quadrature::QDeltaType::UNDEFINED) {
+        this->q_delta = quadrature::compute_q_delta(*(this->quadrature), this->q_delta_type);
+      }
+      if (size_t(this->q_delta.rows()) != num_nodes || size_t(this->q_delta.cols()) != num_nodes) {
+        throw ValueError("Q_delta must have the size of the quadrature matrix");
+      }
+      if (!this->q_delta.isDiagonal()) {
+        throw ValueError("Q_delta of the parallel nodes sweeper must be diagonal");
+      }
+      ML_CLOG(DEBUG, "Sweeper", "Q_delta:" << endl << this->q_delta);
+
+      this->rhs_mat.resize(0, 0);
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::predict(bool initial)
+    {
+      UNUSED(initial);
+
+      auto const t0 = this->get_controller()->get_time();
+      ML_CLOG(DEBUG, "Sweeper", "predicting step " << this->get_controller()->get_step() + 1
+                               << " (t=" << t0 << ", dt=" << this->get_controller()->get_step_size() << ")");
+
+      for (size_t m = 0; m < this->state.size(); m++) {
+        this->state[m]->copy(this->start_state);
+      }
+      this->f_impl_eval(this->fs_impl[0], this->start_state, t0);
+      for (size_t m = 1; m < this->fs_impl.size(); m++) {
+        this->fs_impl[m]->copy(this->fs_impl[0]);
+      }
+      this->invalidate_integrals();
+
+      this->begin_solves(true);
+      this->solve_nodes();
+      this->set_end_state();
+      this->invalidate_integrals();
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::sweep()
+    {
+      ML_CLOG(DEBUG, "Sweeper", "sweeping on step " << this->get_controller()->get_step() + 1
+                               << " in iteration " << this->get_controller()->get_iteration()
+                               << " (dt=" << this->get_controller()->get_step_size() << ")");
+
+      this->begin_solves(false);
+      this->solve_nodes();
+      this->set_end_state();
+      this->invalidate_integrals();
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::advance()
+    {
+      this->invalidate_integrals();
+
+      // the function values at the last node are recomputed in the next step, thus their slots
+      // are exchanged with the first node instead of copying values
+      this->start_state->copy(this->end_state);
+      if (this->quadrature->left_is_node() && this->quadrature->right_is_node()) {
+        this->state[0]->copy(this->start_state);
+        std::swap(this->fs_impl.front(), this->fs_impl.back());
+      }
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::reevaluate(bool initial_only)
+    {
+      this->invalidate_integrals();
+
+      auto const& nodes = this->quadrature->get_nodes();
+      auto const t0 = this->get_controller()->get_time();
+      auto const dt = this->get_controller()->get_step_size();
+
+      // the initial value only enters through the first node
+      if (this->quadrature->left_is_node()) {
+        this->f_impl_eval(this->fs_impl[0], this->state[0], t0);
+      }
+      if (initial_only) {
+        return;
+      }
+
+      const vector<size_t> mine = this->local_nodes();
+      vector<shared_ptr<Encapsulation<time>>> fs(mine.size()), us(mine.size());
+      vector<time> ts(mine.size());
+      for (size_t i = 0; i < mine.size(); i++) {
+        fs[i] = this->fs_impl[mine[i]];
+        us[i] = this->state[mine[i]];
+        ts[i] = t0 + dt * nodes[mine[i]];
+      }
+      this->f_impl_eval_all(fs, us, ts);
+      this->share_nodes(false);
+    }
+
+    template<typename time>
+    vector<vector<shared_ptr<Encapsulation<time>>>> ParallelNodesSweeper<time>::get_function_values() const
+    {
+      return { this->fs_impl };
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::integrate(time dt, vector<shared_ptr<Encapsulation<time>>> dst) const
+    {
+      dst[0]->mat_apply(dst, dt, this->quadrature->get_q_mat(), this->fs_impl, true);
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::f_impl_eval(shared_ptr<Encapsulation<time>> f_impl_encap,
+                                                 shared_ptr<Encapsulation<time>> u_encap,
+                                                 time t)
+    {
+      UNUSED(f_impl_encap); UNUSED(u_encap); UNUSED(t);
+      throw NotImplementedYet("parallel nodes (f_impl_eval)");
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::f_impl_eval_all(const vector<shared_ptr<Encapsulation<time>>>& f_impl_encaps,
+                                                     const vector<shared_ptr<Encapsulation<time>>>& u_encaps,
+                                                     const vector<time>& ts)
+    {
+      assert(f_impl_encaps.size() >= u_encaps.size() && ts.size() == u_encaps.size());
+      this->for_each_thread(u_encaps.size(), [&](size_t i) {
+        this->f_impl_eval(f_impl_encaps[i], u_encaps[i], ts[i]);
+      });
+    }
+
+    template<typename time>
+    void ParallelNodesSweeper<time>::impl_solve(shared_ptr<Encapsulation<time>> f_encap,
+                                                shared_ptr<Encapsulation<time>> u_encap,
+                                                time t, time dt,
+                                                shared_ptr<Encapsulation<time>> rhs_encap)
+    {
+      UNUSED(f_encap); UNUSED(u_encap); UNUSED(t); UNUSED(dt); UNUSED(rhs_encap);
+      throw NotImplementedYet("parallel nodes (impl_solve)");
+    }
+  }  // ::pfasst::encap
+}  // ::pfasst
@@ -15,6 +15,20 @@ namespace pfasst
   {
     /**
      * Polynomial time interpolation mixin.
+     *
+     * All temporaries are created by the factory of the level they belong to and values only cross
+     * levels through the spatial restrict() and interpolate() of two encapsulations, thus the fine
+     * and the coarse level may use different encapsulation types (e.g. `float` values on the coarse
+     * level).
+     * In particular, the FAS correction is computed in the coarse level's type from the restricted
+     * fine integrals.
+     *
+     * By default, the fine function values are reevaluated after interpolating the solution
+     * values.
+     * With set_interpolate_function_values(), the changes of the coarse function values are
+     * interpolated and added instead, which saves the evaluations of the right hand side at all fine
+     * nodes at the cost of fine function values that only approximate \\( F(U) \\) for nonlinear
+     * right hand sides.
      */
     template<typename time = time_precision>
     class PolyInterpMixin
@@ -25,13 +39,36 @@ namespace pfasst
         typedef vector<shared_ptr<Encapsulation<time>>> EncapVecT;
         Matrix<time> tmat;
         Matrix<time> fmat;
+
+        //! Whether interpolate() interpolates the function values instead of reevaluating them.
+        bool interp_function_values;
         //! @}
 
       public:
         //! @{
+        PolyInterpMixin();
         virtual ~PolyInterpMixin();
         //! @}
 
+        //! @{
+        /**
+         * Selects how interpolate() updates the function values of the fine level.
+         *
+         * If enabled, the coarse sweeper is told to save its function values (see
+         * EncapSweeper::set_save_function_values()) on the next restriction and the fine function
+         * values are corrected by the interpolated changes of the coarse ones just like the solution
+         * values.
+         * Without valid saved coarse function values (e.g. right after the predictor) or for
+         * sweepers not providing their function values (see EncapSweeper::get_function_values()),
+         * the fine function values are reevaluated as usual.
+         * The function value at the initial time is always reevaluated by interpolate_initial().
+         *
+         * @param[in] interp `true` to interpolate the function values; defaults to `false`
+         * @since v0.6.0
+         */
+        virtual void set_interpolate_function_values(bool interp);
+        //! @}
+
         //! @{
         virtual void interpolate_initial(shared_ptr<ISweeper<time>> dst,
                                          shared_ptr<const ISweeper<time>> src) override;
@@ -12,10 +12,21 @@ namespace pfasst
 {
   namespace encap
   {
+    template<typename time>
+    PolyInterpMixin<time>::PolyInterpMixin()
+      : interp_function_values(false)
+    {}
+
     template<typename time>
     PolyInterpMixin<time>::~PolyInterpMixin()
     {}
 
+    template<typename time>
+    void PolyInterpMixin<time>::set_interpolate_function_values(bool interp)
+    {
+      this->interp_function_values = interp;
+    }
+
     template<typename time>
     void PolyInterpMixin<time>::interpolate_initial(shared_ptr<ISweeper<time>> dst,
                                                     shared_ptr<const ISweeper<time>> src)
@@ -66,14 +77,35 @@ namespace pfasst
 
       auto crse_delta = crse_factory->create(solution);
       for (size_t m = 0; m < ncrse; m++) {
-        crse_delta->copy(crse.get_state(m));
-        crse_delta->saxpy(-1.0, crse.get_saved_state(m));
+        crse_delta->lincomb({ 1.0, -1.0 }, { crse.get_state(m), crse.get_saved_state(m) });
         interpolate(fine_delta[m], crse_delta);
       }
 
       fine.get_state(0)->mat_apply(fine_state, 1.0, tmat, fine_delta, false);
 
-      fine.reevaluate();
+      auto fine_fs = fine.get_function_values();
+      if (this->interp_function_values && crse.has_saved_function_values()
+          && fine_fs.size() == crse.get_saved_function_values().size()) {
+        // F(U + dU) is approximated by F(U) + I(F_crse - F_crse_saved)
+        auto const crse_fs = crse.get_function_values();
+        auto const& crse_saved_fs = crse.get_saved_function_values();
+
+        EncapVecT fine_f_delta(ncrse);
+        for (size_t m = 0; m < ncrse; m++) { fine_f_delta[m] = fine_factory->create(function); }
+
+        auto crse_f_delta = crse_factory->create(function);
+        for (size_t i = 0; i < fine_fs.size(); i++) {
+          for (size_t m = 0; m < ncrse; m++) {
+            crse_f_delta->lincomb({ 1.0, -1.0 }, { crse_fs[i][m], crse_saved_fs[i][m] });
+            interpolate(fine_f_delta[m], crse_f_delta);
+          }
+          fine_fs[i][0]->mat_apply(fine_fs[i], 1.0, tmat, fine_f_delta, false);
+        }
+
+        fine.invalidate_integrals();
+      } else {
+        fine.reevaluate();
+      }
     }
 
     template<typename time>
@@ -102,11 +134,15 @@ namespace pfasst
       auto& crse = pfasst::encap::as_encap_sweeper(dst);
       auto& fine = pfasst::encap::as_encap_sweeper(src);
 
-      auto const crse_nodes = crse.get_nodes();
-      auto const fine_nodes = fine.get_nodes();
+      auto const& crse_nodes = crse.get_nodes();
+      auto const& fine_nodes = fine.get_nodes();
       auto const num_crse = crse_nodes.size();
       auto const num_fine = fine_nodes.size();
 
+      if (this->interp_function_values) {
+        crse.set_save_function_values(true);
+      }
+
       if (restrict_initial) {
         this->restrict_initial(dst, src);
       }
@@ -187,6 +223,7 @@ namespace pfasst
       }
 
       tau[0]->mat_apply(tau, 1.0, fmat, rstr_and_crse, true);
+      crse.invalidate_residuals();
     }
   }  // ::pfasst::encap
 }  // ::pfasst
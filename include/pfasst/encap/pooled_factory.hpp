@@ -0,0 +1,141 @@
+/**
+ * @file pfasst/encap/pooled_factory.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__ENCAP__POOLED_FACTORY_HPP_
+#define _PFASST__ENCAP__POOLED_FACTORY_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include "pfasst/encap/encapsulation.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    /**
+     * Usage statistics of a PooledEncapFactory.
+     *
+     * @since v0.6.0
+     */
+    struct PoolStatistics
+    {
+      //! number of encapsulations currently handed out
+      size_t live;
+      //! largest number of encapsulations handed out at the same time
+      size_t peak;
+      //! number of encapsulations waiting in the pool for reuse
+      size_t idle;
+      //! number of encapsulations created by the wrapped factory
+      size_t allocated;
+      //! number of requests served from the pool
+      size_t recycled;
+    };
+
+
+    /**
+     * Decorator of an EncapFactory recycling the encapsulations it hands out.
+     *
+     * Each encapsulation returned by create() is a lease: once the last `shared_ptr` to it is
+     * released, it goes back into the pool instead of being destroyed and is handed out again by
+     * the next call to create() of the same pfasst::encap::EncapType.
+     * Thus, temporaries created on each call of the sweepers and transfer operators (e.g. the
+     * right hand sides of the implicit solves or the integrals in the FAS correction) cost one
+     * allocation for the whole run instead of one per call.
+     *
+     * Families of encapsulations requested through create_block() are long-living per-node data
+     * and are created by the wrapped factory directly.
+     *
+     * Leases may outlive this factory; the pool is released when both the factory and the last
+     * lease are gone.
+     *
+     * @code
+     * auto factory = make_shared<PooledEncapFactory<double>>(
+     *                  make_shared<VectorFactory<double>>(ndofs));
+     * sweeper->set_factory(factory);
+     * @endcode
+     *
+     * @note Recycled encapsulations are zeroed out before being handed out again unless disabled
+     *   via the constructor, so the pool is a drop-in replacement for factories returning zeroed
+     *   encapsulations, such as pfasst::encap::VectorFactory.
+     * @note create(), the return of leases and the other members may be called from several
+     *   OpenMP threads concurrently; the wrapped factory has to be thread-safe itself.
+     *
+     * @tparam time time precision; defaults to pfasst::time_precision
+     * @since v0.6.0
+     */
+    template<typename time = time_precision>
+    class PooledEncapFactory
+      : public EncapFactory<time>
+    {
+      protected:
+        //! @{
+        struct Pool
+        {
+          vector<shared_ptr<Encapsulation<time>>> idle[2];
+          PoolStatistics stats;
+          bool zero_recycled;
+        };
+
+        /**
+         * Deleter of a lease, returning the wrapped encapsulation into the pool.
+         */
+        struct Returner
+        {
+          shared_ptr<Pool> pool;
+          EncapType type;
+          shared_ptr<Encapsulation<time>> encap;
+
+          void operator()(Encapsulation<time>*);
+        };
+        //! @}
+
+        //! @{
+        shared_ptr<EncapFactory<time>> base;
+        shared_ptr<Pool> pool;
+        //! @}
+
+      public:
+        //! @{
+        /**
+         * @param[in] base          factory creating the actual encapsulations
+         * @param[in] zero_recycled whether to zero out recycled encapsulations before handing them
+         *   out again; may be disabled if all users overwrite temporaries anyway
+         */
+        PooledEncapFactory(shared_ptr<EncapFactory<time>> base, bool zero_recycled = true);
+        virtual ~PooledEncapFactory();
+        //! @}
+
+        //! @{
+        /**
+         * Hands out an encapsulation from the pool or creates a new one if the pool is empty.
+         */
+        virtual shared_ptr<Encapsulation<time>> create(const EncapType type) override;
+
+        /**
+         * Forwarded to the wrapped factory; the returned encapsulations are not pooled.
+         */
+        virtual vector<shared_ptr<Encapsulation<time>>> create_block(const EncapType type,
+                                                                     const size_t num) override;
+        //! @}
+
+        //! @{
+        /**
+         * Destroys all encapsulations currently waiting in the pool.
+         */
+        void release_idle();
+
+        PoolStatistics get_statistics() const;
+        shared_ptr<EncapFactory<time>> get_base() const;
+        //! @}
+    };
+  }  // ::pfasst::encap
+}  // ::pfasst
+
+#include "pfasst/encap/pooled_factory_impl.hpp"
+
+#endif  // _PFASST__ENCAP__POOLED_FACTORY_HPP_
@@ -0,0 +1,129 @@
+#include "pfasst/encap/pooled_factory.hpp"
+
+#include <cassert>
+using namespace std;
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    template<typename time>
+    void PooledEncapFactory<time>::Returner::operator()(Encapsulation<time>*)
+    {
+      // a deleter must not throw; if the pool cannot take the encapsulation, it is destroyed
+      shared_ptr<Encapsulation<time>> encap = std::move(this->encap);
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_pooled_factory)
+#endif
+      {
+        assert(this->pool->stats.live > 0);
+        this->pool->stats.live--;
+        try {
+          this->pool->idle[this->type].push_back(encap);
+        } catch (...) {}
+      }
+      this->pool.reset();
+    }
+
+
+    template<typename time>
+    PooledEncapFactory<time>::PooledEncapFactory(shared_ptr<EncapFactory<time>> base,
+                                                 bool zero_recycled)
+      :   base(base)
+        , pool(make_shared<Pool>())
+    {
+      assert(this->base);
+      this->pool->stats = { 0, 0, 0, 0, 0 };
+      this->pool->zero_recycled = zero_recycled;
+    }
+
+    template<typename time>
+    PooledEncapFactory<time>::~PooledEncapFactory()
+    {}
+
+    template<typename time>
+    shared_ptr<Encapsulation<time>> PooledEncapFactory<time>::create(const EncapType type)
+    {
+      shared_ptr<Encapsulation<time>> encap;
+
+      // only the bookkeeping is serialized; new encapsulations are created and recycled ones are
+      // zeroed out concurrently
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_pooled_factory)
+#endif
+      {
+        auto& idle = this->pool->idle[type];
+        auto& stats = this->pool->stats;
+        if (idle.empty()) {
+          stats.allocated++;
+        } else {
+          encap = std::move(idle.back());
+          idle.pop_back();
+          stats.recycled++;
+        }
+        stats.live++;
+        if (stats.live > stats.peak) {
+          stats.peak = stats.live;
+        }
+      }
+
+      if (!encap) {
+        try {
+          encap = this->base->create(type);
+        } catch (...) {
+#ifdef WITH_OPENMP
+          #pragma omp critical(pfasst_encap_pooled_factory)
+#endif
+          this->pool->stats.live--;
+          throw;
+        }
+      } else if (this->pool->zero_recycled) {
+        encap->zero();
+      }
+
+      Encapsulation<time>* raw = encap.get();
+      return shared_ptr<Encapsulation<time>>(raw, Returner{ this->pool, type, std::move(encap) });
+    }
+
+    template<typename time>
+    vector<shared_ptr<Encapsulation<time>>>
+    PooledEncapFactory<time>::create_block(const EncapType type, const size_t num)
+    {
+      return this->base->create_block(type, num);
+    }
+
+    template<typename time>
+    void PooledEncapFactory<time>::release_idle()
+    {
+      // the encapsulations are destroyed outside of the critical section
+      vector<shared_ptr<Encapsulation<time>>> released[2];
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_pooled_factory)
+#endif
+      for (size_t i = 0; i < 2; i++) {
+        released[i].swap(this->pool->idle[i]);
+      }
+    }
+
+    template<typename time>
+    PoolStatistics PooledEncapFactory<time>::get_statistics() const
+    {
+      PoolStatistics stats;
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_pooled_factory)
+#endif
+      {
+        stats = this->pool->stats;
+        stats.idle = this->pool->idle[solution].size() + this->pool->idle[function].size();
+      }
+      return stats;
+    }
+
+    template<typename time>
+    shared_ptr<EncapFactory<time>> PooledEncapFactory<time>::get_base() const
+    {
+      return this->base;
+    }
+  }  // ::pfasst::encap
+}  // ::pfasst
@@ -0,0 +1,188 @@
+/**
+ * @file pfasst/encap/solver_cache.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__ENCAP__SOLVER_CACHE_HPP_
+#define _PFASST__ENCAP__SOLVER_CACHE_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+using namespace std;
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+
+#include "pfasst/globals.hpp"
+#include "pfasst/interfaces.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    /**
+     * Cache of factorized implicit systems \\( I - \\Delta s A \\), one per sub-step size.
+     *
+     * Within a sweep, the sub-step sizes \\( \\Delta s \\) of the implicit solves only take as many
+     * distinct values as there are nodes, and the same values repeat in every sweep and every time
+     * step as long as the step size is fixed.
+     * Caching the factorization for each \\( \\Delta s \\) reduces every `impl_solve()` with a linear
+     * implicit part to a triangular solve (or a pointwise scaling for a spectral symbol).
+     *
+     * Each sweeper owns its cache, i.e. there is one cache per level.
+     * All entries are dropped whenever get() is called with a different step size than before, thus
+     * the cache never holds more factorizations than the sweeper has distinct sub-steps.
+     * Sub-step sizes agreeing up to #RELATIVE_TOLERANCE share an entry, as the same sub-step is
+     * usually computed in different ways (e.g. from the nodes in the predictor and from
+     * \\( Q_\\Delta \\) in the sweeps), which round differently.
+     *
+     * @code
+     * // in the constructor of the sweeper
+     * this->solver_cache = make_sparse_lu_cache<double, time>(laplacian);
+     *
+     * // in impl_solve()
+     * auto lu = this->solver_cache.get(this->get_controller()->get_step_size(), dt);
+     * u = lu->solve(rhs);
+     * @endcode
+     *
+     * See make_dense_lu_cache(), make_sparse_lu_cache(), make_sparse_ldlt_cache() and
+     * make_symbol_cache() for the factorizations at hand.
+     *
+     * All members may be called concurrently, e.g. get() by pfasst::encap::ParallelNodesSweeper.
+     * Entries are keyed by step size and sub-step size, and a factorization computed while the
+     * cache has been cleared or switched to another step size is returned without being cached.
+     *
+     * @tparam Factorization type of the factorization of a single system
+     * @tparam time precision type of the time dimension
+     * @since v0.6.0
+     */
+    template<typename Factorization, typename time = time_precision>
+    class SolverCache
+    {
+      public:
+        //! Computes the factorization of the system of a given sub-step size.
+        typedef std::function<shared_ptr<Factorization>(time)> factorize_type;
+
+        //! Relative difference up to which two sub-step sizes are considered equal.
+        static const time RELATIVE_TOLERANCE;
+
+      protected:
+        //! @{
+        factorize_type factorize;
+
+        //! Step size the cached factorizations belong to.
+        time step_size;
+
+        //! Cached factorizations keyed by step size and sub-step size.
+        map<pair<time, time>, shared_ptr<const Factorization>> entries;
+
+        //! Incremented whenever the entries are dropped.
+        size_t generation;
+
+        //! Number of factorizations cached so far.
+        size_t num_factorizations;
+        //! @}
+
+      public:
+        //! @{
+        /**
+         * @param[in] factorize computes the factorization of \\( I - \\Delta s A \\) for a
+         *   sub-step size \\( \\Delta s \\)
+         */
+        explicit SolverCache(factorize_type factorize = factorize_type());
+        virtual ~SolverCache() = default;
+        //! @}
+
+        //! @{
+        /**
+         * Factorization of the system of sub-step size @p ds.
+         *
+         * Computed on first use and cached until the step size changes.
+         * The factorization is computed outside of any critical section; exceptions thrown by the
+         * factorization routine propagate to the caller.
+         *
+         * @param[in] dt current step size of the controller
+         * @param[in] ds sub-step size of the implicit solve
+         * @throws ValueError if no factorization routine has been given
+         */
+        virtual shared_ptr<const Factorization> get(time dt, time ds);
+
+        /**
+         * Drops all cached factorizations, e.g. after changing the operator.
+         */
+        virtual void clear();
+
+        //! Number of cached factorizations.
+        virtual size_t size() const;
+
+        //! Number of factorizations cached since construction.
+        virtual size_t get_num_factorizations() const;
+        //! @}
+    };
+
+
+    //! @{
+    //! Dense LU factorization.
+    template<typename scalar>
+    using DenseLU = Eigen::PartialPivLU<Eigen::Matrix<scalar, Eigen::Dynamic, Eigen::Dynamic>>;
+
+    //! Sparse LU factorization for general sparse operators.
+    template<typename scalar>
+    using SparseLU = Eigen::SparseLU<Eigen::SparseMatrix<scalar>, Eigen::COLAMDOrdering<int>>;
+
+    //! Sparse \\( LDL^T \\) factorization for symmetric operators (e.g. diffusion).
+    template<typename scalar>
+    using SparseLDLT = Eigen::SimplicialLDLT<Eigen::SparseMatrix<scalar>>;
+
+    //! Inverse \\( 1 / (1 - \\Delta s \\lambda_k) \\) of a diagonalized operator.
+    template<typename scalar>
+    using SpectralSymbol = vector<scalar>;
+    //! @}
+
+    //! @{
+    /**
+     * Cache of dense LU factorizations of \\( I - \\Delta s A \\).
+     */
+    template<typename scalar, typename time = time_precision>
+    SolverCache<DenseLU<scalar>, time>
+    make_dense_lu_cache(const Eigen::Matrix<scalar, Eigen::Dynamic, Eigen::Dynamic>& a);
+
+    /**
+     * Cache of sparse LU factorizations of \\( I - \\Delta s A \\).
+     */
+    template<typename scalar, typename time = time_precision>
+    SolverCache<SparseLU<scalar>, time>
+    make_sparse_lu_cache(const Eigen::SparseMatrix<scalar>& a);
+
+    /**
+     * Cache of sparse \\( LDL^T \\) factorizations of \\( I - \\Delta s A \\) for symmetric
+     * \\( A \\).
+     */
+    template<typename scalar, typename time = time_precision>
+    SolverCache<SparseLDLT<scalar>, time>
+    make_sparse_ldlt_cache(const Eigen::SparseMatrix<scalar>& a);
+
+    /**
+     * Cache of the symbols \\( c / (1 - \\Delta s \\lambda_k) \\) of an operator with eigenvalues
+     * \\( \\lambda_k \\), e.g. the Fourier symbol of a spectral Laplacian.
+     *
+     * @param[in] eigenvalues eigenvalues \\( \\lambda_k \\)
+     * @param[in] scale constant factor \\( c \\), e.g. the normalization of an unscaled inverse
+     *   FFT
+     */
+    template<typename scalar, typename time = time_precision>
+    SolverCache<SpectralSymbol<scalar>, time>
+    make_symbol_cache(const vector<scalar>& eigenvalues, scalar scale = scalar(1.0));
+    //! @}
+  }  // ::pfasst::encap
+}  // ::pfasst
+
+#include "pfasst/encap/solver_cache_impl.hpp"
+
+#endif  // _PFASST__ENCAP__SOLVER_CACHE_HPP_
@@ -0,0 +1,198 @@
+#include "pfasst/encap/solver_cache.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <exception>
+using namespace std;
+
+#include "pfasst/globals.hpp"
+
+
+namespace pfasst
+{
+  namespace encap
+  {
+    template<typename Factorization, typename time>
+    const time SolverCache<Factorization, time>::RELATIVE_TOLERANCE
+      = time(64.0) * numeric_limits<time>::epsilon();
+
+    template<typename Factorization, typename time>
+    SolverCache<Factorization, time>::SolverCache(factorize_type factorize)
+      :   factorize(factorize)
+        , step_size(0.0)
+        , generation(0)
+        , num_factorizations(0)
+    {}
+
+    template<typename Factorization, typename time>
+    shared_ptr<const Factorization> SolverCache<Factorization, time>::get(time dt, time ds)
+    {
+      if (!this->factorize) {
+        throw ValueError("solver cache without factorization routine");
+      }
+
+      // sub-step sizes computed in different ways (e.g. node differences in the predictor and
+      // the diagonal of Q_delta in the sweeps) differ by rounding; they share one entry
+      const time tol = this->RELATIVE_TOLERANCE * std::abs(ds);
+      auto lookup = [this, dt, ds, tol]() {
+        auto it = this->entries.lower_bound(make_pair(dt, ds - tol));
+        if (it != this->entries.end() && it->first.first == dt && it->first.second <= ds + tol) {
+          return it->second;
+        }
+        return shared_ptr<const Factorization>();
+      };
+
+      // nothing may be thrown out of a critical section
+      shared_ptr<const Factorization> entry;
+      size_t generation = 0;
+      exception_ptr error;
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_solver_cache)
+#endif
+      {
+        try {
+          if (dt != this->step_size) {
+            this->entries.clear();
+            this->step_size = dt;
+            this->generation++;
+          }
+          generation = this->generation;
+          entry = lookup();
+        } catch (...) {
+          error = current_exception();
+        }
+      }
+      if (error) {
+        rethrow_exception(error);
+      }
+
+      if (!entry) {
+        // concurrent solves of other sub-steps need not wait for this factorization
+        shared_ptr<const Factorization> fresh = this->factorize(ds);
+        assert(fresh);
+#ifdef WITH_OPENMP
+        #pragma omp critical(pfasst_encap_solver_cache)
+#endif
+        {
+          try {
+            // another thread may have factorized the same sub-step in the meantime, or the
+            // entries may have been dropped, in which case the factorization is not cached
+            entry = lookup();
+            if (!entry && generation == this->generation) {
+              entry = this->entries.insert(make_pair(make_pair(dt, ds), fresh)).first->second;
+              this->num_factorizations++;
+            } else if (!entry) {
+              entry = fresh;
+            }
+          } catch (...) {
+            error = current_exception();
+          }
+        }
+        if (error) {
+          rethrow_exception(error);
+        }
+      }
+
+      return entry;
+    }
+
+    template<typename Factorization, typename time>
+    void SolverCache<Factorization, time>::clear()
+    {
+      // the factorizations are released outside of the critical section
+      map<pair<time, time>, shared_ptr<const Factorization>> dropped;
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_solver_cache)
+#endif
+      {
+        dropped.swap(this->entries);
+        this->generation++;
+      }
+    }
+
+    template<typename Factorization, typename time>
+    size_t SolverCache<Factorization, time>::size() const
+    {
+      size_t size;
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_solver_cache)
+#endif
+      size = this->entries.size();
+      return size;
+    }
+
+    template<typename Factorization, typename time>
+    size_t SolverCache<Factorization, time>::get_num_factorizations() const
+    {
+      size_t num_factorizations;
+#ifdef WITH_OPENMP
+      #pragma omp critical(pfasst_encap_solver_cache)
+#endif
+      num_factorizations = this->num_factorizations;
+      return num_factorizations;
+    }
+
+
+    template<typename scalar, typename time>
+    SolverCache<DenseLU<scalar>, time>
+    make_dense_lu_cache(const Eigen::Matrix<scalar, Eigen::Dynamic, Eigen::Dynamic>& a)
+    {
+      assert(a.rows() == a.cols());
+      return SolverCache<DenseLU<scalar>, time>([a](time ds) {
+        typedef Eigen::Matrix<scalar, Eigen::Dynamic, Eigen::Dynamic> MatrixT;
+        MatrixT system = MatrixT::Identity(a.rows(), a.cols()) - scalar(ds) * a;
+        return make_shared<DenseLU<scalar>>(system);
+      });
+    }
+
+    template<typename scalar, typename time>
+    SolverCache<SparseLU<scalar>, time>
+    make_sparse_lu_cache(const Eigen::SparseMatrix<scalar>& a)
+    {
+      assert(a.rows() == a.cols());
+      return SolverCache<SparseLU<scalar>, time>([a](time ds) {
+        Eigen::SparseMatrix<scalar> id(a.rows(), a.cols());
+        id.setIdentity();
+        Eigen::SparseMatrix<scalar> system = id - scalar(ds) * a;
+        system.makeCompressed();
+        auto lu = make_shared<SparseLU<scalar>>();
+        lu->compute(system);
+        if (lu->info() != Eigen::Success) {
+          throw ValueError("sparse LU factorization failed");
+        }
+        return lu;
+      });
+    }
+
+    template<typename scalar, typename time>
+    SolverCache<SparseLDLT<scalar>, time>
+    make_sparse_ldlt_cache(const Eigen::SparseMatrix<scalar>& a)
+    {
+      assert(a.rows() == a.cols());
+      return SolverCache<SparseLDLT<scalar>, time>([a](time ds) {
+        Eigen::SparseMatrix<scalar> id(a.rows(), a.cols());
+        id.setIdentity();
+        Eigen::SparseMatrix<scalar> system = id - scalar(ds) * a;
+        auto ldlt = make_shared<SparseLDLT<scalar>>();
+        ldlt->compute(system);
+        if (ldlt->info() != Eigen::Success) {
+          throw ValueError("sparse LDLT factorization failed");
+        }
+        return ldlt;
+      });
+    }
+
+    template<typename scalar, typename time>
+    SolverCache<SpectralSymbol<scalar>, time>
+    make_symbol_cache(const vector<scalar>& eigenvalues, scalar scale)
+    {
+      return SolverCache<SpectralSymbol<scalar>, time>([eigenvalues, scale](time ds) {
+        auto symbol = make_shared<SpectralSymbol<scalar>>(eigenvalues.size());
+        for (size_t k = 0; k < eigenvalues.size(); k++) {
+          (*symbol)[k] = scale / (scalar(1.0) - scalar(ds) * eigenvalues[k]);
+        }
+        return symbol;
+      });
+    }
+  }  // ::pfasst::encap
+}  // ::pfasst
@@ -6,11 +6,11 @@
 using namespace std;
 
 #ifdef WITH_MPI
-#include "pfasst/mpi_communicator.hpp"
-using namespace pfasst::mpi;
+#include "pfasst/encap/mpi_buffer.hpp"
 #endif
 
 #include "pfasst/encap/encapsulation.hpp"
+#include "pfasst/encap/kernels.hpp"
 
 
 namespace pfasst
@@ -27,6 +27,9 @@ namespace pfasst
     class VectorEncapsulation
       : public vector<scalar>,
         public Encapsulation<time>
+#ifdef WITH_MPI
+      , public MPIBuffer
+#endif
     {
       public:
 
@@ -50,6 +53,8 @@ namespace pfasst
         /**
          * Move constructor.
          *
+         * Takes over the buffer of @p other.
+         *
          * @note delegated to std::vector<scalar>
          */
         VectorEncapsulation(VectorEncapsulation<scalar, time>&& other);
@@ -68,6 +73,27 @@ namespace pfasst
         virtual void zero() override;
         virtual void copy(shared_ptr<const Encapsulation<time>> x) override;
         virtual void copy(shared_ptr<const VectorEncapsulation<scalar, time>> x);
+
+        /**
+         * Typed, non-virtual variant of copy() for callers knowing the actual type.
+         *
+         * @since v0.6.0
+         */
+        void copy(const VectorEncapsulation<scalar, time>& x);
+
+        using vector<scalar>::swap;
+
+        /**
+         * Exchanges the buffers with @p x in constant time.
+         *
+         * @note With MPI enabled, open send requests on both vectors are completed first.
+         */
+        virtual void swap(shared_ptr<Encapsulation<time>> x) override;
+
+        /**
+         * Takes over the buffer of @p x in constant time (see swap()).
+         */
+        virtual void move_from(shared_ptr<Encapsulation<time>> x) override;
         //! @}
 
         //! @{
@@ -75,46 +101,83 @@ namespace pfasst
         virtual void saxpy(time a, shared_ptr<const VectorEncapsulation<scalar, time>> x);
 
         /**
-         * @note In case any of the elements of `dst` or `src` can not be transformed via
-         *     `dynamic_cast` into pfasst::encap::VectorEncapsulation std::abort is called.
+         * Typed, non-virtual variant of saxpy() for callers knowing the actual type.
+         *
+         * @since v0.6.0
+         */
+        void saxpy(time a, const VectorEncapsulation<scalar, time>& x);
+
+        /**
+         * Single pass linear combination using pfasst::encap::kernels::lincomb().
+         *
+         * Unlike the default implementation, this vector may be any of @p x.
          */
-        virtual void mat_apply(vector<shared_ptr<Encapsulation<time>>> dst,
-                               time a, Matrix<time> mat,
-                               vector<shared_ptr<Encapsulation<time>>> src,
+        virtual void lincomb(const vector<time>& a,
+                             const vector<shared_ptr<Encapsulation<time>>>& x,
+                             bool zero = true) override;
+
+        /**
+         * @note All elements of `dst` and `src` must be pfasst::encap::VectorEncapsulation of the
+         *     same size; the sizes are only checked in debug builds.
+         */
+        virtual void mat_apply(const vector<shared_ptr<Encapsulation<time>>>& dst,
+                               time a, const Matrix<time>& mat,
+                               const vector<shared_ptr<Encapsulation<time>>>& src,
                                bool zero = true) override;
-        virtual void mat_apply(vector<shared_ptr<VectorEncapsulation<scalar, time>>> dst,
-                               time a, Matrix<time> mat,
-                               vector<shared_ptr<VectorEncapsulation<scalar, time>>> src,
+
+        /**
+         * Typed matrix-vector multiplication.
+         *
+         * The matrix is scaled by @p a once and applied by the cache-blocked kernel
+         * pfasst::encap::kernels::mat_apply(), which streams each source vector once per tile and
+         * specializes on the number of source vectors (i.e. the shapes of the `Q`, `S`, `B` and FAS
+         * matrices).
+         * Results are identical to the straight forward triple loop.
+         */
+        virtual void mat_apply(const vector<shared_ptr<VectorEncapsulation<scalar, time>>>& dst,
+                               time a, const Matrix<time>& mat,
+                               const vector<shared_ptr<VectorEncapsulation<scalar, time>>>& src,
                                bool zero = true);
 
+        /**
+         * Matrix-vector multiplication on raw arrays of `ndofs` values each.
+         *
+         * Common back end of both mat_apply() variants above; does neither allocate heap memory
+         * for up to kernels::MAX_UNROLLED_SOURCES sources and destinations nor query any types.
+         *
+         * @since v0.6.0
+         */
+        static void mat_apply(scalar* const* dst, const size_t ndst,
+                              time a, const Matrix<time>& mat,
+                              const scalar* const* src, const size_t nsrc,
+                              const size_t ndofs, bool zero = true);
+
         /**
          * Maximum norm of contained elements.
          *
-         * This uses std::max with custom comparison function.
+         * Same as `norm(max_norm)`.
          */
         virtual time norm0() const override;
-        //! @}
 
-#ifdef WITH_MPI
-        //! @{
-        MPI_Request recv_request = MPI_REQUEST_NULL;
-        MPI_Request send_request = MPI_REQUEST_NULL;
-        //! @}
+        /**
+         * Supports all pfasst::encap::NormType using the reduction kernels of
+         * pfasst::encap::kernels.
+         */
+        virtual time norm(NormType type) const override;
 
-        //! @{
-        inline MPICommunicator& as_mpi(ICommunicator* comm)
-        {
-          auto mpi = dynamic_cast<MPICommunicator*>(comm);
-          assert(mpi);
-          return *mpi;
-        }
+        virtual vector<time> norms(const vector<shared_ptr<Encapsulation<time>>>& x,
+                                   NormType type) const override;
+
+        virtual time dot(shared_ptr<const Encapsulation<time>> x) const override;
         //! @}
 
+#ifdef WITH_MPI
         //! @{
         virtual void post(ICommunicator* comm, int tag) override;
         virtual void recv(ICommunicator* comm, int tag, bool blocking) override;
         virtual void send(ICommunicator* comm, int tag, bool blocking) override;
         virtual void broadcast(ICommunicator* comm) override;
+        virtual void broadcast(ICommunicator* comm, int root) override;
         //! @}
 #endif
 
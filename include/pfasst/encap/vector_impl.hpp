@@ -10,9 +10,7 @@ namespace pfasst
     template<typename scalar, typename time>
     VectorEncapsulation<scalar, time>::VectorEncapsulation(const size_t size)
       : vector<scalar>(size)
-    {
-      zero();
-    }
+    {}
 
     template<typename scalar, typename time>
     VectorEncapsulation<scalar, time>::VectorEncapsulation(const VectorEncapsulation<scalar, time>& other)
@@ -21,12 +19,12 @@ namespace pfasst
 
     template<typename scalar, typename time>
     VectorEncapsulation<scalar, time>::VectorEncapsulation(const Encapsulation<time>& other)
-      : VectorEncapsulation(dynamic_cast<const VectorEncapsulation<scalar, time>>(other))
+      : VectorEncapsulation(dynamic_cast<const VectorEncapsulation<scalar, time>&>(other))
     {}
 
     template<typename scalar, typename time>
     VectorEncapsulation<scalar, time>::VectorEncapsulation(VectorEncapsulation<scalar, time>&& other)
-      : vector<scalar>(other)
+      : vector<scalar>(std::move(other))
     {}
 
     template<typename scalar, typename time>
@@ -38,13 +36,7 @@ namespace pfasst
     VectorEncapsulation<scalar, time>::~VectorEncapsulation()
     {
 #ifdef WITH_MPI
-      if (this->send_request != MPI_REQUEST_NULL) {
-        MPI_Status stat = MPI_Status_factory();
-        ML_CLOG(DEBUG, "Encap", "waiting for open send request");
-        int err = MPI_Wait(&(this->send_request), &stat);
-        check_mpi_error(err);
-        ML_CLOG(DEBUG, "Encap", "waited for open send request");
-      }
+      this->wait_send();
       assert(this->recv_request == MPI_REQUEST_NULL);
       assert(this->send_request == MPI_REQUEST_NULL);
 #endif
@@ -53,94 +45,206 @@ namespace pfasst
     template<typename scalar, typename time>
     void VectorEncapsulation<scalar, time>::zero()
     {
-      this->assign(this->size(), scalar(0.0));
+      kernels::fill(this->data(), this->size(), scalar(0.0));
     }
 
     template<typename scalar, typename time>
     void VectorEncapsulation<scalar, time>::copy(shared_ptr<const Encapsulation<time>> x)
     {
-      shared_ptr<const VectorEncapsulation<scalar, time>> x_cast = \
-        dynamic_pointer_cast<const VectorEncapsulation<scalar, time>>(x);
-      assert(x_cast);
-      this->copy(x_cast);
+      this->copy(encap_cast<VectorEncapsulation<scalar, time>>(*x));
     }
 
     template<typename scalar, typename time>
     void VectorEncapsulation<scalar, time>::copy(shared_ptr<const VectorEncapsulation<scalar, time>> x)
     {
-      std::copy(x->cbegin(), x->cend(), this->begin());
+      this->copy(*x);
     }
 
     template<typename scalar, typename time>
-    void VectorEncapsulation<scalar, time>::saxpy(time a, shared_ptr<const Encapsulation<time>> x)
+    void VectorEncapsulation<scalar, time>::copy(const VectorEncapsulation<scalar, time>& x)
+    {
+      assert(this->size() == x.size());
+      kernels::copy(this->data(), x.data(), this->size());
+    }
+
+    template<typename scalar, typename time>
+    void VectorEncapsulation<scalar, time>::swap(shared_ptr<Encapsulation<time>> x)
+    {
+      auto& x_cast = encap_cast<VectorEncapsulation<scalar, time>>(*x);
+      assert(this->size() == x_cast.size());
+
+#ifdef WITH_MPI
+      // buffers of pending sends must stay with their requests
+      for (auto v : { this, &x_cast }) {
+        assert(v->recv_request == MPI_REQUEST_NULL);
+        v->wait_send();
+      }
+#endif
+      this->swap(x_cast);
+    }
+
+    template<typename scalar, typename time>
+    void VectorEncapsulation<scalar, time>::move_from(shared_ptr<Encapsulation<time>> x)
     {
-      shared_ptr<const VectorEncapsulation<scalar, time>> x_cast = \
-        dynamic_pointer_cast<const VectorEncapsulation<scalar, time>>(x);
-      assert(x_cast);
+      this->swap(x);
+    }
 
-      this->saxpy(a, x_cast);
+    template<typename scalar, typename time>
+    void VectorEncapsulation<scalar, time>::saxpy(time a, shared_ptr<const Encapsulation<time>> x)
+    {
+      this->saxpy(a, encap_cast<VectorEncapsulation<scalar, time>>(*x));
     }
 
     template<typename scalar, typename time>
     void VectorEncapsulation<scalar, time>::saxpy(time a, shared_ptr<const VectorEncapsulation<scalar, time>> x)
     {
-      assert(this->size() == x->size());
-      for (size_t i = 0; i < this->size(); i++)
-      { this->data()[i] += a * x->data()[i]; }
+      this->saxpy(a, *x);
+    }
+
+    template<typename scalar, typename time>
+    void VectorEncapsulation<scalar, time>::saxpy(time a, const VectorEncapsulation<scalar, time>& x)
+    {
+      assert(this->size() == x.size());
+      kernels::axpy(this->data(), a, x.data(), this->size());
+    }
+
+    template<typename scalar, typename time>
+    void VectorEncapsulation<scalar, time>::lincomb(const vector<time>& a,
+                                                    const vector<shared_ptr<Encapsulation<time>>>& x,
+                                                    bool zero)
+    {
+      typedef kernels::coeff_type<scalar, time> coeff;
+      assert(a.size() == x.size());
+
+      size_t nsrc = x.size();
+      kernels::ScratchArray<const scalar*, kernels::MAX_UNROLLED_SOURCES> src_data(nsrc);
+      kernels::ScratchArray<coeff, kernels::MAX_UNROLLED_SOURCES> coeffs(nsrc);
+      for (size_t m = 0; m < nsrc; m++) {
+        auto& x_m = encap_cast<VectorEncapsulation<scalar, time>>(*x[m]);
+        assert(x_m.size() == this->size());
+        src_data[m] = x_m.data();
+        coeffs[m] = coeff(a[m]);
+      }
+
+      kernels::lincomb(this->data(), coeffs.data(), src_data.data(), nsrc, this->size(), zero);
     }
 
     template<typename scalar, typename time>
     void
-    VectorEncapsulation<scalar, time>::mat_apply(vector<shared_ptr<Encapsulation<time>>> dst,
-                                                 time a, Matrix<time> mat,
-                                                 vector<shared_ptr<Encapsulation<time>>> src,
+    VectorEncapsulation<scalar, time>::mat_apply(const vector<shared_ptr<Encapsulation<time>>>& dst,
+                                                 time a, const Matrix<time>& mat,
+                                                 const vector<shared_ptr<Encapsulation<time>>>& src,
                                                  bool zero)
     {
+      typedef VectorEncapsulation<scalar, time> VectorT;
+
       size_t ndst = dst.size();
       size_t nsrc = src.size();
 
-      vector<shared_ptr<VectorEncapsulation<scalar, time>>> dst_cast(ndst), src_cast(nsrc);
+      kernels::ScratchArray<scalar*, kernels::MAX_UNROLLED_SOURCES> dst_data(ndst);
+      kernels::ScratchArray<const scalar*, kernels::MAX_UNROLLED_SOURCES> src_data(nsrc);
       for (size_t n = 0; n < ndst; n++) {
-        dst_cast[n] = dynamic_pointer_cast<VectorEncapsulation<scalar, time>>(dst[n]);
-        assert(dst_cast[n]);
+        dst_data[n] = encap_cast<VectorT>(*dst[n]).data();
       }
       for (size_t m = 0; m < nsrc; m++) {
-        src_cast[m] = dynamic_pointer_cast<VectorEncapsulation<scalar, time>>(src[m]);
-        assert(src_cast[m]);
+        src_data[m] = encap_cast<VectorT>(*src[m]).data();
       }
 
-      dst_cast[0]->mat_apply(dst_cast, a, mat, src_cast, zero);
+      VectorT::mat_apply(dst_data.data(), ndst, a, mat, src_data.data(), nsrc,
+                         encap_cast<VectorT>(*dst[0]).size(), zero);
     }
 
     template<typename scalar, typename time>
     void
-    VectorEncapsulation<scalar, time>::mat_apply(vector<shared_ptr<VectorEncapsulation<scalar, time>>> dst,
-                                                 time a, Matrix<time> mat,
-                                                 vector<shared_ptr<VectorEncapsulation<scalar, time>>> src,
+    VectorEncapsulation<scalar, time>::mat_apply(const vector<shared_ptr<VectorEncapsulation<scalar, time>>>& dst,
+                                                 time a, const Matrix<time>& mat,
+                                                 const vector<shared_ptr<VectorEncapsulation<scalar, time>>>& src,
                                                  bool zero)
     {
       size_t ndst = dst.size();
       size_t nsrc = src.size();
+      size_t ndofs = dst[0]->size();
 
-      if (zero) { for (auto elem : dst) { elem->zero(); } }
+      kernels::ScratchArray<scalar*, kernels::MAX_UNROLLED_SOURCES> dst_data(ndst);
+      kernels::ScratchArray<const scalar*, kernels::MAX_UNROLLED_SOURCES> src_data(nsrc);
+      for (size_t n = 0; n < ndst; n++) {
+        assert(dst[n]->size() == ndofs);
+        dst_data[n] = dst[n]->data();
+      }
+      for (size_t m = 0; m < nsrc; m++) {
+        assert(src[m]->size() == ndofs);
+        src_data[m] = src[m]->data();
+      }
 
-      size_t ndofs = dst[0]->size();
-      for (size_t i = 0; i < ndofs; i++) {
-        for (size_t n = 0; n < ndst; n++) {
-          assert(dst[n]->size() == ndofs);
-          for (size_t m = 0; m < nsrc; m++) {
-            assert(src[m]->size() == ndofs);
-            dst[n]->data()[i] += a * mat(n, m) * src[m]->data()[i];
-          }
+      VectorEncapsulation<scalar, time>::mat_apply(dst_data.data(), ndst, a, mat,
+                                                   src_data.data(), nsrc, ndofs, zero);
+    }
+
+    template<typename scalar, typename time>
+    void VectorEncapsulation<scalar, time>::mat_apply(scalar* const* dst, const size_t ndst,
+                                                      time a, const Matrix<time>& mat,
+                                                      const scalar* const* src, const size_t nsrc,
+                                                      const size_t ndofs, bool zero)
+    {
+      typedef kernels::coeff_type<scalar, time> coeff;
+      assert(size_t(mat.rows()) >= ndst && size_t(mat.cols()) >= nsrc);
+
+      // scale the matrix once instead of once per degree of freedom
+      kernels::ScratchArray<coeff, kernels::MAX_UNROLLED_SOURCES * kernels::MAX_UNROLLED_SOURCES>
+        coeffs(ndst * nsrc);
+      for (size_t n = 0; n < ndst; n++) {
+        for (size_t m = 0; m < nsrc; m++) {
+          coeffs[n * nsrc + m] = coeff(a * mat(n, m));
         }
       }
+
+      kernels::mat_apply(dst, ndst, coeffs.data(), src, nsrc, ndofs, zero);
     }
 
     template<typename scalar, typename time>
     time VectorEncapsulation<scalar, time>::norm0() const
     {
-      return std::abs(*std::max_element(this->cbegin(), this->cend(),
-                                        [](scalar a, scalar b) {return std::abs(a) < std::abs(b); } ));
+      return this->norm(max_norm);
+    }
+
+    template<typename scalar, typename time>
+    time VectorEncapsulation<scalar, time>::norm(NormType type) const
+    {
+      const scalar* x = this->data();
+      const size_t n = this->size();
+
+      switch (type) {
+        case max_norm:
+          return kernels::max_abs<time>(x, n);
+        case l1_norm:
+          return kernels::sum_abs<time>(x, n);
+        case l2_norm:
+          return std::sqrt(kernels::sum_sq_abs<time>(x, n));
+        case rms_norm:
+          return n == 0 ? time(0.0) : std::sqrt(kernels::sum_sq_abs<time>(x, n) / time(n));
+        default:
+          throw ValueError("unknown norm type");
+      }
+    }
+
+    template<typename scalar, typename time>
+    vector<time>
+    VectorEncapsulation<scalar, time>::norms(const vector<shared_ptr<Encapsulation<time>>>& x,
+                                             NormType type) const
+    {
+      vector<time> result(x.size());
+      for (size_t m = 0; m < x.size(); m++) {
+        result[m] = encap_cast<VectorEncapsulation<scalar, time>>(*x[m]).norm(type);
+      }
+      return result;
+    }
+
+    template<typename scalar, typename time>
+    time VectorEncapsulation<scalar, time>::dot(shared_ptr<const Encapsulation<time>> x) const
+    {
+      auto& x_cast = encap_cast<VectorEncapsulation<scalar, time>>(*x);
+      assert(this->size() == x_cast.size());
+      return kernels::dot<time>(x_cast.data(), this->data(), this->size());
     }
 
 
@@ -165,107 +269,44 @@ namespace pfasst
     template<typename scalar, typename time>
     VectorEncapsulation<scalar,time>& as_vector(shared_ptr<Encapsulation<time>> x)
     {
-      typedef VectorEncapsulation<scalar,time> VectorT;
-      shared_ptr<VectorT> y = dynamic_pointer_cast<VectorT>(x);
-      assert(y);
-      return *y.get();
+      return encap_cast<VectorEncapsulation<scalar,time>>(*x);
     }
 
     template<typename scalar, typename time>
     const VectorEncapsulation<scalar,time>& as_vector(shared_ptr<const Encapsulation<time>> x)
     {
-      typedef VectorEncapsulation<scalar,time> VectorT;
-      shared_ptr<const VectorT> y = dynamic_pointer_cast<const VectorT>(x);
-      assert(y);
-      return *y.get();
+      return encap_cast<VectorEncapsulation<scalar,time>>(*x);
     }
 
 #ifdef WITH_MPI
     template<typename scalar, typename time>
     void VectorEncapsulation<scalar, time>::post(ICommunicator* comm, int tag)
     {
-      auto& mpi = as_mpi(comm);
-      if (mpi.size() == 1) { return; }
-      if (mpi.rank() == 0) { return; }
-
-      if (this->recv_request != MPI_REQUEST_NULL) {
-        throw MPIError("a previous receive request is still open");
-      }
-
-      int src = (mpi.rank() - 1) % mpi.size();
-      ML_CLOG(DEBUG, "Encap", "non-blocking receiving from rank " << src << " with tag=" << tag);
-      int err = MPI_Irecv(this->data(), sizeof(scalar) * this->size(), MPI_CHAR,
-                          src, tag, mpi.comm, &this->recv_request);
-      check_mpi_error(err);
-      ML_CLOG(DEBUG, "Encap", "non-blocking received from rank " << src << " with tag=" << tag);
+      this->post_buffer(comm, tag, this->data(), sizeof(scalar) * this->size());
     }
 
     template<typename scalar, typename time>
     void VectorEncapsulation<scalar, time>::recv(ICommunicator* comm, int tag, bool blocking)
     {
-      auto& mpi = as_mpi(comm);
-      if (mpi.size() == 1) { return; }
-      if (mpi.rank() == 0) { return; }
-
-      MPI_Status stat = MPI_Status_factory();
-      int err = MPI_SUCCESS;
-
-      if (blocking) {
-        int src = (mpi.rank() - 1) % mpi.size();
-        ML_CLOG(DEBUG, "Encap", "blocking receive from rank " << src << " with tag=" << tag);
-        err = MPI_Recv(this->data(), sizeof(scalar) * this->size(), MPI_CHAR,
-                       src, tag, mpi.comm, &stat);
-        check_mpi_error(err);
-        ML_CLOG(DEBUG, "Encap", "received blocking from rank " << src << " with tag=" << tag << ": " << stat);
-      } else {
-        if (this->recv_request != MPI_REQUEST_NULL) {
-          ML_CLOG(DEBUG, "Encap", "waiting on last receive request");
-          err = MPI_Wait(&(this->recv_request), &stat);
-          check_mpi_error(err);
-          ML_CLOG(DEBUG, "Encap", "waited on last receive request: " << stat);
-        }
-      }
+      this->recv_buffer(comm, tag, blocking, this->data(), sizeof(scalar) * this->size());
     }
 
     template<typename scalar, typename time>
     void VectorEncapsulation<scalar, time>::send(ICommunicator* comm, int tag, bool blocking)
     {
-      auto& mpi = as_mpi(comm);
-      if (mpi.size() == 1) { return; }
-      if (mpi.rank() == mpi.size() - 1) { return; }
-
-      MPI_Status stat = MPI_Status_factory();
-      int err = MPI_SUCCESS;
-      int dest = (mpi.rank() + 1) % mpi.size();
-
-      if (blocking) {
-        ML_CLOG(DEBUG, "Encap", "blocking send to rank " << dest << " with tag=" << tag);
-        err = MPI_Send(this->data(), sizeof(scalar) * this->size(), MPI_CHAR, dest, tag, mpi.comm);
-        check_mpi_error(err);
-        ML_CLOG(DEBUG, "Encap", "sent blocking to rank " << dest << " with tag=" << tag);
-      } else {
-        // got never in here
-        ML_CLOG(DEBUG, "Encap", "waiting on last send request to finish");
-        err = MPI_Wait(&(this->send_request), &stat);
-        check_mpi_error(err);
-        ML_CLOG(DEBUG, "Encap", "waited on last send request: " << stat);
-        ML_CLOG(DEBUG, "Encap", "non-blocking sending to rank " << dest << " with tag=" << tag);
-        err = MPI_Isend(this->data(), sizeof(scalar) * this->size(), MPI_CHAR,
-                        dest, tag, mpi.comm, &(this->send_request));
-        check_mpi_error(err);
-        ML_CLOG(DEBUG, "Encap", "sent non-blocking to rank " << dest << " with tag=" << tag);
-      }
+      this->send_buffer(comm, tag, blocking, this->data(), sizeof(scalar) * this->size());
     }
 
     template<typename scalar, typename time>
     void VectorEncapsulation<scalar, time>::broadcast(ICommunicator* comm)
     {
-      auto& mpi = as_mpi(comm);
-      ML_CLOG(DEBUG, "Encap", "broadcasting");
-      int err = MPI_Bcast(this->data(), sizeof(scalar) * this->size(), MPI_CHAR,
-                          comm->size()-1, mpi.comm);
-      check_mpi_error(err);
-      ML_CLOG(DEBUG, "Encap", "broadcasted");
+      this->broadcast(comm, comm->size() - 1);
+    }
+
+    template<typename scalar, typename time>
+    void VectorEncapsulation<scalar, time>::broadcast(ICommunicator* comm, int root)
+    {
+      this->broadcast_buffer(comm, root, this->data(), sizeof(scalar) * this->size());
     }
 #endif
 
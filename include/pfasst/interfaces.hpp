@@ -64,11 +64,60 @@ namespace pfasst
    */
   class ICommunicator
   {
+    protected:
+      //! Whether the last rank sends to the first one (see set_periodic()).
+      bool periodic;
+
     public:
+      ICommunicator();
       virtual ~ICommunicator();
       virtual int size() = 0;
       virtual int rank() = 0;
 
+      //! @{
+      /**
+       * Whether the ranks form a ring, i.e. the last rank sends to the first one.
+       *
+       * Defaults to `false`.
+       *
+       * @since v0.6.0
+       */
+      virtual void set_periodic(bool periodic);
+      virtual bool is_periodic();
+
+      /**
+       * Whether this rank sends to a next rank.
+       *
+       * @since v0.6.0
+       */
+      virtual bool has_next();
+
+      /**
+       * Whether this rank receives from a previous rank.
+       *
+       * @since v0.6.0
+       */
+      virtual bool has_previous();
+
+      //! Rank to send to; only meaningful if has_next().
+      virtual int next();
+
+      //! Rank to receive from; only meaningful if has_previous().
+      virtual int previous();
+      //! @}
+
+      /**
+       * Communicator of the first @p size ranks.
+       *
+       * Must be called by all ranks.
+       *
+       * @param[in] size number of ranks of the new communicator
+       * @returns new communicator on the first @p size ranks; `nullptr` on all others
+       *
+       * @since v0.6.0
+       */
+      virtual shared_ptr<ICommunicator> sub_communicator(int size);
+
       shared_ptr<IStatus> status;
   };
 
@@ -139,6 +188,24 @@ namespace pfasst
       virtual void send(int tag) = 0;
       virtual void recv(int tag) = 0;
       //! @}
+
+      //! @{
+      /**
+       * Send @p value to the next rank (see ICommunicator::next()).
+       *
+       * Used by the sliding-window PFASST to hand on the state of the window.
+       *
+       * @since v0.6.0
+       */
+      virtual void send_value(int tag, int value);
+
+      /**
+       * Receive a value sent by send_value() of the previous rank.
+       *
+       * @since v0.6.0
+       */
+      virtual int recv_value(int tag);
+      //! @}
   };
 
 
@@ -244,6 +311,19 @@ namespace pfasst
        * Initialize solution values at all time nodes with meaningful values.
        */
       virtual void spread();
+
+      /**
+       * Estimate of the local error of the current time step.
+       *
+       * Used by controllers with adaptive step sizes (see Controller::set_step_size_control()),
+       * which call it on the finest level once the iterations of a time step are done.
+       *
+       * @returns estimated local error; negative if no estimate is available (yet)
+       *
+       * @note This method must be implemented in derived sweepers.
+       * @since v0.6.0
+       */
+      virtual time estimate_error();
       //! @}
 
       //! @{
@@ -261,6 +341,15 @@ namespace pfasst
        * Hook automatically run after each completed time step.
        */
       virtual void post_step();
+
+      /**
+       * Hook automatically run after the controller changed the step size.
+       *
+       * Sweepers drop or recompute caches depending on the step size here.
+       *
+       * @since v0.6.0
+       */
+      virtual void post_step_size_change();
       //! @}
 
       //! @{
@@ -268,6 +357,15 @@ namespace pfasst
       virtual void send(ICommunicator* comm, int tag, bool blocking);
       virtual void recv(ICommunicator* comm, int tag, bool blocking);
       virtual void broadcast(ICommunicator* comm);
+
+      /**
+       * Copy the end state of rank @p root to all other ranks of @p comm.
+       *
+       * Used by PFASST to hand the final solution of a partial block to the idle ranks.
+       *
+       * @since v0.6.0
+       */
+      virtual void broadcast_end_state(ICommunicator* comm, int root);
       //! @}
   };
 
@@ -35,9 +35,49 @@ namespace pfasst
   }
 
 
+  ICommunicator::ICommunicator()
+    : periodic(false)
+  {}
+
   ICommunicator::~ICommunicator()
   {}
 
+  void ICommunicator::set_periodic(bool periodic)
+  {
+    this->periodic = periodic;
+  }
+
+  bool ICommunicator::is_periodic()
+  {
+    return this->periodic;
+  }
+
+  bool ICommunicator::has_next()
+  {
+    return this->size() > 1 && (this->periodic || this->rank() < this->size() - 1);
+  }
+
+  bool ICommunicator::has_previous()
+  {
+    return this->size() > 1 && (this->periodic || this->rank() > 0);
+  }
+
+  int ICommunicator::next()
+  {
+    return (this->rank() + 1) % this->size();
+  }
+
+  int ICommunicator::previous()
+  {
+    return (this->rank() + this->size() - 1) % this->size();
+  }
+
+  shared_ptr<ICommunicator> ICommunicator::sub_communicator(int size)
+  {
+    UNUSED(size);
+    throw NotImplementedYet("sub-communicators");
+  }
+
 
   IStatus::~IStatus()
   {}
@@ -47,6 +87,18 @@ namespace pfasst
     this->comm = comm;
   }
 
+  void IStatus::send_value(int tag, int value)
+  {
+    UNUSED(tag); UNUSED(value);
+    throw NotImplementedYet("sliding window");
+  }
+
+  int IStatus::recv_value(int tag)
+  {
+    UNUSED(tag);
+    throw NotImplementedYet("sliding window");
+  }
+
   bool IStatus::previous_is_iterating()
   {
     if (this->comm->rank() == 0) {
@@ -115,6 +167,12 @@ namespace pfasst
     throw NotImplementedYet("pfasst");
   }
 
+  template<typename time>
+  time ISweeper<time>::estimate_error()
+  {
+    throw NotImplementedYet("adaptive time stepping");
+  }
+
   template<typename time>
   void ISweeper<time>::post_sweep()
   {}
@@ -127,6 +185,10 @@ namespace pfasst
   void ISweeper<time>::post_step()
   {}
 
+  template<typename time>
+  void ISweeper<time>::post_step_size_change()
+  {}
+
   template<typename time>
   void ISweeper<time>::post(ICommunicator* comm, int tag)
   {
@@ -154,6 +216,13 @@ namespace pfasst
     throw NotImplementedYet("pfasst");
   }
 
+  template<typename time>
+  void ISweeper<time>::broadcast_end_state(ICommunicator* comm, int root)
+  {
+    UNUSED(comm); UNUSED(root);
+    throw NotImplementedYet("pfasst");
+  }
+
 
   template<typename time>
   ITransfer<time>::~ITransfer()
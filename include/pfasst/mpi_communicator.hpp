@@ -79,6 +79,9 @@ namespace pfasst
         int _rank;
         int _size;
         string _name;
+
+        //! Whether #comm has been created by this communicator and is freed on destruction.
+        bool _owned;
         //! @}
 
       public:
@@ -89,6 +92,7 @@ namespace pfasst
         //! @{
         MPICommunicator();
         MPICommunicator(MPI_Comm comm);
+        virtual ~MPICommunicator();
         //! @}
 
         //! @{
@@ -96,6 +100,14 @@ namespace pfasst
         virtual int size();
         virtual int rank();
         virtual string name();
+
+        /**
+         * @copybrief ICommunicator::sub_communicator()
+         *
+         * Splits #comm via `MPI_Comm_split`; the new `MPI_Comm` is freed with the returned
+         * communicator.
+         */
+        virtual shared_ptr<ICommunicator> sub_communicator(int size) override;
         //! @}
     };
 
@@ -115,6 +127,11 @@ namespace pfasst
         virtual void post(int tag) override;
         virtual void send(int tag) override;
         virtual void recv(int tag) override;
+
+        //! @{
+        virtual void send_value(int tag, int value) override;
+        virtual int recv_value(int tag) override;
+        //! @}
     };
   }  // ::pfasst::mpi
 }  // ::pfasst
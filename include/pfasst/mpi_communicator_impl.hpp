@@ -27,13 +27,24 @@ namespace pfasst
 
 
     MPICommunicator::MPICommunicator()
+      : _owned(false)
     {}
 
     MPICommunicator::MPICommunicator(MPI_Comm comm)
+      : _owned(false)
     {
       set_comm(comm);
     }
 
+    MPICommunicator::~MPICommunicator()
+    {
+      int finalized = 0;
+      MPI_Finalized(&finalized);
+      if (this->_owned && !finalized) {
+        MPI_Comm_free(&this->comm);
+      }
+    }
+
     void MPICommunicator::set_comm(MPI_Comm comm)
     {
       this->comm = comm;
@@ -69,6 +80,26 @@ namespace pfasst
       return this->_name;
     }
 
+    shared_ptr<ICommunicator> MPICommunicator::sub_communicator(int size)
+    {
+      if (size < 1 || size > this->size()) {
+        throw ValueError("invalid size of sub-communicator: " + to_string(size));
+      }
+
+      MPI_Comm sub_comm = MPI_COMM_NULL;
+      int color = (this->rank() < size) ? 0 : MPI_UNDEFINED;
+      int err = MPI_Comm_split(this->comm, color, this->rank(), &sub_comm);
+      check_mpi_error(err);
+      if (sub_comm == MPI_COMM_NULL) {
+        return nullptr;
+      }
+
+      auto sub = make_shared<MPICommunicator>(sub_comm);
+      sub->_owned = true;
+      ML_CLOG(DEBUG, "Controller", "created sub-communicator of the first " << size << " ranks");
+      return sub;
+    }
+
 
     void MPIStatus::set_comm(ICommunicator* comm)
     {
@@ -142,6 +173,31 @@ namespace pfasst
 
       converged.at(mpi->rank() - 1) = (iconverged == IStatus::CONVERGED) ? true : false;
     }
+
+    void MPIStatus::send_value(int tag, int value)
+    {
+      if (!mpi->has_next()) { return; }
+
+      ML_CLOG(DEBUG, "Controller", "sending value " << value << " to rank " << mpi->next()
+                                   << " with tag " << tag);
+      int err = MPI_Send(&value, 1, MPI_INT, mpi->next(), tag, mpi->comm);
+      check_mpi_error(err);
+    }
+
+    int MPIStatus::recv_value(int tag)
+    {
+      if (!mpi->has_previous()) {
+        throw MPIError("no previous rank to receive a value from");
+      }
+
+      MPI_Status stat = MPI_Status_factory();
+      int value = 0;
+      int err = MPI_Recv(&value, 1, MPI_INT, mpi->previous(), tag, mpi->comm, &stat);
+      check_mpi_error(err);
+      ML_CLOG(DEBUG, "Controller", "received value " << value << " from rank " << mpi->previous()
+                                   << " with tag " << tag);
+      return value;
+    }
   }  // ::pfasst::mpi
 }  // ::pfasst
 
@@ -25,6 +25,7 @@ using Matrix = Eigen::Matrix<scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowM
 #include "pfasst/quadrature/gauss_radau.hpp"
 #include "pfasst/quadrature/clenshaw_curtis.hpp"
 #include "pfasst/quadrature/uniform.hpp"
+#include "pfasst/quadrature/q_delta.hpp"
 
 template<typename scalar>
 using Matrix = Eigen::Matrix<scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
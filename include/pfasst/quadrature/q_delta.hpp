@@ -0,0 +1,210 @@
+/**
+ * @file pfasst/quadrature/q_delta.hpp
+ * @since v0.6.0
+ */
+#ifndef _PFASST__QUADRATURE__Q_DELTA_HPP_
+#define _PFASST__QUADRATURE__Q_DELTA_HPP_
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+using namespace std;
+
+#include <Eigen/Dense>
+template<typename scalar>
+using Matrix = Eigen::Matrix<scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+#include "pfasst/globals.hpp"
+#include "pfasst/interfaces.hpp"
+#include "pfasst/quadrature/interface.hpp"
+
+
+namespace pfasst
+{
+  namespace quadrature
+  {
+    /**
+     * Type descriptors of the preconditioners \\( Q_\\Delta \\) of SDC sweeps.
+     *
+     * A sweep solves the collocation problem \\( U = U_0 + \\Delta t Q F(U) \\) approximately by
+     * iterating
+     * \\( U^{k+1} = U_0 + \\Delta t Q_\\Delta (F(U^{k+1}) - F(U^k)) + \\Delta t Q F(U^k) \\)
+     * with a lower triangular approximation \\( Q_\\Delta \\) of \\( Q \\).
+     * Hence, the choice of \\( Q_\\Delta \\) decides about the rate of convergence of the
+     * iteration.
+     *
+     * @see pfasst::quadrature::compute_q_delta()
+     * @since v0.6.0
+     */
+    enum class QDeltaType : int {
+        ImplicitEuler   =  0  //!< backward Euler steps from node to node
+      , ExplicitEuler   =  1  //!< forward Euler steps from node to node; strictly lower triangular
+      , LU              =  2  //!< \\( U^T \\) of the LU decomposition of \\( Q^T \\) (LU trick by Weiser)
+      , MIN             =  3  //!< diagonal with \\( \\tau_m / M \\) (MIN-SR-NS by Speck et al.)
+      , Trapezoidal     =  4  //!< Crank-Nicolson steps from node to node, i.e. the implicit trapezoidal rule
+      , EulerLU         =  5  //!< backward Euler steps from node to node with the \\( U^T \\) of QDeltaType::LU below the diagonal
+      , UNDEFINED       = -1
+    };
+
+
+    /**
+     * LU decomposition without pivoting of a square matrix.
+     *
+     * @tparam scalar precision of the matrix entries (i.e. `double`)
+     * @param[in] A square matrix to decompose
+     * @param[out] L unit lower triangular factor
+     * @param[out] U upper triangular factor
+     * @throws pfasst::ValueError if a pivot vanishes, i.e. the decomposition does not exist
+     *   without pivoting
+     *
+     * @since v0.6.0
+     */
+    template<typename scalar>
+    static void lu_decomposition(const Matrix<scalar>& A, Matrix<scalar>& L, Matrix<scalar>& U)
+    {
+      assert(A.rows() == A.cols());
+      const Index<scalar> n = A.rows();
+
+      L = Matrix<scalar>::Identity(n, n);
+      U = Matrix<scalar>::Zero(n, n);
+
+      for (Index<scalar> k = 0; k < n; ++k) {
+        for (Index<scalar> j = k; j < n; ++j) {
+          U(k, j) = A(k, j) - L.row(k).head(k).dot(U.col(j).head(k));
+        }
+        if (U(k, k) == scalar(0.0)) {
+          throw ValueError("LU decomposition without pivoting does not exist");
+        }
+        for (Index<scalar> i = k + 1; i < n; ++i) {
+          L(i, k) = (A(i, k) - L.row(i).head(k).dot(U.col(k).head(k))) / U(k, k);
+        }
+      }
+    }
+
+
+    /**
+     * Compute the preconditioner \\( Q_\\Delta \\) of given type for a set of quadrature nodes.
+     *
+     * The resulting matrix has the same shape as the quadrature matrix \\( Q \\) and is lower
+     * triangular.
+     * With the left interval boundary being a node, the first row and column of \\( Q \\) do not
+     * enter the iteration (the value at the first node is the fixed initial value).
+     * They are zero in \\( Q_\\Delta \\) for the matrix based types (i.e. QDeltaType::LU,
+     * QDeltaType::EulerLU and QDeltaType::MIN), which are computed from the remaining block of
+     * \\( Q \\) and the remaining nodes.
+     *
+     * @tparam precision precision of quadrature (i.e. `double`)
+     * @param[in] nodes quadrature nodes
+     * @param[in] q_mat quadrature matrix \\( Q \\) of @p nodes
+     * @param[in] left_is_node whether the first node is the left interval boundary
+     * @param[in] type descriptor of the preconditioner
+     * @returns \\( Q_\\Delta \\) with `nodes.size()` rows and columns
+     * @throws pfasst::ValueError if @p type is not a valid descriptor
+     *
+     * @since v0.6.0
+     */
+    template<typename precision>
+    static Matrix<precision> compute_q_delta(const vector<precision>& nodes,
+                                             const Matrix<precision>& q_mat,
+                                             const bool left_is_node, const QDeltaType type)
+    {
+      const size_t num_nodes = nodes.size();
+      assert(size_t(q_mat.rows()) == num_nodes && size_t(q_mat.cols()) == num_nodes);
+
+      // widths of the intervals from the previous node (or the left boundary) to node m
+      vector<precision> tau(num_nodes);
+      for (size_t m = 0; m < num_nodes; ++m) {
+        tau[m] = (m == 0) ? nodes[0] : nodes[m] - nodes[m - 1];
+      }
+
+      const size_t first = left_is_node ? 1 : 0;
+      const size_t num_free = num_nodes - first;
+
+      Matrix<precision> q_delta = Matrix<precision>::Zero(num_nodes, num_nodes);
+
+      switch (type) {
+        case QDeltaType::ImplicitEuler:
+          for (size_t m = 0; m < num_nodes; ++m) {
+            for (size_t j = 0; j <= m; ++j) {
+              q_delta(m, j) = tau[j];
+            }
+          }
+          break;
+
+        case QDeltaType::ExplicitEuler:
+          for (size_t m = 0; m < num_nodes; ++m) {
+            for (size_t j = 0; j < m; ++j) {
+              q_delta(m, j) = tau[j + 1];
+            }
+          }
+          break;
+
+        case QDeltaType::Trapezoidal:
+          // without the left boundary as a node, the term of the fixed initial value is dropped
+          for (size_t m = 0; m < num_nodes; ++m) {
+            for (size_t j = 0; j <= m; ++j) {
+              q_delta(m, j) = 0.5 * (tau[j] + ((j < m) ? tau[j + 1] : precision(0.0)));
+            }
+          }
+          break;
+
+        case QDeltaType::LU:
+          if (num_free > 0) {
+            Matrix<precision> qt = q_mat.block(first, first, num_free, num_free).transpose();
+            Matrix<precision> L, U;
+            lu_decomposition(qt, L, U);
+            q_delta.block(first, first, num_free, num_free) = U.transpose();
+          }
+          break;
+
+        case QDeltaType::EulerLU:
+          // node-to-node form first: tau on the diagonal, U^T below; then summed up to '0 to node'
+          if (num_free > 0) {
+            Matrix<precision> qt = q_mat.block(first, first, num_free, num_free).transpose();
+            Matrix<precision> L, U;
+            lu_decomposition(qt, L, U);
+            q_delta.block(first, first, num_free, num_free) = U.transpose();
+            for (size_t m = first; m < num_nodes; ++m) {
+              q_delta(m, m) = tau[m];
+            }
+            for (size_t m = first + 1; m < num_nodes; ++m) {
+              q_delta.row(m) += q_delta.row(m - 1);
+            }
+          }
+          break;
+
+        case QDeltaType::MIN:
+          for (size_t m = first; m < num_nodes; ++m) {
+            q_delta(m, m) = nodes[m] / precision(num_free);
+          }
+          break;
+
+        default:
+          throw ValueError("invalid Q_delta type");
+      }
+
+      return q_delta;
+    }
+
+
+    /**
+     * Compute the preconditioner \\( Q_\\Delta \\) of given type for a quadrature.
+     *
+     * @tparam precision precision of quadrature (i.e. `double`)
+     * @param[in] quad quadrature to compute \\( Q_\\Delta \\) for
+     * @param[in] type descriptor of the preconditioner
+     *
+     * @since v0.6.0
+     *
+     * @overload
+     */
+    template<typename precision>
+    static Matrix<precision> compute_q_delta(const IQuadrature<precision>& quad,
+                                             const QDeltaType type)
+    {
+      return compute_q_delta(quad.get_nodes(), quad.get_q_mat(), quad.left_is_node(), type);
+    }
+  }  // ::pfasst::quadrature
+}  // ::pfasst
+
+#endif  // _PFASST__QUADRATURE__Q_DELTA_HPP_
@@ -0,0 +1,18 @@
+/*
+ * DO NOT ALTER THIS FILE
+ *
+ * It will get rewritten on CMake's next run
+ */
+
+#ifndef _PFASST__SITE_CONFIG_HPP
+#define _PFASST__SITE_CONFIG_HPP
+
+#include <string>
+using namespace std;
+
+namespace pfasst
+{
+  static constexpr const char* VERSION = "";
+}  // ::pfasst
+
+#endif  // _PFASST__SITE_CONFIG_HPP
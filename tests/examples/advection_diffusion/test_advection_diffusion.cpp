@@ -120,6 +120,70 @@ TEST(ErrorTest, SerialMLSDC)
   EXPECT_THAT(err, testing::Pointwise(DoubleLess(), tol));
 }
 
+TEST(InterpolatedFunctionValuesTest, SerialMLSDC)
+{
+  typedef error_map::value_type vtype;
+
+  auto reference = get<0>(run_serial_mlsdc(2));
+  auto errors = get<0>(run_serial_mlsdc(2, 4, 0.01, 8, 5, 128, true));
+  auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+  auto get_error = [](const vtype x) { return get<1>(x); };
+
+  auto max_iter = get_iter(*std::max_element(errors.begin(), errors.end(),
+             [get_iter](const vtype p1, const vtype p2) { return get_iter(p1) < get_iter(p2); }));
+
+  // the problem is linear and the spectral interpolation commutes with the right hand side, thus
+  // interpolating the function values converges to the same solution
+  vector<double> tol, err;
+  for (auto& x: errors) {
+    if (get_iter(x) == max_iter) {
+      err.push_back(get_error(x));
+      tol.push_back(reference[x.first] + 1e-12);
+    }
+  }
+
+  EXPECT_THAT(err, testing::Pointwise(DoubleLess(), tol));
+}
+
+TEST(CycleScheduleTest, SerialMLSDC)
+{
+  typedef error_map::value_type vtype;
+  auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+  auto get_error = [](const vtype x) { return get<1>(x); };
+
+  auto w_cycle = make_shared<pfasst::CycleSchedule>(pfasst::CycleShape::W);
+  auto f_cycle = make_shared<pfasst::CycleSchedule>(pfasst::CycleShape::F, true);
+  auto v_cycle = make_shared<pfasst::CycleSchedule>(pfasst::CycleShape::V, true);
+  v_cycle->set_nsweeps({1, 2, 3});
+  v_cycle->set_nsweeps({1, 1, 1}, 2);
+
+  // error on the finest level after the first iteration of the first step
+  vector<double> first_errors;
+  for (auto schedule : { w_cycle, f_cycle, v_cycle }) {
+    auto errors = get<0>(run_serial_mlsdc(3, 4, 0.01, 8, 5, 128, false, schedule));
+    first_errors.push_back(errors[ktype(0, 1)]);
+
+    auto max_iter = get_iter(*std::max_element(errors.begin(), errors.end(),
+               [get_iter](const vtype p1, const vtype p2) { return get_iter(p1) < get_iter(p2); }));
+
+    vector<double> tol = { 8e-10, 8e-10, 8e-10, 8e-10 };
+    vector<double> err;
+    for (auto& x: errors) {
+      if (get_iter(x) == max_iter) {
+        err.push_back(get_error(x));
+      }
+    }
+
+    EXPECT_THAT(err, testing::Pointwise(DoubleLess(), tol))
+      << "shape " << int(schedule->get_shape());
+  }
+
+  // the schedules do different work in each iteration
+  EXPECT_NE(first_errors[0], first_errors[1]);
+  EXPECT_NE(first_errors[0], first_errors[2]);
+  EXPECT_NE(first_errors[1], first_errors[2]);
+}
+
 TEST(FASTest, SerialMLSDC)
 {
   typedef error_map::key_type ktype;
@@ -154,6 +218,73 @@ TEST(FASTest, SerialMLSDC)
   ASSERT_NEAR(residuals[2][ktype(3, 8)], 7.07458e-13, 1.e-15);
 }
 
+/*
+ * adaptive step sizes: starting from a single step over the whole interval, rejected steps are
+ * repeated on all levels with the reduced step size and the error has to follow the tolerance
+ */
+TEST(AdaptiveStepSizeTest, SerialMLSDC)
+{
+  const double end_time = 0.08;
+  const vector<double> tols = { 1e-7, 1e-9 };
+
+  size_t prev_accepted = 0;
+  for (double tol : tols) {
+    auto control = make_shared<pfasst::StepSizeControl<>>(tol, 4);
+    auto errors = get<0>(run_serial_mlsdc(3, 1, end_time, 8, 5, 128, false, nullptr, control));
+
+    EXPECT_THAT(errors.rbegin()->second, testing::Lt(10.0 * tol)) << "tolerance " << tol;
+    EXPECT_THAT(control->get_num_rejected(), testing::Ge(1u)) << "tolerance " << tol;
+    EXPECT_THAT(control->get_num_accepted(), testing::Gt(prev_accepted)) << "tolerance " << tol;
+    prev_accepted = control->get_num_accepted();
+  }
+}
+
+/*
+ * a rejected step has to reach post_step_size_change() on the coarse levels as well
+ */
+class StepSizeChangeSweeper
+  : public AdvectionDiffusionSweeper<>
+{
+  public:
+    size_t nchanges = 0;
+
+    using AdvectionDiffusionSweeper<>::AdvectionDiffusionSweeper;
+
+    void post_step_size_change() override
+    {
+      this->nchanges++;
+      AdvectionDiffusionSweeper<>::post_step_size_change();
+    }
+};
+
+TEST(AdaptiveStepSizeTest, CoarseLevelsSeeStepSizeChanges)
+{
+  pfasst::MLSDC<> mlsdc;
+
+  size_t ndofs = 64, nnodes = 5;
+  vector<shared_ptr<StepSizeChangeSweeper>> sweepers;
+  for (size_t l = 0; l < 2; l++) {
+    auto sweeper = make_shared<StepSizeChangeSweeper>(ndofs);
+    sweeper->set_quadrature(pfasst::quadrature::quadrature_factory(nnodes, pfasst::quadrature::QuadratureType::GaussLobatto));
+    sweeper->set_factory(make_shared<PooledEncapFactory<>>(make_shared<VectorFactory<double>>(ndofs)));
+    mlsdc.add_level(sweeper, make_shared<SpectralTransfer1D<>>());
+    sweepers.push_back(sweeper);
+    ndofs /= 2;
+    nnodes = (nnodes - 1) / 2 + 1;
+  }
+  mlsdc.setup();
+  sweepers[0]->exact(sweepers[0]->get_start_state(), 0.0);
+
+  auto control = make_shared<pfasst::StepSizeControl<>>(1e-8, 4);
+  mlsdc.set_duration(0.0, 0.08, 0.08, 6);
+  mlsdc.set_step_size_control(control);
+  mlsdc.run();
+
+  ASSERT_THAT(control->get_num_rejected(), testing::Ge(1u));
+  EXPECT_THAT(sweepers[0]->nchanges, testing::Ge(control->get_num_rejected()));
+  EXPECT_EQ(sweepers[1]->nchanges, sweepers[0]->nchanges);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
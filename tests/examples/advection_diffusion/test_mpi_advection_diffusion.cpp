@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <tuple>
 #include <vector>
 using namespace std;
@@ -16,6 +17,7 @@ using namespace ::testing;
 
 #define PFASST_UNIT_TESTING
 #include "../examples/advection_diffusion/mpi_pfasst.cpp"
+#include "../examples/advection_diffusion/mpi_parareal.cpp"
 #undef PFASST_UNIT_TESTING
 using namespace pfasst::examples::advection_diffusion;
 
@@ -65,6 +67,281 @@ TEST(AdaptiveErrorTest, MPIPFASST)
   ASSERT_EQ(max_iter, (size_t) ic[rank]);
 }
 
+TEST(PartialBlockErrorTest, MPIPFASST)
+{
+  typedef error_map::value_type vtype;
+
+  // six steps on four processes: the second block only runs on the first two
+  auto errors = run_mpi_pfasst(0.0, 0.0, 4, 6, 0.01, 128, 64, 5, 3);
+
+  auto get_step  = [](const vtype x) { return get<0>(get<0>(x)); };
+  auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+  auto get_error = [](const vtype x) { return get<1>(x); };
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  vector<size_t> steps;
+  for (auto& x: errors) {
+    if (steps.empty() || steps.back() != get_step(x)) {
+      steps.push_back(get_step(x));
+    }
+  }
+  vector<size_t> expected_steps = { size_t(rank) };
+  if (rank + 4 < 6) {
+    expected_steps.push_back(rank + 4);
+  }
+  EXPECT_THAT(steps, Eq(expected_steps));
+
+  auto max_iter = get_iter(*std::max_element(errors.begin(), errors.end(),
+             [get_iter](const vtype p1, const vtype p2) { return get_iter(p1) < get_iter(p2); }));
+
+  for (auto& x: errors) {
+    if (get_iter(x) == max_iter) {
+      EXPECT_LE(get_error(x), 1e-11) << "step " << get_step(x);
+    }
+  }
+}
+
+TEST(BlockLengthErrorTest, MPIPFASST)
+{
+  typedef error_map::value_type vtype;
+
+  // ten steps in blocks of three on four processes: the last process idles throughout and the
+  // last block only runs on the first process
+  auto errors = run_mpi_pfasst(0.0, 0.0, 4, 10, 0.01, 128, 64, 5, 3, false, nullptr, 3);
+
+  auto get_step  = [](const vtype x) { return get<0>(get<0>(x)); };
+  auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+  auto get_error = [](const vtype x) { return get<1>(x); };
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  vector<size_t> steps;
+  for (auto& x: errors) {
+    if (steps.empty() || steps.back() != get_step(x)) {
+      steps.push_back(get_step(x));
+    }
+  }
+  vector<size_t> expected_steps;
+  for (size_t step = rank; rank < 3 && step < 10; step += 3) {
+    expected_steps.push_back(step);
+  }
+  EXPECT_THAT(steps, Eq(expected_steps));
+  if (errors.empty()) {
+    return;
+  }
+
+  auto max_iter = get_iter(*std::max_element(errors.begin(), errors.end(),
+             [get_iter](const vtype p1, const vtype p2) { return get_iter(p1) < get_iter(p2); }));
+
+  for (auto& x: errors) {
+    if (get_iter(x) == max_iter) {
+      EXPECT_LE(get_error(x), 1e-11) << "step " << get_step(x);
+    }
+  }
+}
+
+TEST(SlidingWindowErrorTest, MPIPFASST)
+{
+  typedef error_map::value_type vtype;
+
+  // ten steps on four processes, each step iterating until its residual has converged
+  auto errors = run_mpi_pfasst(1.e-8, 0.0, 12, 10, 0.01, 128, 64, 5, 3, true);
+
+  auto get_step  = [](const vtype x) { return get<0>(get<0>(x)); };
+  auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+  auto get_error = [](const vtype x) { return get<1>(x); };
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  vector<size_t> steps;
+  map<size_t, size_t> last_iter;
+  for (auto& x: errors) {
+    if (steps.empty() || steps.back() != get_step(x)) {
+      steps.push_back(get_step(x));
+    }
+    last_iter[get_step(x)] = max(last_iter[get_step(x)], get_iter(x));
+  }
+  vector<size_t> expected_steps;
+  for (size_t n = rank; n < 10; n += 4) {
+    expected_steps.push_back(n);
+  }
+  EXPECT_THAT(steps, Eq(expected_steps));
+
+  for (auto& x: errors) {
+    if (get_iter(x) == last_iter[get_step(x)]) {
+      EXPECT_LE(get_error(x), 5e-8) << "step " << get_step(x);
+    }
+  }
+}
+
+TEST(SlidingWindowConvergedTest, MPIPFASST)
+{
+  typedef error_map::value_type vtype;
+
+  // with a single iteration per step, all steps of a window finish in their first iteration, thus
+  // the next window starts behind the newest step
+  auto errors = run_mpi_pfasst(0.0, 0.0, 1, 10, 0.01, 128, 64, 5, 3, true);
+
+  auto get_step  = [](const vtype x) { return get<0>(get<0>(x)); };
+  auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  vector<size_t> steps;
+  for (auto& x: errors) {
+    if (steps.empty() || steps.back() != get_step(x)) {
+      steps.push_back(get_step(x));
+    }
+    EXPECT_EQ(get_iter(x), 0u) << "step " << get_step(x);
+  }
+  vector<size_t> expected_steps;
+  for (size_t n = rank; n < 10; n += 4) {
+    expected_steps.push_back(n);
+  }
+  EXPECT_THAT(steps, Eq(expected_steps));
+}
+
+TEST(CycleScheduleErrorTest, MPIPFASST)
+{
+  typedef error_map::value_type vtype;
+
+  // W-cycles with the full multigrid start-up and more coarse sweeps in the first iteration
+  auto schedule = make_shared<pfasst::CycleSchedule>(pfasst::CycleShape::W, true);
+  schedule->set_nsweeps({2, 3});
+  schedule->set_nsweeps({2, 1}, 1);
+
+  for (bool sliding : { false, true }) {
+    auto errors = run_mpi_pfasst(0.0, 0.0, 4, 4, 0.01, 128, 64, 5, 3, sliding, schedule);
+    auto get_step  = [](const vtype x) { return get<0>(get<0>(x)); };
+    auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+    auto get_error = [](const vtype x) { return get<1>(x); };
+
+    auto max_iter = get_iter(*std::max_element(errors.begin(), errors.end(),
+               [get_iter](const vtype p1, const vtype p2) { return get_iter(p1) < get_iter(p2); }));
+
+    vector<double> ub = { 1.e-12, 1.e-12, 2.5e-12, 5.e-12 };
+    for (auto& x: errors) {
+      if (get_iter(x) == max_iter) {
+        EXPECT_LE(get_error(x), ub[get_step(x)]) << "sliding " << boolalpha << sliding;
+      }
+    }
+  }
+}
+
+TEST(MixedPrecisionErrorTest, MPIPFASST)
+{
+  typedef error_map::value_type vtype;
+
+  // the coarse level stores the full FAS solution in single precision, thus its rounding errors
+  // bound the attainable accuracy: the solution peaks at about 2, where single precision values
+  // are 2.4e-7 apart; the error levels off below 1.5e-7 from the third iteration on
+  // (the second one still has 1.5e-6), and the bound leaves a factor of about 2 to the spacing
+  auto errors = run_mpi_pfasst<float>(0.0, 0.0, 4, 4, 0.01, 128, 64, 5, 3);
+  auto get_step  = [](const vtype x) { return get<0>(get<0>(x)); };
+  auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+  auto get_error = [](const vtype x) { return get<1>(x); };
+
+  auto max_iter = get_iter(*std::max_element(errors.begin(), errors.end(),
+             [get_iter](const vtype p1, const vtype p2) { return get_iter(p1) < get_iter(p2); }));
+
+  vector<double> ub = { 5.e-7, 5.e-7, 5.e-7, 5.e-7 };
+  for (auto& x: errors) {
+    if (get_iter(x) == max_iter) {
+      EXPECT_LE(get_error(x), ub[get_step(x)]);
+    }
+  }
+}
+
+TEST(ErrorTest, MPIParareal)
+{
+  typedef error_map::value_type vtype;
+
+  // two blocks of four steps; each step converges once all previous steps have
+  auto errors = run_mpi_parareal(1.e-12, 0.0, 0.0, 8, 8, 0.01, 128, 64, 5, 3);
+  auto get_step  = [](const vtype x) { return get<0>(get<0>(x)); };
+  auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+  auto get_error = [](const vtype x) { return get<1>(x); };
+
+  map<size_t, size_t> last_iter;
+  for (auto& x: errors) {
+    last_iter[get_step(x)] = max(last_iter[get_step(x)], get_iter(x));
+  }
+  ASSERT_THAT(last_iter.size(), Eq(2u));
+  for (auto& x: last_iter) {
+    EXPECT_LE(x.second, x.first % 4) << "step " << x.first;
+  }
+
+  for (auto& x: errors) {
+    if (get_iter(x) == last_iter[get_step(x)]) {
+      EXPECT_LE(get_error(x), 1e-11) << "step " << get_step(x);
+    }
+  }
+}
+
+TEST(PipelinedErrorTest, MPIParareal)
+{
+  typedef error_map::value_type vtype;
+
+  // ten steps on four processes, with the same end values as in block mode
+  const size_t nsteps = 10;
+  auto block = run_mpi_parareal(1.e-12, 0.0, 0.0, 12, nsteps, 0.01, 128, 64, 5, 3, 2);
+  auto errors = run_mpi_parareal(1.e-12, 0.0, 0.0, 12, nsteps, 0.01, 128, 64, 5, 3, 2, true);
+
+  auto get_step  = [](const vtype x) { return get<0>(get<0>(x)); };
+  auto get_iter  = [](const vtype x) { return get<1>(get<0>(x)); };
+  auto get_error = [](const vtype x) { return get<1>(x); };
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  map<size_t, double> block_error, last_error;
+  map<size_t, size_t> block_iter, last_iter;
+  for (auto& x: block) {
+    if (get_iter(x) >= block_iter[get_step(x)]) {
+      block_iter[get_step(x)] = get_iter(x);
+      block_error[get_step(x)] = get_error(x);
+    }
+  }
+  for (auto& x: errors) {
+    if (get_iter(x) >= last_iter[get_step(x)]) {
+      last_iter[get_step(x)] = get_iter(x);
+      last_error[get_step(x)] = get_error(x);
+    }
+  }
+
+  vector<size_t> steps, expected_steps;
+  for (auto& x: last_error) {
+    steps.push_back(x.first);
+  }
+  for (size_t n = rank; n < nsteps; n += 4) {
+    expected_steps.push_back(n);
+  }
+  EXPECT_THAT(steps, Eq(expected_steps));
+
+  for (auto& x: last_error) {
+    EXPECT_LE(x.second, 1e-11) << "step " << x.first;
+    EXPECT_NEAR(x.second, block_error[x.first], 1e-14) << "step " << x.first;
+  }
+}
+
+TEST(StepSizeControlTest, MPIControllersRejectControl)
+{
+  MPICommunicator comm(MPI_COMM_WORLD);
+  auto control = make_shared<pfasst::StepSizeControl<>>(1e-8, 4);
+
+  pfasst::PFASST<> pf;
+  pf.set_comm(&comm);
+  pf.set_duration(0.0, 0.04, 0.01, 4);
+  pf.set_step_size_control(control);
+  EXPECT_THROW(pf.run(), pfasst::NotImplementedYet);
+
+  pfasst::Parareal<> pr;
+  pr.set_comm(&comm);
+  pr.set_duration(0.0, 0.04, 0.01, 4);
+  pr.set_step_size_control(control);
+  EXPECT_THROW(pr.run(), pfasst::NotImplementedYet);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -2,6 +2,7 @@
  * Tests for the scalar example solving the test equation
  */
 #include <cmath>
+#include <functional>
 using namespace std;
 
 #include <gtest/gtest.h>
@@ -153,6 +154,273 @@ INSTANTIATE_TEST_CASE_P(ScalarSDC, ConvergenceTest,
                                        pfasst::quadrature::QuadratureType::ClenshawCurtis,
                                        pfasst::quadrature::QuadratureType::Uniform)));
 
+/*
+ * adaptive step sizes: starting from a single step over the whole interval, the error has to
+ * follow the tolerance of the step size control
+ */
+TEST(AdaptiveTest, ErrorFollowsTolerance)
+{
+  const double end_time = 4.0;
+  const size_t nnodes = 5;
+  const complex<double> lambda = complex<double>(-1.0, 1.0);
+  const vector<double> tols = { 1e-6, 1e-8, 1e-10 };
+
+  size_t prev_accepted = 0;
+  for (double tol : tols) {
+    auto control = make_shared<pfasst::StepSizeControl<>>(tol, nnodes - 1);
+    double err = run_scalar_sdc(1, end_time, nnodes, 2 * nnodes - 2, lambda,
+                                pfasst::quadrature::QuadratureType::GaussLobatto, control);
+    EXPECT_THAT(err, Lt(10.0 * tol)) << "tolerance " << tol;
+    EXPECT_THAT(control->get_num_rejected(), Ge(1u)) << "tolerance " << tol;
+    EXPECT_THAT(control->get_num_accepted(), Gt(prev_accepted)) << "tolerance " << tol;
+    prev_accepted = control->get_num_accepted();
+  }
+}
+
+/*
+ * scalar sweeper counting the calls of the batched and the single node evaluations
+ */
+class CountingScalarSweeper
+  : public ScalarSweeper<>
+{
+  public:
+    typedef pfasst::encap::Encapsulation<double> encap_type;
+
+    size_t n_expl_all = 0, n_impl_all = 0;
+    size_t n_expl = 0, n_impl = 0;
+
+    using ScalarSweeper<>::ScalarSweeper;
+
+    void f_expl_eval(shared_ptr<encap_type> f_encap, shared_ptr<encap_type> q_encap,
+                     double t) override
+    {
+      this->n_expl++;
+      ScalarSweeper<>::f_expl_eval(f_encap, q_encap, t);
+    }
+
+    void f_impl_eval(shared_ptr<encap_type> f_encap, shared_ptr<encap_type> q_encap,
+                     double t) override
+    {
+      this->n_impl++;
+      ScalarSweeper<>::f_impl_eval(f_encap, q_encap, t);
+    }
+
+    void f_expl_eval_all(const vector<shared_ptr<encap_type>>& f_encaps,
+                         const vector<shared_ptr<encap_type>>& q_encaps,
+                         const vector<double>& ts) override
+    {
+      this->n_expl_all++;
+      ScalarSweeper<>::f_expl_eval_all(f_encaps, q_encaps, ts);
+    }
+
+    void f_impl_eval_all(const vector<shared_ptr<encap_type>>& f_encaps,
+                         const vector<shared_ptr<encap_type>>& q_encaps,
+                         const vector<double>& ts) override
+    {
+      this->n_impl_all++;
+      ScalarSweeper<>::f_impl_eval_all(f_encaps, q_encaps, ts);
+    }
+};
+
+/*
+ * reevaluating all nodes goes through one call of each batched hook; the ones of the example
+ * evaluate all nodes in a single loop with the same results as the single node evaluations
+ */
+TEST(BatchedEvaluationTest, ReevaluateUsesBatchedHooks)
+{
+  const size_t nnodes = 5;
+
+  pfasst::SDC<> sdc;
+  auto quad = pfasst::quadrature::quadrature_factory(nnodes,
+                                                     pfasst::quadrature::QuadratureType::GaussLobatto);
+  auto sweeper = make_shared<CountingScalarSweeper>(complex<double>(-1.0, 1.0), 1.0);
+  sweeper->set_quadrature(quad);
+  sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<complex<double>>>(1));
+  sdc.add_level(sweeper);
+  sdc.set_duration(0.0, 0.1, 0.1, 1);
+  sdc.setup();
+
+  sweeper->exact(sweeper->get_start_state(), 0.0);
+  sweeper->spread();
+  sweeper->reevaluate(false);
+
+  EXPECT_THAT(sweeper->n_expl_all, Eq(1u));
+  EXPECT_THAT(sweeper->n_impl_all, Eq(1u));
+  EXPECT_THAT(sweeper->n_expl, Eq(0u));
+  EXPECT_THAT(sweeper->n_impl, Eq(0u));
+
+  auto const fs = sweeper->get_function_values();
+  auto f = sweeper->get_factory()->create(pfasst::encap::function);
+  for (size_t m = 0; m < nnodes; m++) {
+    sweeper->f_expl_eval(f, sweeper->get_state(m), 0.0);
+    f->saxpy(-1.0, fs[0][m]);
+    EXPECT_THAT(f->norm0(), Eq(0.0)) << "explicit part at node " << m;
+    sweeper->f_impl_eval(f, sweeper->get_state(m), 0.0);
+    f->saxpy(-1.0, fs[1][m]);
+    EXPECT_THAT(f->norm0(), Eq(0.0)) << "implicit part at node " << m;
+  }
+  sweeper->n_expl = sweeper->n_impl = 0;
+
+  // the sweeps evaluate node by node
+  sweeper->sweep();
+  EXPECT_THAT(sweeper->n_expl_all, Eq(1u));
+  EXPECT_THAT(sweeper->n_impl_all, Eq(1u));
+  EXPECT_THAT(sweeper->n_expl, Eq(nnodes - 1));
+}
+
+/*
+ * preconditioners of the implicit part: with enough sweeps, all of them have to converge to the
+ * collocation solution
+ */
+static double run_scalar_q_delta(function<void(ScalarSweeper<>&)> configure, const size_t niters)
+{
+  pfasst::SDC<> sdc;
+  const complex<double> lambda = complex<double>(-1.0, 1.0);
+
+  auto sweeper = make_shared<ScalarSweeper<>>(lambda, complex<double>(1.0, 0.0));
+  sweeper->set_quadrature(pfasst::quadrature::quadrature_factory(5, pfasst::quadrature::QuadratureType::GaussLobatto));
+  sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<complex<double>>>(1));
+  configure(*sweeper);
+
+  sdc.add_level(sweeper);
+  sdc.set_duration(0.0, 0.5, 0.5, niters);
+  sdc.setup();
+  sweeper->exact(sweeper->get_start_state(), 0.0);
+  sdc.run();
+
+  return sweeper->get_errors();
+}
+
+TEST(QDeltaSweepTest, IMEXConvergesWithAllPreconditioners)
+{
+  using pfasst::quadrature::QDeltaType;
+  const double collocation = run_scalar_q_delta([](ScalarSweeper<>&) {}, 60);
+
+  for (auto type : { QDeltaType::LU, QDeltaType::MIN, QDeltaType::Trapezoidal,
+                     QDeltaType::EulerLU }) {
+    double err = run_scalar_q_delta([type](ScalarSweeper<>& s) { s.set_implicit_q_delta(type); },
+                                    40);
+    EXPECT_NEAR(err, collocation, 1e-13) << "Q_delta type " << int(type);
+  }
+
+  // a custom matrix: the mean of backward Euler and the LU trick
+  auto quad = pfasst::quadrature::quadrature_factory<double>(5, pfasst::quadrature::QuadratureType::GaussLobatto);
+  Matrix<double> custom = 0.5 * (pfasst::quadrature::compute_q_delta(*quad, QDeltaType::ImplicitEuler)
+                                 + pfasst::quadrature::compute_q_delta(*quad, QDeltaType::LU));
+  double err = run_scalar_q_delta([&custom](ScalarSweeper<>& s) { s.set_implicit_q_delta(custom); },
+                                  40);
+  EXPECT_NEAR(err, collocation, 1e-13) << "custom Q_delta";
+}
+
+/*
+ * the function values kept by save() must not outlive the solution values they belong to
+ */
+TEST(SavedFunctionValuesTest, InvalidatedByPredictAndAdvance)
+{
+  pfasst::SDC<> sdc;
+
+  auto sweeper = make_shared<ScalarSweeper<>>(complex<double>(-1.0, 1.0), complex<double>(1.0, 0.0));
+  sweeper->set_quadrature(pfasst::quadrature::quadrature_factory(3, pfasst::quadrature::QuadratureType::GaussLobatto));
+  sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<complex<double>>>(1));
+  sweeper->set_save_function_values(true);
+
+  sdc.add_level(sweeper);
+  sdc.set_duration(0.0, 0.2, 0.1, 2);
+  sdc.setup();
+  sweeper->exact(sweeper->get_start_state(), 0.0);
+
+  sweeper->predict(true);
+  sweeper->save(false);
+  EXPECT_TRUE(sweeper->has_saved_function_values());
+
+  sweeper->predict(false);
+  EXPECT_FALSE(sweeper->has_saved_function_values());
+
+  sweeper->sweep();
+  sweeper->save(false);
+  EXPECT_TRUE(sweeper->has_saved_function_values());
+
+  sweeper->advance();
+  EXPECT_FALSE(sweeper->has_saved_function_values());
+}
+
+/*
+ * scalar sweeper checking the '0 to node' integrals shared between the residual and the sweeps
+ */
+class QIntegralSweeper
+  : public ScalarSweeper<>
+{
+  public:
+    size_t nreused = 0;
+
+    QIntegralSweeper(const complex<double>& lambda, const complex<double>& u0)
+      : ScalarSweeper<>(lambda, u0)
+    {}
+
+    void predict(bool initial) override
+    {
+      ScalarSweeper<>::predict(initial);
+      EXPECT_FALSE(this->has_q_integrals(this->get_controller()->get_step_size()));
+    }
+
+    void sweep() override
+    {
+      auto const dt = this->get_controller()->get_step_size();
+      if (this->has_q_integrals(dt)) {
+        // the cached integrals are the ones of the current function values
+        auto ref = this->get_factory()->create_block(pfasst::encap::solution,
+                                                     this->get_nodes().size());
+        this->integrate(dt, ref);
+        auto const& q_int = this->get_q_integrals(dt);
+        for (size_t m = 0; m < ref.size(); m++) {
+          q_int[m]->saxpy(-1.0, ref[m]);
+          EXPECT_EQ(q_int[m]->norm0(), 0.0) << "node " << m;
+          q_int[m]->saxpy(1.0, ref[m]);
+        }
+        this->nreused++;
+      }
+      ScalarSweeper<>::sweep();
+    }
+
+    void advance() override
+    {
+      ScalarSweeper<>::advance();
+      EXPECT_FALSE(this->has_q_integrals(this->get_controller()->get_step_size()));
+    }
+};
+
+static pair<complex<double>, size_t> run_scalar_q_reuse(const double abs_res_tol)
+{
+  pfasst::SDC<> sdc;
+  auto sweeper = make_shared<QIntegralSweeper>(complex<double>(-1.0, 1.0),
+                                               complex<double>(1.0, 0.0));
+  sweeper->set_quadrature(pfasst::quadrature::quadrature_factory(5, pfasst::quadrature::QuadratureType::GaussLobatto));
+  sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<complex<double>>>(1));
+  sweeper->set_residual_tolerances(abs_res_tol, 0.0);
+
+  sdc.add_level(sweeper);
+  sdc.set_duration(0.0, 1.0, 0.25, 6);
+  sdc.setup();
+  sweeper->exact(sweeper->get_start_state(), 0.0);
+  sdc.run();
+
+  auto& end = pfasst::encap::as_vector<complex<double>, double>(sweeper->get_end_state());
+  return make_pair(end[0], sweeper->nreused);
+}
+
+TEST(QIntegralReuseTest, SweepsMatchWithoutReuse)
+{
+  // without tolerances, no residuals are computed and every sweep integrates on its own
+  auto plain = run_scalar_q_reuse(0.0);
+  EXPECT_EQ(plain.second, 0u);
+
+  // an unreachable tolerance computes the residuals after each iteration; the following sweep
+  // then starts from their integrals
+  auto reused = run_scalar_q_reuse(1e-100);
+  EXPECT_EQ(reused.second, 4u * 5u);
+  EXPECT_NEAR(abs(reused.first - plain.first), 0.0, 1e-14);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
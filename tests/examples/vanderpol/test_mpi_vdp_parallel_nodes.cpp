@@ -0,0 +1,75 @@
+/**
+ * Tests for the van der Pol oscillator with the nodes solved on several processes.
+ */
+#include <memory>
+using namespace std;
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+using namespace ::testing;
+
+#include <mpi.h>
+
+#include <pfasst.hpp>
+#include <pfasst/quadrature.hpp>
+#include <pfasst/controller/sdc.hpp>
+#include <pfasst/encap/parallel_nodes_sweeper.hpp>
+#include <pfasst/encap/vector.hpp>
+#include <pfasst/mpi_communicator.hpp>
+
+#include "../examples/vanderpol/vdp_sweeper.hpp"
+using namespace pfasst::examples::vdp;
+
+typedef VdpSweeper<double, pfasst::encap::ParallelNodesSweeper<double>> ParallelVdpSweeper;
+
+/*
+ * runs SDC for the linear oscillator with the nodes shared among the processes of @p node_comm
+ */
+static shared_ptr<ParallelVdpSweeper> run_parallel_vdp_sdc(pfasst::ICommunicator* node_comm)
+{
+  pfasst::SDC<> sdc;
+  auto quad = pfasst::quadrature::quadrature_factory(5,
+                                                     pfasst::quadrature::QuadratureType::GaussLegendre);
+  auto sweeper = make_shared<ParallelVdpSweeper>(0.0, 1.0, 0.5);
+  sweeper->set_quadrature(quad);
+  sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<double>>(2));
+  sweeper->set_node_comm(node_comm);
+  sdc.add_level(sweeper);
+  sdc.set_duration(0.0, 0.88, 0.88 / 7, 10);
+  sdc.setup();
+  sweeper->exact(sweeper->get_start_state(), 0.0);
+  sdc.run();
+  return sweeper;
+}
+
+/*
+ * Sharing the nodes among the processes gives the same solution on all of them, while each node is
+ * solved by a single process only.
+ */
+TEST(VdPParallelNodesTest, NodeCommunicatorMatchesSerialNodes)
+{
+  pfasst::mpi::MPICommunicator comm(MPI_COMM_WORLD);
+
+  auto serial = run_parallel_vdp_sdc(nullptr);
+  auto shared = run_parallel_vdp_sdc(&comm);
+
+  EXPECT_THAT(shared->get_errors(), DoubleEq(serial->get_errors()));
+
+  unsigned long num_solves = shared->get_num_impl_solves();
+  unsigned long total_solves = 0;
+  MPI_Allreduce(&num_solves, &total_solves, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+  EXPECT_THAT(total_solves, Eq(serial->get_num_impl_solves()));
+  EXPECT_THAT(shared->get_num_impl_solves(), Lt(serial->get_num_impl_solves()));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  MPI_Init(&argc, &argv);
+  pfasst::init(argc, argv);
+  int result, max_result;
+  result = RUN_ALL_TESTS();
+  MPI_Allreduce(&result, &max_result, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Finalize();
+  return max_result;
+}
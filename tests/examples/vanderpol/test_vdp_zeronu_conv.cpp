@@ -3,6 +3,7 @@
  * the linear oscillator and an analytical solution is available
  */
 #include <cmath>
+#include <functional>
 using namespace std;
 
 #include <gtest/gtest.h>
@@ -10,6 +11,7 @@ using namespace std;
 using namespace ::testing;
 
 #include <pfasst/quadrature.hpp>
+#include <pfasst/encap/parallel_nodes_sweeper.hpp>
 
 #define PFASST_UNIT_TESTING
 #include "../examples/vanderpol/vdp_sdc.cpp"
@@ -113,6 +115,346 @@ INSTANTIATE_TEST_CASE_P(VanDerPol, VdPConvergenceTest,
                                 Values(pfasst::quadrature::QuadratureType::GaussLegendre,
                                        pfasst::quadrature::QuadratureType::GaussRadau)));
 
+/*
+ * Solving all nodes concurrently converges to the same collocation solution.
+ */
+TEST(VdPParallelNodesTest, ConvergesToCollocationSolution)
+{
+  typedef VdpSweeper<double, pfasst::encap::ParallelNodesSweeper<double>> ParallelVdpSweeper;
+
+  for (auto nodetype : { pfasst::quadrature::QuadratureType::GaussLegendre,
+                         pfasst::quadrature::QuadratureType::GaussRadau }) {
+    const double err_serial = run_vdp_sdc(7, 0.88 / 7, 3, 40, 0.0, 1.0, 0.5, nodetype);
+    const double err_parallel = run_vdp_sdc<ParallelVdpSweeper>(7, 0.88 / 7, 3, 40, 0.0, 1.0,
+                                                                0.5, nodetype);
+    EXPECT_NEAR(err_parallel, err_serial, 1e-3 * err_serial);
+  }
+}
+
+/*
+ * Solving the nodes on several threads gives the same solution and counts every solve and Newton
+ * iteration (the threads only matter when built with OpenMP).
+ */
+TEST(VdPParallelNodesTest, ThreadedNodesMatchSerialNodes)
+{
+  typedef VdpSweeper<double, pfasst::encap::ParallelNodesSweeper<double>> ParallelVdpSweeper;
+
+  auto run = [](int num_threads) {
+    pfasst::SDC<> sdc;
+    auto quad = pfasst::quadrature::quadrature_factory(5,
+                                                       pfasst::quadrature::QuadratureType::GaussLegendre);
+    auto sweeper = make_shared<ParallelVdpSweeper>(0.0, 1.0, 0.5);
+    sweeper->set_quadrature(quad);
+    sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<double>>(2));
+    sweeper->set_num_node_threads(num_threads);
+    sdc.add_level(sweeper);
+    sdc.set_duration(0.0, 0.88, 0.88 / 7, 10);
+    sdc.setup();
+    sweeper->exact(sweeper->get_start_state(), 0.0);
+    sdc.run();
+    return sweeper;
+  };
+
+  auto serial = run(1);
+  auto threaded = run(4);
+
+  EXPECT_THAT(threaded->get_errors(), DoubleEq(serial->get_errors()));
+  EXPECT_THAT(threaded->get_num_impl_solves(), Eq(serial->get_num_impl_solves()));
+  EXPECT_THAT(threaded->get_num_newton_iterations(), Eq(serial->get_num_newton_iterations()));
+
+  auto const& stats = threaded->get_solver_statistics();
+  EXPECT_THAT(threaded->get_num_impl_solves(), Eq(stats.num_solves));
+  EXPECT_THAT(threaded->get_num_newton_iterations(), Eq(stats.num_iterations));
+}
+
+/*
+ * parallel van der Pol sweeper counting the calls of the batched evaluation
+ */
+class BatchedVdpSweeper
+  : public VdpSweeper<double, pfasst::encap::ParallelNodesSweeper<double>>
+{
+  public:
+    typedef pfasst::encap::Encapsulation<double> encap_type;
+
+    size_t n_eval_all = 0, n_evals = 0;
+
+    BatchedVdpSweeper()
+      : VdpSweeper<double, pfasst::encap::ParallelNodesSweeper<double>>(0.0, 1.0, 0.5)
+    {}
+
+    void f_impl_eval_all(const vector<shared_ptr<encap_type>>& f_encaps,
+                         const vector<shared_ptr<encap_type>>& u_encaps,
+                         const vector<double>& ts) override
+    {
+      this->n_eval_all++;
+      this->n_evals += u_encaps.size();
+      VdpSweeper<double, pfasst::encap::ParallelNodesSweeper<double>>::f_impl_eval_all(f_encaps,
+                                                                                     u_encaps, ts);
+    }
+};
+
+/*
+ * reevaluating all nodes of the parallel sweeper goes through a single call of the batched hook
+ */
+TEST(VdPParallelNodesTest, ReevaluateUsesBatchedHook)
+{
+  pfasst::SDC<> sdc;
+  auto sweeper = make_shared<BatchedVdpSweeper>();
+  sweeper->set_quadrature(pfasst::quadrature::quadrature_factory(5, pfasst::quadrature::QuadratureType::GaussLegendre));
+  sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<double>>(2));
+  sweeper->set_num_node_threads(4);
+  sdc.add_level(sweeper);
+  sdc.set_duration(0.0, 0.5, 0.5, 2);
+  sdc.setup();
+  sweeper->exact(sweeper->get_start_state(), 0.0);
+
+  sweeper->spread();
+  sweeper->reevaluate(false);
+  EXPECT_THAT(sweeper->n_eval_all, Eq(1u));
+  EXPECT_THAT(sweeper->n_evals, Eq(5u));
+}
+
+/*
+ * parallel van der Pol sweeper failing in its implicit solves and function evaluations
+ */
+class FailingVdpSweeper
+  : public VdpSweeper<double, pfasst::encap::ParallelNodesSweeper<double>>
+{
+  public:
+    typedef pfasst::encap::Encapsulation<double> encap_type;
+
+    FailingVdpSweeper()
+      : VdpSweeper<double, pfasst::encap::ParallelNodesSweeper<double>>(0.0, 1.0, 0.5)
+    {}
+
+    void f_impl_eval(shared_ptr<encap_type>, shared_ptr<encap_type>, double) override
+    {
+      throw pfasst::ValueError("f_impl_eval");
+    }
+
+    void impl_solve(shared_ptr<encap_type>, shared_ptr<encap_type>, double, double,
+                    shared_ptr<encap_type>) override
+    {
+      throw pfasst::ValueError("impl_solve");
+    }
+};
+
+/*
+ * exceptions thrown on the threads working on the nodes reach the caller
+ */
+TEST(VdPParallelNodesTest, ThreadedNodesRethrowExceptions)
+{
+  pfasst::SDC<> sdc;
+  auto sweeper = make_shared<FailingVdpSweeper>();
+  sweeper->set_quadrature(pfasst::quadrature::quadrature_factory(5, pfasst::quadrature::QuadratureType::GaussLegendre));
+  sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<double>>(2));
+  sweeper->set_num_node_threads(4);
+  sdc.add_level(sweeper);
+  sdc.set_duration(0.0, 0.5, 0.5, 2);
+  sdc.setup();
+  sweeper->exact(sweeper->get_start_state(), 0.0);
+
+  sweeper->spread();
+  EXPECT_THROW(sweeper->reevaluate(false), pfasst::ValueError);
+  EXPECT_THROW(sweeper->sweep(), pfasst::ValueError);
+}
+
+/*
+ * Coupling the Newton tolerances to the SDC residual does not change the collocation solution ...
+ */
+TEST(VdPInexactSolvesTest, ConvergesToCollocationSolution)
+{
+  auto policy = make_shared<pfasst::encap::InexactSolvePolicy<>>(1e-12);
+  auto const nodetype = pfasst::quadrature::QuadratureType::GaussLegendre;
+
+  const double err_exact = run_vdp_sdc(7, 0.88 / 7, 3, 40, 0.0, 1.0, 0.5, nodetype);
+  const double err_inexact = run_vdp_sdc(7, 0.88 / 7, 3, 40, 0.0, 1.0, 0.5, nodetype, policy);
+  EXPECT_NEAR(err_inexact, err_exact, 1e-3 * err_exact);
+}
+
+/*
+ * ... but saves Newton iterations in the early sweeps of the nonlinear oscillator.
+ */
+TEST(VdPInexactSolvesTest, SavesNewtonIterations)
+{
+  auto policy = make_shared<pfasst::encap::InexactSolvePolicy<>>(1e-12);
+  auto const nodetype = pfasst::quadrature::QuadratureType::GaussLegendre;
+  pfasst::encap::SolverStatistics<> exact, inexact;
+
+  run_vdp_sdc(20, 0.05, 3, 8, 5.0, 2.0, 0.0, nodetype, nullptr, &exact);
+  run_vdp_sdc(20, 0.05, 3, 8, 5.0, 2.0, 0.0, nodetype, policy, &inexact);
+
+  EXPECT_EQ(inexact.num_solves, exact.num_solves);
+  EXPECT_EQ(inexact.num_failures, 0u);
+  EXPECT_LT(inexact.num_iterations, exact.num_iterations);
+}
+
+/*
+ * Starting Newton from the previous iterate or an extrapolation instead of the right hand side
+ * saves iterations and converges to the same solution.
+ */
+TEST(VdPInitialGuessTest, WarmStartsSaveNewtonIterations)
+{
+  using pfasst::encap::InitialGuess;
+  auto const nodetype = pfasst::quadrature::QuadratureType::GaussLegendre;
+  pfasst::encap::SolverStatistics<> cold, warm, extrapolated;
+
+  const double err_cold = run_vdp_sdc(7, 0.88 / 7, 3, 40, 0.0, 1.0, 0.5, nodetype, nullptr, &cold,
+                                      InitialGuess::RHS);
+  const double err_warm = run_vdp_sdc(7, 0.88 / 7, 3, 40, 0.0, 1.0, 0.5, nodetype, nullptr, &warm,
+                                      InitialGuess::PreviousIterate);
+  const double err_extrapolated = run_vdp_sdc(7, 0.88 / 7, 3, 40, 0.0, 1.0, 0.5, nodetype, nullptr,
+                                              &extrapolated, InitialGuess::Extrapolation);
+
+  EXPECT_NEAR(err_warm, err_cold, 1e-3 * err_cold);
+  EXPECT_NEAR(err_extrapolated, err_cold, 1e-3 * err_cold);
+  EXPECT_LT(warm.num_iterations, cold.num_iterations);
+  EXPECT_LT(extrapolated.num_iterations, cold.num_iterations);
+}
+
+/*
+ * preconditioners of the implicit sweeper: with enough sweeps, all of them have to converge to the
+ * collocation solution
+ */
+static double run_vdp_q_delta(function<void(VdpSweeper<>&)> configure, const size_t niters)
+{
+  pfasst::SDC<> sdc;
+
+  auto sweeper = make_shared<VdpSweeper<>>(0.0, 1.0, 0.5);
+  sweeper->set_quadrature(pfasst::quadrature::quadrature_factory(3, pfasst::quadrature::QuadratureType::GaussLegendre));
+  sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<double>>(2));
+  configure(*sweeper);
+
+  sdc.add_level(sweeper);
+  sdc.set_duration(0.0, 0.5, 0.5, niters);
+  sdc.setup();
+  sweeper->exact(sweeper->get_start_state(), 0.0);
+  sdc.run();
+
+  return sweeper->get_errors();
+}
+
+TEST(VdPQDeltaTest, ImplicitConvergesWithAllPreconditioners)
+{
+  using pfasst::quadrature::QDeltaType;
+  const double collocation = run_vdp_q_delta([](VdpSweeper<>&) {}, 60);
+
+  for (auto type : { QDeltaType::LU, QDeltaType::MIN, QDeltaType::Trapezoidal,
+                     QDeltaType::ImplicitEuler }) {
+    double err = run_vdp_q_delta([type](VdpSweeper<>& s) { s.set_q_delta(type); }, 40);
+    EXPECT_NEAR(err, collocation, 1e-12) << "Q_delta type " << int(type);
+  }
+
+  // a custom matrix: the mean of backward Euler and the LU trick
+  auto quad = pfasst::quadrature::quadrature_factory<double>(3, pfasst::quadrature::QuadratureType::GaussLegendre);
+  Matrix<double> custom = 0.5 * (pfasst::quadrature::compute_q_delta(*quad, QDeltaType::ImplicitEuler)
+                                 + pfasst::quadrature::compute_q_delta(*quad, QDeltaType::LU));
+  double err = run_vdp_q_delta([&custom](VdpSweeper<>& s) { s.set_q_delta(custom); }, 40);
+  EXPECT_NEAR(err, collocation, 1e-12) << "custom Q_delta";
+}
+
+/*
+ * implicit sweeper switching its preconditioner after the first time step, i.e. after its
+ * matrices have been built
+ */
+class VdpSwitchingQDeltaSweeper
+  : public VdpSweeper<>
+{
+  public:
+    pfasst::quadrature::QDeltaType next;
+
+    explicit VdpSwitchingQDeltaSweeper(pfasst::quadrature::QDeltaType next)
+      : VdpSweeper<>(0.0, 1.0, 0.5), next(next)
+    {}
+
+    void post_step() override
+    {
+      VdpSweeper<>::post_step();
+      this->set_q_delta(this->next);
+    }
+};
+
+static double run_vdp_switching_q_delta(shared_ptr<VdpSweeper<>> sweeper, const size_t niters)
+{
+  pfasst::SDC<> sdc;
+
+  sweeper->set_quadrature(pfasst::quadrature::quadrature_factory(3, pfasst::quadrature::QuadratureType::GaussLegendre));
+  sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<double>>(2));
+
+  sdc.add_level(sweeper);
+  sdc.set_duration(0.0, 0.5, 0.25, niters);
+  sdc.setup();
+  sweeper->exact(sweeper->get_start_state(), 0.0);
+  sdc.run();
+
+  return sweeper->get_errors();
+}
+
+TEST(VdPQDeltaTest, ChangingPreconditionerAfterSetup)
+{
+  using pfasst::quadrature::QDeltaType;
+  const double collocation = run_vdp_switching_q_delta(make_shared<VdpSweeper<>>(0.0, 1.0, 0.5), 60);
+
+  for (auto type : { QDeltaType::ImplicitEuler, QDeltaType::Trapezoidal }) {
+    double err = run_vdp_switching_q_delta(make_shared<VdpSwitchingQDeltaSweeper>(type), 60);
+    EXPECT_NEAR(err, collocation, 1e-12) << "Q_delta type " << int(type);
+  }
+}
+
+/*
+ * implicit sweeper counting the sweeps starting from the integrals of the residual
+ */
+class VdpQIntegralSweeper
+  : public VdpSweeper<>
+{
+  public:
+    size_t nreused = 0;
+
+    VdpQIntegralSweeper()
+      : VdpSweeper<>(0.0, 1.0, 0.5)
+    {}
+
+    void sweep() override
+    {
+      if (this->has_q_integrals(this->get_controller()->get_step_size())) {
+        this->nreused++;
+      }
+      VdpSweeper<>::sweep();
+    }
+
+    void advance() override
+    {
+      VdpSweeper<>::advance();
+      EXPECT_FALSE(this->has_q_integrals(this->get_controller()->get_step_size()));
+    }
+};
+
+TEST(VdPQIntegralReuseTest, ImplicitSweepsMatchWithoutReuse)
+{
+  vector<double> end_x;
+  vector<size_t> nreused;
+  for (double abs_res_tol : { 0.0, 1e-100 }) {
+    pfasst::SDC<> sdc;
+    auto sweeper = make_shared<VdpQIntegralSweeper>();
+    sweeper->set_quadrature(pfasst::quadrature::quadrature_factory(3, pfasst::quadrature::QuadratureType::GaussLegendre));
+    sweeper->set_factory(make_shared<pfasst::encap::VectorFactory<double>>(2));
+    sweeper->set_residual_tolerances(abs_res_tol, 0.0);
+
+    sdc.add_level(sweeper);
+    sdc.set_duration(0.0, 1.0, 0.25, 6);
+    sdc.setup();
+    sweeper->exact(sweeper->get_start_state(), 0.0);
+    sdc.run();
+
+    end_x.push_back(pfasst::encap::as_vector<double, double>(sweeper->get_end_state())[0]);
+    nreused.push_back(sweeper->nreused);
+  }
+
+  EXPECT_EQ(nreused[0], 0u);
+  EXPECT_EQ(nreused[1], 4u * 5u);
+  EXPECT_NEAR(end_x[1], end_x[0], 1e-14);
+}
+
 int main(int argc, char** argv)
 {
   pfasst::init(argc, argv);
@@ -0,0 +1,134 @@
+/*
+ * Tests for the multigrid cycle schedules of MLSDC
+ */
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace ::testing;
+
+#include <pfasst/interfaces.hpp>
+#include <pfasst/controller/cycle_schedule.hpp>
+#include <pfasst/controller/mlsdc.hpp>
+
+using pfasst::CycleSchedule;
+using pfasst::CycleShape;
+
+
+// counts the predictions and sweeps of a level
+class CountingSweeper
+  : public pfasst::ISweeper<>
+{
+  public:
+    size_t nsweeps = 0;
+
+    void predict(bool) override { this->nsweeps++; }
+    void sweep() override { this->nsweeps++; }
+    void advance() override {}
+    void save(bool) override {}
+    void spread() override {}
+};
+
+class NullTransfer
+  : public pfasst::ITransfer<>
+{
+  public:
+    void interpolate_initial(shared_ptr<pfasst::ISweeper<>>,
+                             shared_ptr<const pfasst::ISweeper<>>) override {}
+    void interpolate(shared_ptr<pfasst::ISweeper<>>, shared_ptr<const pfasst::ISweeper<>>,
+                     bool) override {}
+    void restrict_initial(shared_ptr<pfasst::ISweeper<>>,
+                          shared_ptr<const pfasst::ISweeper<>>) override {}
+    void restrict(shared_ptr<pfasst::ISweeper<>>, shared_ptr<const pfasst::ISweeper<>>,
+                  bool) override {}
+    void fas(double, shared_ptr<pfasst::ISweeper<>>, shared_ptr<const pfasst::ISweeper<>>) override {}
+};
+
+// number of sweeps on each level (coarsest first) of one time step with three levels
+vector<size_t> count_sweeps(shared_ptr<CycleSchedule> schedule, size_t niters = 1)
+{
+  pfasst::MLSDC<> mlsdc;
+  vector<shared_ptr<CountingSweeper>> sweepers;
+  for (size_t l = 0; l < 3; l++) {
+    sweepers.push_back(make_shared<CountingSweeper>());
+    mlsdc.add_level(sweepers.back(), make_shared<NullTransfer>());
+  }
+  mlsdc.setup();
+  mlsdc.set_duration(0.0, 0.1, 0.1, niters);
+  mlsdc.set_cycle_schedule(schedule);
+  mlsdc.run();
+
+  // levels are added finest first
+  return { sweepers[2]->nsweeps, sweepers[1]->nsweeps, sweepers[0]->nsweeps };
+}
+
+
+TEST(CycleScheduleTest, ShapesSweepLevelsDifferently)
+{
+  // each count includes the final sweep on the finest level
+  EXPECT_THAT(count_sweeps(nullptr), ElementsAre(1, 2, 2));
+  EXPECT_THAT(count_sweeps(make_shared<CycleSchedule>(CycleShape::V)), ElementsAre(1, 2, 2));
+  EXPECT_THAT(count_sweeps(make_shared<CycleSchedule>(CycleShape::W)), ElementsAre(4, 4, 2));
+  EXPECT_THAT(count_sweeps(make_shared<CycleSchedule>(CycleShape::F)), ElementsAre(3, 4, 2));
+
+  // the full multigrid start-up predicts the coarsest level and does a V-cycle on the middle one
+  EXPECT_THAT(count_sweeps(make_shared<CycleSchedule>(CycleShape::V, true)), ElementsAre(3, 4, 2));
+  EXPECT_THAT(count_sweeps(make_shared<CycleSchedule>(CycleShape::F, true)), ElementsAre(5, 6, 2));
+}
+
+TEST(CycleScheduleTest, SweepsFollowIterationRanges)
+{
+  auto schedule = make_shared<CycleSchedule>();
+  schedule->set_nsweeps({2, 1, 1}, 1);
+
+  // the first iteration uses the counts of the controller
+  EXPECT_THAT(count_sweeps(schedule, 1), ElementsAre(1, 2, 2));
+  EXPECT_THAT(count_sweeps(schedule, 3), ElementsAre(1 + 2 * 2, 2 + 2 * 2, 2 + 2 * 1));
+}
+
+TEST(CycleScheduleTest, NumberOfSweeps)
+{
+  CycleSchedule schedule(CycleShape::W);
+  EXPECT_EQ(schedule.get_shape(), CycleShape::W);
+  EXPECT_FALSE(schedule.get_full_multigrid());
+
+  // without any counts the fallback is used
+  EXPECT_EQ(schedule.get_nsweeps(0, 2, 7u), 7u);
+  EXPECT_EQ(schedule.get_nsweeps(5, 0, 3u), 3u);
+
+  schedule.set_nsweeps({1, 2, 3}, 1);
+  schedule.set_nsweeps({4, 5}, 3);
+
+  // before the first range
+  EXPECT_EQ(schedule.get_nsweeps(0, 1, 9u), 9u);
+
+  // iterations 1 and 2
+  for (size_t iteration : {1, 2}) {
+    EXPECT_EQ(schedule.get_nsweeps(iteration, 0, 9u), 1u);
+    EXPECT_EQ(schedule.get_nsweeps(iteration, 1, 9u), 2u);
+    EXPECT_EQ(schedule.get_nsweeps(iteration, 2, 9u), 3u);
+  }
+
+  // from iteration 3 on
+  for (size_t iteration : {3, 4, 100}) {
+    EXPECT_EQ(schedule.get_nsweeps(iteration, 0, 9u), 4u);
+    EXPECT_EQ(schedule.get_nsweeps(iteration, 1, 9u), 5u);
+  }
+
+  // the counts of iteration 3 do not cover level 2
+  EXPECT_THROW(schedule.get_nsweeps(3, 2, 9u), pfasst::ValueError);
+  EXPECT_THROW(schedule.get_nsweeps(1, 3, 9u), pfasst::ValueError);
+
+  EXPECT_THROW(schedule.set_nsweeps({}), pfasst::ValueError);
+}
+
+
+int main(int argc, char** argv)
+{
+  InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,190 @@
+/*
+ * Tests for the matrix-free Newton-Krylov solver mixin
+ */
+
+#include <cmath>
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace ::testing;
+
+#include <Eigen/Dense>
+
+#include <pfasst/controller/interface.hpp>
+#include <pfasst/encap/implicit_sweeper.hpp>
+#include <pfasst/encap/krylov_solver.hpp>
+#include <pfasst/encap/vector.hpp>
+
+using pfasst::encap::Encapsulation;
+using pfasst::encap::ImplicitSweeper;
+using pfasst::encap::KrylovMethod;
+using pfasst::encap::KrylovSolverMixin;
+using pfasst::encap::VectorFactory;
+
+
+/*
+ * u' = u_xx - a(x) u - c u^3 with a variable reaction coefficient and homogeneous Dirichlet
+ * boundaries
+ */
+class DiffusionSweeper
+  : public KrylovSolverMixin<double, ImplicitSweeper<double>>
+{
+  public:
+    size_t ndofs;
+    double c;
+    bool jacobi;
+
+    DiffusionSweeper(size_t ndofs, double c)
+      : ndofs(ndofs), c(c), jacobi(false)
+    {
+      this->set_factory(make_shared<VectorFactory<double>>(ndofs));
+    }
+
+    double coeff(size_t i) const
+    {
+      return 1e4 * double(i) / double(ndofs);
+    }
+
+    double diag(size_t i) const
+    {
+      const double h = 1.0 / double(ndofs + 1);
+      return -2.0 / (h * h) - this->coeff(i);
+    }
+
+    void f_impl_eval(shared_ptr<Encapsulation<double>> f_encap,
+                     shared_ptr<Encapsulation<double>> u_encap, double t) override
+    {
+      UNUSED(t);
+      auto& f = pfasst::encap::as_vector<double, double>(f_encap);
+      auto& u = pfasst::encap::as_vector<double, double>(u_encap);
+      const double h = 1.0 / double(ndofs + 1);
+      for (size_t i = 0; i < ndofs; i++) {
+        const double left = (i > 0) ? u[i - 1] : 0.0;
+        const double right = (i + 1 < ndofs) ? u[i + 1] : 0.0;
+        f[i] = (left - 2.0 * u[i] + right) / (h * h) - this->coeff(i) * u[i] - this->c * u[i] * u[i] * u[i];
+      }
+    }
+
+    void precondition(shared_ptr<Encapsulation<double>> dst,
+                      shared_ptr<Encapsulation<double>> src,
+                      shared_ptr<Encapsulation<double>> u, double t, double dt) override
+    {
+      if (!this->jacobi) {
+        KrylovSolverMixin<double, ImplicitSweeper<double>>::precondition(dst, src, u, t, dt);
+        return;
+      }
+      auto& d = pfasst::encap::as_vector<double, double>(dst);
+      auto& s = pfasst::encap::as_vector<double, double>(src);
+      for (size_t i = 0; i < ndofs; i++) {
+        d[i] = s[i] / (1.0 - dt * this->diag(i));
+      }
+    }
+
+    Eigen::MatrixXd system(double dt) const
+    {
+      Eigen::MatrixXd m = Eigen::MatrixXd::Identity(ndofs, ndofs);
+      const double h = 1.0 / double(ndofs + 1);
+      for (size_t i = 0; i < ndofs; i++) {
+        m(i, i) -= dt * this->diag(i);
+        if (i > 0) { m(i, i - 1) = -dt / (h * h); }
+        if (i + 1 < ndofs) { m(i, i + 1) = -dt / (h * h); }
+      }
+      return m;
+    }
+
+    // solves the implicit system for a smooth right hand side and returns the result
+    shared_ptr<Encapsulation<double>> solve(double dt)
+    {
+      auto factory = this->get_factory();
+      auto u = factory->create(pfasst::encap::solution);
+      auto f = factory->create(pfasst::encap::function);
+      auto rhs = factory->create(pfasst::encap::solution);
+      auto& r = pfasst::encap::as_vector<double, double>(rhs);
+      for (size_t i = 0; i < ndofs; i++) {
+        r[i] = sin(M_PI * double(i + 1) / double(ndofs + 1));
+      }
+      this->impl_solve(f, u, 0.0, dt, rhs);
+      return u;
+    }
+};
+
+
+class KrylovSolverTest
+  : public TestWithParam<KrylovMethod>
+{};
+
+TEST_P(KrylovSolverTest, LinearSystemMatchesDirectSolve)
+{
+  const size_t ndofs = 64;
+  const double dt = 1e-3;
+  DiffusionSweeper sweeper(ndofs, 0.0);
+  sweeper.set_krylov_method(GetParam());
+  sweeper.set_krylov_tolerance(1e-10, 500);
+
+  auto u = sweeper.solve(dt);
+
+  Eigen::VectorXd rhs(ndofs);
+  for (size_t i = 0; i < ndofs; i++) {
+    rhs[i] = sin(M_PI * double(i + 1) / double(ndofs + 1));
+  }
+  Eigen::VectorXd ref = sweeper.system(dt).lu().solve(rhs);
+
+  auto& v = pfasst::encap::as_vector<double, double>(u);
+  for (size_t i = 0; i < ndofs; i++) {
+    EXPECT_NEAR(ref[i], v[i], 1e-10) << "i=" << i;
+  }
+  EXPECT_EQ(sweeper.get_solver_statistics().num_solves, 1u);
+  EXPECT_EQ(sweeper.get_solver_statistics().num_failures, 0u);
+}
+
+TEST_P(KrylovSolverTest, NonlinearSystemConverges)
+{
+  const size_t ndofs = 32;
+  const double dt = 1e-3;
+  DiffusionSweeper sweeper(ndofs, 10.0);
+  sweeper.set_krylov_method(GetParam());
+  sweeper.set_newton_tolerance(1e-11, 20);
+
+  auto u = sweeper.solve(dt);
+  auto f = sweeper.get_factory()->create(pfasst::encap::function);
+  sweeper.f_impl_eval(f, u, dt);
+
+  auto& v = pfasst::encap::as_vector<double, double>(u);
+  auto& fv = pfasst::encap::as_vector<double, double>(f);
+  for (size_t i = 0; i < ndofs; i++) {
+    const double rhs = sin(M_PI * double(i + 1) / double(ndofs + 1));
+    EXPECT_NEAR(v[i] - dt * fv[i], rhs, 1e-10) << "i=" << i;
+  }
+  EXPECT_EQ(sweeper.get_solver_statistics().num_failures, 0u);
+}
+
+TEST_P(KrylovSolverTest, PreconditionerSavesIterations)
+{
+  const size_t ndofs = 64;
+  const double dt = 1e-2;
+  size_t iterations[2];
+  for (bool jacobi : { false, true }) {
+    DiffusionSweeper sweeper(ndofs, 0.0);
+    sweeper.jacobi = jacobi;
+    sweeper.set_krylov_method(GetParam());
+    sweeper.set_krylov_tolerance(1e-10, 1000);
+    sweeper.solve(dt);
+    EXPECT_EQ(sweeper.get_solver_statistics().num_failures, 0u);
+    iterations[jacobi] = sweeper.get_solver_statistics().num_iterations;
+  }
+  EXPECT_THAT(iterations[1], Lt(iterations[0]));
+}
+
+INSTANTIATE_TEST_CASE_P(KrylovMethods, KrylovSolverTest,
+                        Values(KrylovMethod::GMRES, KrylovMethod::CG));
+
+
+int main(int argc, char** argv)
+{
+  InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
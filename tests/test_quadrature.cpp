@@ -312,6 +312,87 @@ INSTANTIATE_TEST_CASE_P(Quadrature, QmatTest,
                                                          QuadratureType::Uniform)));
 
 
+class QDeltaTest
+  : public ::TestWithParam<tuple<size_t, QuadratureType>>
+{
+  protected:
+    shared_ptr<IQuadrature<double>> quad;
+    size_t first;
+    size_t nfree;
+
+  public:
+    virtual void SetUp()
+    {
+      this->quad = quadrature_factory<double>(get<0>(GetParam()), get<1>(GetParam()));
+      this->first = this->quad->left_is_node() ? 1 : 0;
+      this->nfree = this->quad->get_num_nodes() - this->first;
+    }
+};
+
+TEST_P(QDeltaTest, EulerSteps)
+{
+  auto const& nodes = this->quad->get_nodes();
+  auto ie = compute_q_delta(*(this->quad), QDeltaType::ImplicitEuler);
+  auto ee = compute_q_delta(*(this->quad), QDeltaType::ExplicitEuler);
+
+  EXPECT_TRUE(ie.isLowerTriangular());
+  EXPECT_TRUE(ee.isLowerTriangular());
+  EXPECT_TRUE(ee.diagonal().isZero());
+  for (size_t m = 0; m < nodes.size(); ++m) {
+    EXPECT_NEAR(ie.row(m).sum(), nodes[m], 1e-14);
+    EXPECT_NEAR(ee.row(m).sum(), nodes[m] - nodes[0], 1e-14);
+  }
+}
+
+TEST_P(QDeltaTest, MINIsDiagonal)
+{
+  auto min = compute_q_delta(*(this->quad), QDeltaType::MIN);
+  Matrix<double> diag = min.diagonal().asDiagonal();
+  EXPECT_EQ(min, diag);
+  for (size_t m = first; m < this->quad->get_num_nodes(); ++m) {
+    EXPECT_NEAR(min(m, m), this->quad->get_nodes()[m] / this->nfree, 1e-14);
+  }
+}
+
+TEST_P(QDeltaTest, LUTrickIsNilpotentInStiffLimit)
+{
+  // the LU trick annihilates the stiff limit of the iteration matrix after nfree sweeps
+  auto lu = compute_q_delta(*(this->quad), QDeltaType::LU);
+  EXPECT_TRUE(lu.isLowerTriangular());
+
+  Matrix<double> q = this->quad->get_q_mat().block(first, first, nfree, nfree);
+  Matrix<double> qd = lu.block(first, first, nfree, nfree);
+  Matrix<double> k = Matrix<double>::Identity(nfree, nfree) - qd.inverse() * q;
+  Matrix<double> kn = Matrix<double>::Identity(nfree, nfree);
+  for (size_t i = 0; i < nfree; ++i) {
+    kn = kn * k;
+  }
+  EXPECT_LT(kn.cwiseAbs().maxCoeff(), 1e-8);
+}
+
+TEST_P(QDeltaTest, EulerLUCombinesEulerAndLUTrick)
+{
+  // node to node: backward Euler on the diagonal, the LU trick below
+  auto const& nodes = this->quad->get_nodes();
+  auto lu = compute_q_delta(*(this->quad), QDeltaType::LU);
+  auto s = compute_s_matrix(compute_q_delta(*(this->quad), QDeltaType::EulerLU));
+
+  EXPECT_TRUE(s.isLowerTriangular());
+  for (size_t m = first; m < nodes.size(); ++m) {
+    EXPECT_NEAR(s(m, m), (m == 0) ? nodes[0] : nodes[m] - nodes[m - 1], 1e-14);
+    for (size_t n = first; n < m; ++n) {
+      EXPECT_NEAR(s(m, n), lu(m, n), 1e-14);
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(Quadrature, QDeltaTest,
+                        ::Combine(::Range<size_t>(3, 8),
+                                  Values<QuadratureType>(QuadratureType::GaussLegendre,
+                                                         QuadratureType::GaussLobatto,
+                                                         QuadratureType::GaussRadau)));
+
+
 typedef ::testing::Types<GaussLegendre<>,
                          GaussLobatto<>,
                          GaussRadau<>,
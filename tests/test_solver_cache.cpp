@@ -0,0 +1,177 @@
+/*
+ * Tests for the cache of factorized implicit systems
+ */
+
+#include <complex>
+#include <functional>
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace ::testing;
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <pfasst/encap/encapsulation.hpp>
+#include <pfasst/encap/solver_cache.hpp>
+
+using pfasst::encap::DenseLU;
+using pfasst::encap::SolverCache;
+
+
+// 1D Laplacian with homogeneous Dirichlet boundaries
+Eigen::SparseMatrix<double> laplacian(size_t n)
+{
+  vector<Eigen::Triplet<double>> entries;
+  const double h2 = double((n + 1) * (n + 1));
+  for (size_t i = 0; i < n; i++) {
+    entries.push_back(Eigen::Triplet<double>(i, i, -2.0 * h2));
+    if (i > 0) { entries.push_back(Eigen::Triplet<double>(i, i - 1, h2)); }
+    if (i + 1 < n) { entries.push_back(Eigen::Triplet<double>(i, i + 1, h2)); }
+  }
+  Eigen::SparseMatrix<double> a(n, n);
+  a.setFromTriplets(entries.begin(), entries.end());
+  return a;
+}
+
+
+TEST(SolverCacheTest, FactorizesOncePerSubstep)
+{
+  const size_t n = 16;
+  Eigen::MatrixXd a = Eigen::MatrixXd(laplacian(n));
+  auto cache = pfasst::encap::make_dense_lu_cache<double, double>(a);
+  const vector<double> substeps = { 0.01, 0.03, 0.06 };
+
+  for (size_t sweep = 0; sweep < 3; sweep++) {
+    for (double ds : substeps) {
+      auto lu = cache.get(0.1, ds);
+      Eigen::VectorXd b = Eigen::VectorXd::LinSpaced(n, 0.0, 1.0);
+      Eigen::VectorXd x = lu->solve(b);
+      Eigen::VectorXd residual = x - ds * a * x - b;
+      EXPECT_THAT(residual.lpNorm<Eigen::Infinity>(), Lt(1e-12)) << "ds=" << ds;
+    }
+  }
+  EXPECT_EQ(cache.size(), substeps.size());
+  EXPECT_EQ(cache.get_num_factorizations(), substeps.size());
+
+  // a new step size drops the old factorizations
+  cache.get(0.2, 0.02);
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_EQ(cache.get_num_factorizations(), substeps.size() + 1);
+}
+
+TEST(SolverCacheTest, SparseFactorizationsMatchDense)
+{
+  const size_t n = 32;
+  const double ds = 0.005;
+  auto a = laplacian(n);
+  Eigen::VectorXd b = Eigen::VectorXd::LinSpaced(n, -1.0, 1.0);
+
+  auto dense = pfasst::encap::make_dense_lu_cache<double, double>(Eigen::MatrixXd(a));
+  auto lu = pfasst::encap::make_sparse_lu_cache<double, double>(a);
+  auto ldlt = pfasst::encap::make_sparse_ldlt_cache<double, double>(a);
+
+  Eigen::VectorXd ref = dense.get(0.1, ds)->solve(b);
+  Eigen::VectorXd x_lu = lu.get(0.1, ds)->solve(b);
+  Eigen::VectorXd x_ldlt = ldlt.get(0.1, ds)->solve(b);
+  for (size_t i = 0; i < n; i++) {
+    EXPECT_NEAR(ref[i], x_lu[i], 1e-12) << "i=" << i;
+    EXPECT_NEAR(ref[i], x_ldlt[i], 1e-12) << "i=" << i;
+  }
+}
+
+TEST(SolverCacheTest, SpectralSymbol)
+{
+  const vector<complex<double>> eigenvalues = { 0.0, -1.0, complex<double>(-4.0, 2.0) };
+  auto cache = pfasst::encap::make_symbol_cache<complex<double>, double>(eigenvalues, 0.5);
+
+  auto symbol = cache.get(1.0, 0.25);
+  ASSERT_EQ(symbol->size(), eigenvalues.size());
+  for (size_t k = 0; k < eigenvalues.size(); k++) {
+    EXPECT_NEAR(abs((*symbol)[k] * (1.0 - 0.25 * eigenvalues[k]) - 0.5), 0.0, 1e-15) << "k=" << k;
+  }
+  EXPECT_EQ(cache.get(1.0, 0.25), symbol);
+}
+
+TEST(SolverCacheTest, SubstepsDifferingByRoundingShareEntry)
+{
+  auto cache = pfasst::encap::make_dense_lu_cache<double, double>(Eigen::MatrixXd(laplacian(8)));
+  const double dt = 0.01;
+  const vector<double> nodes = { 0.1127016653792583, 0.5, 0.8872983346207417 };
+
+  // the same sub-step (the nodes are symmetric) as scaled difference of nodes and as difference
+  // of scaled nodes, which round differently
+  for (size_t m = 1; m < nodes.size(); m++) {
+    auto lu = cache.get(dt, dt * (nodes[m] - nodes[m - 1]));
+    EXPECT_EQ(cache.get(dt, dt * nodes[m] - dt * nodes[m - 1]), lu);
+  }
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_EQ(cache.get_num_factorizations(), 1u);
+
+  // clearly different sub-steps do not
+  cache.get(dt, 1.001 * dt * (nodes[1] - nodes[0]));
+  EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST(SolverCacheTest, DoesNotCacheFactorizationsOfDroppedEntries)
+{
+  typedef SolverCache<DenseLU<double>, double> CacheT;
+  shared_ptr<CacheT> cache;
+  function<void()> interleave;
+  cache = make_shared<CacheT>([&interleave](double ds) {
+    if (interleave) { interleave(); }
+    Eigen::MatrixXd system = Eigen::MatrixXd::Identity(2, 2) * (1.0 + ds);
+    return make_shared<DenseLU<double>>(system);
+  });
+
+  // the cache is cleared while the factorization is computed
+  interleave = [&cache]() { cache->clear(); };
+  auto lu = cache->get(0.1, 0.05);
+  EXPECT_TRUE(bool(lu));
+  EXPECT_EQ(cache->size(), 0u);
+  EXPECT_EQ(cache->get_num_factorizations(), 0u);
+
+  // another thread switches to a new step size while the factorization is computed
+  bool switched = false;
+  interleave = [&cache, &switched]() {
+    if (!switched) {
+      switched = true;
+      cache->get(0.2, 0.05);
+    }
+  };
+  cache->get(0.1, 0.05);
+  EXPECT_EQ(cache->size(), 1u);
+  EXPECT_EQ(cache->get_num_factorizations(), 1u);
+
+  // the entry belongs to the new step size only
+  auto fresh = cache->get(0.2, 0.05);
+  EXPECT_EQ(cache->get(0.2, 0.05), fresh);
+  EXPECT_EQ(cache->get_num_factorizations(), 1u);
+}
+
+TEST(SolverCacheTest, PassesOnFactorizationErrors)
+{
+  SolverCache<DenseLU<double>, double> cache([](double) -> shared_ptr<DenseLU<double>> {
+    throw pfasst::ValueError("factorization failed");
+  });
+  EXPECT_THROW(cache.get(0.1, 0.1), pfasst::ValueError);
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_EQ(cache.get_num_factorizations(), 0u);
+}
+
+TEST(SolverCacheTest, ThrowsWithoutFactorization)
+{
+  SolverCache<DenseLU<double>, double> cache;
+  EXPECT_THROW(cache.get(0.1, 0.1), pfasst::ValueError);
+}
+
+
+int main(int argc, char** argv)
+{
+  InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,494 @@
+/*
+ * Tests for VectorEncapsulation
+ */
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <memory>
+#include <typeinfo>
+#include <vector>
+using namespace std;
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace ::testing;
+
+#include <pfasst/encap/eigen_vector.hpp>
+#include <pfasst/encap/pooled_factory.hpp>
+#include <pfasst/encap/vector.hpp>
+
+using pfasst::encap::EigenFactory;
+using pfasst::encap::EigenVectorEncapsulation;
+using pfasst::encap::Encapsulation;
+using pfasst::encap::PooledEncapFactory;
+using pfasst::encap::VectorEncapsulation;
+using pfasst::encap::VectorFactory;
+
+
+template<typename scalar>
+class MatApplyTest
+  : public ::testing::Test
+{
+  protected:
+    typedef VectorEncapsulation<scalar, double> VectorT;
+
+    vector<shared_ptr<Encapsulation<double>>> make_vectors(size_t num, size_t ndofs, double shift)
+    {
+      VectorFactory<scalar, double> factory(ndofs);
+      vector<shared_ptr<Encapsulation<double>>> vectors;
+      for (size_t m = 0; m < num; m++) {
+        vectors.push_back(factory.create(pfasst::encap::solution));
+        auto& v = pfasst::encap::as_vector<scalar, double>(vectors.back());
+        for (size_t i = 0; i < ndofs; i++) {
+          v[i] = scalar(shift + 0.25 * m - 0.125 * (i % 13));
+        }
+      }
+      return vectors;
+    }
+
+    // (ndst x nsrc) shapes of Q, S, B and FAS matrices for 3 and 5 nodes plus a generic one
+    void check(size_t ndst, size_t nsrc, size_t ndofs, bool zero)
+    {
+      Matrix<double> mat(ndst, nsrc);
+      for (size_t n = 0; n < ndst; n++) {
+        for (size_t m = 0; m < nsrc; m++) {
+          mat(n, m) = (n + m) % 3 == 0 ? 0.0 : 0.1 * (n + 1) - 0.05 * m;
+        }
+      }
+
+      auto src = this->make_vectors(nsrc, ndofs, 1.0);
+      auto dst = this->make_vectors(ndst, ndofs, -2.0);
+      auto ref = this->make_vectors(ndst, ndofs, -2.0);
+
+      dst[0]->mat_apply(dst, 0.5, mat, src, zero);
+
+      for (size_t n = 0; n < ndst; n++) {
+        auto& r = pfasst::encap::as_vector<scalar, double>(ref[n]);
+        auto& d = pfasst::encap::as_vector<scalar, double>(dst[n]);
+        for (size_t i = 0; i < ndofs; i++) {
+          scalar expected = zero ? scalar(0.0) : r[i];
+          for (size_t m = 0; m < nsrc; m++) {
+            expected += 0.5 * mat(n, m) * pfasst::encap::as_vector<scalar, double>(src[m])[i];
+          }
+          EXPECT_EQ(expected, d[i]) << "(" << ndst << "x" << nsrc << ") n=" << n << " i=" << i;
+        }
+      }
+    }
+};
+
+typedef ::testing::Types<double, complex<double>> ScalarTypes;
+TYPED_TEST_CASE(MatApplyTest, ScalarTypes);
+
+TYPED_TEST(MatApplyTest, MatchesTripleLoop)
+{
+  for (bool zero : {true, false}) {
+    for (size_t ndofs : {1, 7, 128, 300}) {
+      this->check(3, 3, ndofs, zero);
+      this->check(2, 3, ndofs, zero);
+      this->check(1, 5, ndofs, zero);
+      this->check(3, 6, ndofs, zero);
+      this->check(5, 23, ndofs, zero);
+      this->check(20, 20, ndofs, zero);
+    }
+  }
+}
+
+TYPED_TEST(MatApplyTest, LincombMatchesCopyAndSaxpy)
+{
+  typedef typename TestFixture::VectorT VectorT;
+  for (size_t nsrc : {1, 3, 20}) {
+    for (size_t ndofs : {1, 7, 300}) {
+      auto src = this->make_vectors(nsrc, ndofs, 1.0);
+      auto dst = this->make_vectors(2, ndofs, -2.0);
+      auto ref = this->make_vectors(2, ndofs, -2.0);
+      vector<double> a(nsrc);
+      for (size_t m = 0; m < nsrc; m++) { a[m] = m == 0 ? 1.0 : 0.3 - 0.1 * m; }
+
+      ref[0]->copy(src[0]);
+      for (size_t m = 1; m < nsrc; m++) { ref[0]->saxpy(a[m], src[m]); }
+      dst[0]->lincomb(a, src);
+
+      for (size_t m = 0; m < nsrc; m++) { ref[1]->saxpy(a[m], src[m]); }
+      dst[1]->lincomb(a, src, false);
+
+      for (size_t n = 0; n < 2; n++) {
+        const VectorT& r = pfasst::encap::as_vector<TypeParam, double>(ref[n]);
+        const VectorT& d = pfasst::encap::as_vector<TypeParam, double>(dst[n]);
+        EXPECT_THAT(d, Eq(r)) << "nsrc=" << nsrc << " ndofs=" << ndofs << " n=" << n;
+      }
+
+      // destination aliasing a source
+      ref[0]->copy(src[0]);
+      ref[0]->saxpy(2.0, src[0]);
+      src[0]->lincomb({ 1.0, 2.0 }, { src[0], src[0] });
+      const VectorT& r = pfasst::encap::as_vector<TypeParam, double>(ref[0]);
+      const VectorT& s = pfasst::encap::as_vector<TypeParam, double>(src[0]);
+      EXPECT_THAT(s, Eq(r));
+    }
+  }
+}
+
+TYPED_TEST(MatApplyTest, Norms)
+{
+  typedef typename TestFixture::VectorT VectorT;
+  using pfasst::encap::NormType;
+
+  auto x = this->make_vectors(3, 37, -1.0);
+  for (size_t m = 0; m < x.size(); m++) {
+    const VectorT& v = pfasst::encap::as_vector<TypeParam, double>(x[m]);
+    double max = 0.0, l1 = 0.0, l2 = 0.0;
+    for (auto& value : v) {
+      max = std::max(max, std::abs(value));
+      l1 += std::abs(value);
+      l2 += std::norm(value);
+    }
+
+    EXPECT_EQ(max, x[m]->norm0());
+    EXPECT_EQ(max, x[m]->norm(pfasst::encap::max_norm));
+    EXPECT_NEAR(l1, x[m]->norm(pfasst::encap::l1_norm), 1e-12);
+    EXPECT_NEAR(sqrt(l2), x[m]->norm(pfasst::encap::l2_norm), 1e-12);
+    EXPECT_NEAR(sqrt(l2 / 37), x[m]->norm(pfasst::encap::rms_norm), 1e-12);
+
+    for (NormType type : { pfasst::encap::max_norm, pfasst::encap::l1_norm,
+                           pfasst::encap::l2_norm, pfasst::encap::rms_norm }) {
+      EXPECT_EQ(x[m]->norm(type), x[0]->norms(x, type)[m]);
+    }
+
+    const VectorT& w = pfasst::encap::as_vector<TypeParam, double>(x[(m + 1) % x.size()]);
+    double dot = 0.0;
+    for (size_t i = 0; i < v.size(); i++) {
+      dot += std::real(std::conj(v[i]) * w[i]);
+    }
+    EXPECT_NEAR(dot, x[m]->dot(x[(m + 1) % x.size()]), 1e-12);
+    EXPECT_NEAR(l2, x[m]->dot(x[m]), 1e-12);
+  }
+
+  // a NaN propagates to all norms wherever it is
+  for (size_t i : { 0, 5, 36 }) {
+    auto y = this->make_vectors(1, 37, 1.0)[0];
+    pfasst::encap::as_vector<TypeParam, double>(y)[i] = numeric_limits<double>::quiet_NaN();
+    for (NormType type : { pfasst::encap::max_norm, pfasst::encap::l1_norm,
+                           pfasst::encap::l2_norm, pfasst::encap::rms_norm }) {
+      EXPECT_TRUE(std::isnan(y->norm(type))) << "type " << type << " i=" << i;
+    }
+  }
+}
+
+TYPED_TEST(MatApplyTest, ChunkedKernelsMatchSerial)
+{
+  // force splitting into chunks of whole tiles, with and without threading support
+  size_t& threshold = pfasst::encap::parallel::min_parallel_size();
+  size_t& fixed_chunks = pfasst::encap::parallel::fixed_num_chunks();
+  const size_t saved = threshold;
+  threshold = 1;
+  fixed_chunks = 4;
+  ASSERT_EQ(pfasst::encap::parallel::num_chunks(1000), 4u);
+  ASSERT_EQ(pfasst::encap::parallel::num_chunks(777), 4u);
+
+  for (bool zero : {true, false}) {
+    this->check(3, 5, 1000, zero);
+    this->check(20, 20, 777, zero);
+  }
+
+  auto x = this->make_vectors(2, 1000, -1.0);
+  x[0]->saxpy(0.5, x[1]);
+  for (auto type : { pfasst::encap::max_norm, pfasst::encap::l1_norm, pfasst::encap::l2_norm }) {
+    threshold = 1;
+    const double chunked = x[0]->norm(type);
+    threshold = saved;
+    EXPECT_NEAR(x[0]->norm(type), chunked, 1e-12 * chunked) << "type=" << type;
+  }
+
+  threshold = saved;
+  fixed_chunks = 0;
+}
+
+
+TEST(EncapCastTest, ChecksTheTypeInAllBuilds)
+{
+  typedef VectorEncapsulation<double, double> VectorT;
+  typedef EigenVectorEncapsulation<double, double> EigenT;
+  VectorT v(4);
+  EigenT e(4);
+  Encapsulation<double>& v_base = v;
+  Encapsulation<double>& e_base = e;
+
+  EXPECT_EQ(&pfasst::encap::encap_cast<VectorT>(v_base), &v);
+  EXPECT_THROW(pfasst::encap::encap_cast<VectorT>(e_base), std::bad_cast);
+
+  const Encapsulation<double>& ce_base = e;
+  EXPECT_EQ(&pfasst::encap::encap_cast<EigenT>(ce_base), &e);
+  EXPECT_THROW(pfasst::encap::encap_cast<EigenT>(v_base), std::bad_cast);
+
+  // derived types go through dynamic_cast
+  struct DerivedVector : public VectorT
+  {
+    DerivedVector() : VectorT(4) {}
+  } d;
+  Encapsulation<double>& d_base = d;
+  EXPECT_EQ(&pfasst::encap::encap_cast<VectorT>(d_base), static_cast<VectorT*>(&d));
+}
+
+
+TEST(FamilyTest, CreatesIndependentStdVectors)
+{
+  VectorFactory<double, double> factory(13);
+  auto nodes = factory.create_block(pfasst::encap::solution, 4);
+  ASSERT_EQ(nodes.size(), 4u);
+
+  for (size_t m = 0; m < nodes.size(); m++) {
+    // the values are a plain std::vector
+    vector<double>& v = pfasst::encap::as_vector<double, double>(nodes[m]);
+    EXPECT_EQ(v.size(), 13u);
+    EXPECT_THAT(v, Each(0.0));
+    v[2] = double(m);
+  }
+  for (size_t m = 0; m < nodes.size(); m++) {
+    auto& v = pfasst::encap::as_vector<double, double>(nodes[m]);
+    EXPECT_EQ(v[2], double(m));
+  }
+}
+
+TEST(SwapTest, StandaloneVectorsExchangeBuffers)
+{
+  typedef VectorEncapsulation<double, double> VectorT;
+  auto a = make_shared<VectorT>(8);
+  auto b = make_shared<VectorT>(8);
+  a->assign(8, 1.0);
+  b->assign(8, 2.0);
+  const double* a_data = a->data();
+  const double* b_data = b->data();
+
+  a->swap(shared_ptr<Encapsulation<double>>(b));
+  EXPECT_EQ(a->data(), b_data);
+  EXPECT_EQ(b->data(), a_data);
+  EXPECT_THAT(*a, Each(2.0));
+  EXPECT_THAT(*b, Each(1.0));
+
+  a->move_from(b);
+  EXPECT_EQ(a->data(), a_data);
+  EXPECT_THAT(*a, Each(1.0));
+
+  VectorT moved(std::move(*a));
+  EXPECT_EQ(moved.data(), a_data);
+  EXPECT_TRUE(a->empty());
+}
+
+TEST(SwapTest, FamilyMembersExchangeBuffers)
+{
+  VectorFactory<double, double> factory(8);
+  auto nodes = factory.create_block(pfasst::encap::solution, 2);
+  auto& a = pfasst::encap::as_vector<double, double>(nodes[0]);
+  auto& b = pfasst::encap::as_vector<double, double>(nodes[1]);
+  a.assign(8, 1.0);
+  b.assign(8, 2.0);
+  const double* b_data = b.data();
+
+  nodes[0]->swap(nodes[1]);
+  EXPECT_EQ(a.data(), b_data);
+  EXPECT_THAT(a, Each(2.0));
+  EXPECT_THAT(b, Each(1.0));
+
+  auto standalone = factory.create(pfasst::encap::solution);
+  nodes[0]->move_from(standalone);
+  EXPECT_THAT(a, Each(0.0));
+}
+
+TEST(MixedPrecisionTest, SinglePrecisionValuesWithDoubleTime)
+{
+  typedef VectorEncapsulation<float, double> VectorT;
+  auto values = [](shared_ptr<Encapsulation<double>> x) -> VectorT& {
+    return pfasst::encap::as_vector<float, double>(x);
+  };
+  VectorFactory<float, double> factory(37);
+  auto nodes = factory.create_block(pfasst::encap::solution, 3);
+  for (size_t m = 0; m < nodes.size(); m++) {
+    values(nodes[m]).assign(37, float(m + 1));
+  }
+
+  Matrix<double> mat(3, 3);
+  mat << 1.0, 0.0, 0.0,
+         0.5, 0.5, 0.0,
+         0.0, 0.0, 2.0;
+  auto dst = factory.create_block(pfasst::encap::solution, 3);
+  dst[0]->mat_apply(dst, 0.5, mat, nodes, true);
+  EXPECT_THAT(values(dst[0]), Each(0.5f));
+  EXPECT_THAT(values(dst[1]), Each(0.75f));
+  EXPECT_THAT(values(dst[2]), Each(3.0f));
+
+  auto tmp = factory.create(pfasst::encap::solution);
+  tmp->lincomb({ 1.0, -0.5 }, { nodes[2], nodes[1] });
+  EXPECT_THAT(values(tmp), Each(2.0f));
+  EXPECT_DOUBLE_EQ(tmp->norm(pfasst::encap::l1_norm), 74.0);
+}
+
+TEST(PooledFactoryTest, RecyclesReleasedEncapsulations)
+{
+  PooledEncapFactory<double> factory(make_shared<VectorFactory<double, double>>(8));
+
+  const double* data;
+  {
+    auto a = factory.create(pfasst::encap::solution);
+    auto b = factory.create(pfasst::encap::solution);
+    auto& a_vec = pfasst::encap::as_vector<double, double>(a);
+    a_vec.assign(8, 3.0);
+    data = a_vec.data();
+
+    auto stats = factory.get_statistics();
+    EXPECT_EQ(stats.live, 2u);
+    EXPECT_EQ(stats.peak, 2u);
+    EXPECT_EQ(stats.idle, 0u);
+    EXPECT_EQ(stats.allocated, 2u);
+  }
+
+  auto stats = factory.get_statistics();
+  EXPECT_EQ(stats.live, 0u);
+  EXPECT_EQ(stats.peak, 2u);
+  EXPECT_EQ(stats.idle, 2u);
+
+  // the last released one is handed out first, zeroed out
+  auto c = factory.create(pfasst::encap::solution);
+  auto& c_vec = pfasst::encap::as_vector<double, double>(c);
+  EXPECT_EQ(c_vec.size(), 8u);
+  EXPECT_EQ(c_vec.data(), data);
+  EXPECT_THAT(c_vec, Each(0.0));
+
+  // pools are kept per encapsulation type
+  auto f = factory.create(pfasst::encap::function);
+  stats = factory.get_statistics();
+  EXPECT_EQ(stats.live, 2u);
+  EXPECT_EQ(stats.idle, 1u);
+  EXPECT_EQ(stats.allocated, 3u);
+  EXPECT_EQ(stats.recycled, 1u);
+
+  // families are not pooled
+  auto nodes = factory.create_block(pfasst::encap::solution, 3);
+  EXPECT_EQ(nodes.size(), 3u);
+  EXPECT_EQ(factory.get_statistics().live, 2u);
+
+  f.reset();
+  factory.release_idle();
+  EXPECT_EQ(factory.get_statistics().idle, 0u);
+}
+
+TEST(PooledFactoryTest, LeasesMayOutliveTheFactory)
+{
+  shared_ptr<Encapsulation<double>> lease;
+  {
+    PooledEncapFactory<double> factory(make_shared<VectorFactory<double, double>>(4));
+    lease = factory.create(pfasst::encap::solution);
+  }
+  pfasst::encap::as_vector<double, double>(lease).assign(4, 1.0);
+  EXPECT_EQ(lease->norm0(), 1.0);
+  lease.reset();
+}
+
+TEST(PooledFactoryTest, ConcurrentLeases)
+{
+  PooledEncapFactory<double> factory(make_shared<VectorFactory<double, double>>(16));
+  const int nleases = 1000;
+  int nonzero = 0;
+
+#ifdef WITH_OPENMP
+  #pragma omp parallel for reduction(+:nonzero)
+#endif
+  for (int i = 0; i < nleases; i++) {
+    auto a = factory.create(pfasst::encap::solution);
+    auto b = factory.create(pfasst::encap::function);
+    if (a->norm0() != 0.0 || b->norm0() != 0.0) {
+      nonzero++;
+    }
+    pfasst::encap::as_vector<double, double>(a).assign(16, double(i + 1));
+    pfasst::encap::as_vector<double, double>(b).assign(16, double(i + 1));
+  }
+
+  auto stats = factory.get_statistics();
+  EXPECT_EQ(nonzero, 0);
+  EXPECT_EQ(stats.live, 0u);
+  EXPECT_EQ(stats.allocated + stats.recycled, size_t(2 * nleases));
+  EXPECT_EQ(stats.idle, stats.allocated);
+  EXPECT_LE(stats.peak, stats.allocated);
+}
+
+
+TEST(EigenVectorTest, MatchesVectorEncapsulation)
+{
+  const size_t ndofs = 37, nsrc = 5, ndst = 3;
+  VectorFactory<double, double> vfactory(ndofs);
+  EigenFactory<double, double> efactory(ndofs);
+
+  vector<shared_ptr<Encapsulation<double>>> vsrc, esrc, vdst, edst;
+  for (size_t m = 0; m < nsrc; m++) {
+    vsrc.push_back(vfactory.create(pfasst::encap::solution));
+    esrc.push_back(efactory.create(pfasst::encap::solution));
+    auto& v = pfasst::encap::as_vector<double, double>(vsrc.back());
+    auto& e = pfasst::encap::as_eigen_vector<double, double>(esrc.back());
+    for (size_t i = 0; i < ndofs; i++) {
+      v[i] = e[i] = 1.0 + 0.25 * m - 0.125 * (i % 13);
+    }
+  }
+  for (size_t n = 0; n < ndst; n++) {
+    vdst.push_back(vfactory.create(pfasst::encap::solution));
+    edst.push_back(efactory.create(pfasst::encap::solution));
+  }
+
+  Matrix<double> mat(ndst, nsrc);
+  for (size_t n = 0; n < ndst; n++) {
+    for (size_t m = 0; m < nsrc; m++) {
+      mat(n, m) = (n + m) % 3 == 0 ? 0.0 : 0.1 * (n + 1) - 0.05 * m;
+    }
+  }
+
+  for (bool zero : {true, false}) {
+    vdst[0]->mat_apply(vdst, 0.5, mat, vsrc, zero);
+    edst[0]->mat_apply(edst, 0.5, mat, esrc, zero);
+    vdst[1]->saxpy(-0.3, vsrc[4]);
+    edst[1]->saxpy(-0.3, esrc[4]);
+
+    for (size_t n = 0; n < ndst; n++) {
+      auto& v = pfasst::encap::as_vector<double, double>(vdst[n]);
+      auto& e = pfasst::encap::as_eigen_vector<double, double>(edst[n]);
+      for (size_t i = 0; i < ndofs; i++) {
+        EXPECT_NEAR(v[i], e[i], 1e-14) << "zero=" << zero << " n=" << n << " i=" << i;
+      }
+      for (auto type : { pfasst::encap::max_norm, pfasst::encap::l1_norm,
+                         pfasst::encap::l2_norm, pfasst::encap::rms_norm }) {
+        EXPECT_NEAR(vdst[n]->norm(type), edst[n]->norm(type), 1e-12) << "type=" << type;
+      }
+      EXPECT_NEAR(vdst[n]->dot(vsrc[n]), edst[n]->dot(esrc[n]), 1e-12);
+    }
+  }
+}
+
+TEST(EigenVectorTest, EigenExpressionsAndBufferSwap)
+{
+  typedef EigenVectorEncapsulation<double, double> EigenT;
+  auto x = make_shared<EigenT>(4);
+  auto y = make_shared<EigenT>(4);
+  x->setConstant(2.0);
+  *y = 3.0 * *x;
+  EXPECT_EQ(y->norm0(), 6.0);
+  EXPECT_EQ(y->norm(pfasst::encap::l1_norm), 24.0);
+  EXPECT_EQ(y->norm(), 12.0);
+
+  const double* x_buffer = x->data();
+  x->swap(static_pointer_cast<Encapsulation<double>>(y));
+  EXPECT_EQ(x_buffer, y->data());
+  EXPECT_EQ(x->norm0(), 6.0);
+
+  EigenVectorEncapsulation<complex<double>, double> z(3);
+  z.setConstant(complex<double>(3.0, 4.0));
+  z.saxpy(1.0, make_shared<const EigenVectorEncapsulation<complex<double>, double>>(z));
+  EXPECT_EQ(z.norm0(), 10.0);
+
+  (*x)(1) = numeric_limits<double>::quiet_NaN();
+  EXPECT_TRUE(std::isnan(x->norm0()));
+}
+
+int main(int argc, char** argv)
+{
+  InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}